@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationtracker.cpp
+// ============
+// count every heap allocation made through operator new, so the frames
+// can be checked for allocations they should not make
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// declaration of global variables
+namespace
+{
+    // plain atomics that need no construction, so allocations made
+    // before main() are counted too
+    std::atomic<uint64_t> g_AllocationCount(0);
+    std::atomic<uint64_t> g_AllocatedBytes(0);
+
+    // totals when the current frame started
+    uint64_t g_FrameStartCount = 0;
+    uint64_t g_FrameStartBytes = 0;
+}
+
+/***********************************************************
+ *  Record()
+ *
+ *  This method is used for counting one allocation.
+ ***********************************************************/
+void AllocationTracker::Record(size_t bytes)
+{
+    g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_AllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/***********************************************************
+ *  GetAllocationCount()
+ *
+ *  This method returns the allocations made so far.
+ ***********************************************************/
+uint64_t AllocationTracker::GetAllocationCount()
+{
+    return g_AllocationCount.load(std::memory_order_relaxed);
+}
+
+/***********************************************************
+ *  GetAllocatedBytes()
+ *
+ *  This method returns the bytes requested so far.
+ ***********************************************************/
+uint64_t AllocationTracker::GetAllocatedBytes()
+{
+    return g_AllocatedBytes.load(std::memory_order_relaxed);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for marking the start of a frame.
+ ***********************************************************/
+void AllocationTracker::BeginFrame()
+{
+    g_FrameStartCount = GetAllocationCount();
+    g_FrameStartBytes = GetAllocatedBytes();
+}
+
+/***********************************************************
+ *  GetFrameAllocations()
+ *
+ *  This method returns the allocations made since the frame
+ *  started.
+ ***********************************************************/
+uint64_t AllocationTracker::GetFrameAllocations()
+{
+    return GetAllocationCount() - g_FrameStartCount;
+}
+
+/***********************************************************
+ *  GetFrameBytes()
+ *
+ *  This method returns the bytes requested since the frame
+ *  started.
+ ***********************************************************/
+uint64_t AllocationTracker::GetFrameBytes()
+{
+    return GetAllocatedBytes() - g_FrameStartBytes;
+}
+
+// the global allocation functions, replaced so every new and
+// container allocation of the program passes the tracker
+void* operator new(std::size_t size)
+{
+    AllocationTracker::Record(size);
+    void* memory = malloc(size > 0 ? size : 1);
+    if (memory == NULL)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    AllocationTracker::Record(size);
+    return malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    free(memory);
+}
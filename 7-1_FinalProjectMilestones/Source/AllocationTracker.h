@@ -0,0 +1,30 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationtracker.h
+// ============
+// count every heap allocation made through operator new, so the frames
+// can be checked for allocations they should not make
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class AllocationTracker
+{
+public:
+    // allocations and bytes requested on any thread since the start
+    static uint64_t GetAllocationCount();
+    static uint64_t GetAllocatedBytes();
+
+    // start counting a frame, and read what it allocated so far
+    static void BeginFrame();
+    static uint64_t GetFrameAllocations();
+    static uint64_t GetFrameBytes();
+
+    // called by the replaced operator new
+    static void Record(size_t bytes);
+};
@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////////////////////////////////
+// animationsystem.cpp
+// ============
+// update the transforms of every animated instance once per frame
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "AnimationSystem.h"
+
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+    // below this many instances the hand-off to the worker thread
+    // costs more than the work it saves
+    const int g_WorkerThreshold = 4096;
+}
+
+/***********************************************************
+ *  AnimationSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+AnimationSystem::AnimationSystem()
+    : m_workerBegin(0), m_workerEnd(0), m_workerTime(0.0f), m_workerHasJob(false), m_workerQuit(false)
+{
+}
+
+/***********************************************************
+ *  ~AnimationSystem()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+AnimationSystem::~AnimationSystem()
+{
+    if (m_worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_workerMutex);
+            m_workerQuit = true;
+        }
+        m_workerWake.notify_one();
+        m_worker.join();
+    }
+}
+
+/***********************************************************
+ *  AddSpinningInstance()
+ *
+ *  This method is used for registering an instance that
+ *  spins around its Y axis.
+ ***********************************************************/
+int AnimationSystem::AddSpinningInstance(glm::vec3 scaleXYZ, glm::vec3 positionXYZ, float spinRate)
+{
+    m_positionX.push_back(positionXYZ.x);
+    m_positionY.push_back(positionXYZ.y);
+    m_positionZ.push_back(positionXYZ.z);
+    m_scaleX.push_back(scaleXYZ.x);
+    m_scaleY.push_back(scaleXYZ.y);
+    m_scaleZ.push_back(scaleXYZ.z);
+    m_spinRate.push_back(spinRate);
+    m_instanceMatrices.push_back(glm::mat4(1.0f));
+
+    return static_cast<int>(m_instanceMatrices.size()) - 1;
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every instance, so a new
+ *  scene can be built.  The worker only runs inside Update(),
+ *  so it holds no index into the arrays here.
+ ***********************************************************/
+void AnimationSystem::Clear()
+{
+    m_positionX.clear();
+    m_positionY.clear();
+    m_positionZ.clear();
+    m_scaleX.clear();
+    m_scaleY.clear();
+    m_scaleZ.clear();
+    m_spinRate.clear();
+    m_instanceMatrices.clear();
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for evaluating every instance for one
+ *  animation time, so all parts of the scene agree on it.
+ *  Large instance counts are split with the worker thread.
+ ***********************************************************/
+void AnimationSystem::Update(float animationTime)
+{
+    int count = GetInstanceCount();
+    if (count < g_WorkerThreshold)
+    {
+        UpdateBatch(0, count, animationTime);
+        return;
+    }
+
+    if (!m_worker.joinable())
+    {
+        m_worker = std::thread(&AnimationSystem::WorkerLoop, this);
+    }
+
+    int split = count / 2;
+    {
+        std::lock_guard<std::mutex> lock(m_workerMutex);
+        m_workerBegin = split;
+        m_workerEnd = count;
+        m_workerTime = animationTime;
+        m_workerHasJob = true;
+    }
+    m_workerWake.notify_one();
+
+    UpdateBatch(0, split, animationTime);
+
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    m_workerDone.wait(lock, [this] { return !m_workerHasJob; });
+}
+
+/***********************************************************
+ *  UpdateBatch()
+ *
+ *  This method is used for building the world matrices of a
+ *  range of instances.  Every matrix is translate * rotateY *
+ *  scale written out column by column, so the loop has no
+ *  matrix multiplies and vectorizes over the instance arrays.
+ ***********************************************************/
+void AnimationSystem::UpdateBatch(int begin, int end, float animationTime)
+{
+    const float* positionX = m_positionX.data();
+    const float* positionY = m_positionY.data();
+    const float* positionZ = m_positionZ.data();
+    const float* scaleX = m_scaleX.data();
+    const float* scaleY = m_scaleY.data();
+    const float* scaleZ = m_scaleZ.data();
+    const float* spinRate = m_spinRate.data();
+    glm::mat4* matrices = m_instanceMatrices.data();
+
+    for (int i = begin; i < end; i++)
+    {
+        float angle = spinRate[i] * animationTime;
+        float c = cos(angle);
+        float s = sin(angle);
+
+        glm::mat4& m = matrices[i];
+        m[0] = glm::vec4(c * scaleX[i], 0.0f, -s * scaleX[i], 0.0f);
+        m[1] = glm::vec4(0.0f, scaleY[i], 0.0f, 0.0f);
+        m[2] = glm::vec4(s * scaleZ[i], 0.0f, c * scaleZ[i], 0.0f);
+        m[3] = glm::vec4(positionX[i], positionY[i], positionZ[i], 1.0f);
+    }
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method runs on the worker thread and processes the
+ *  range handed over by Update() until the system is destroyed.
+ ***********************************************************/
+void AnimationSystem::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    while (true)
+    {
+        m_workerWake.wait(lock, [this] { return m_workerHasJob || m_workerQuit; });
+        if (m_workerQuit)
+            return;
+
+        int begin = m_workerBegin;
+        int end = m_workerEnd;
+        float animationTime = m_workerTime;
+
+        lock.unlock();
+        UpdateBatch(begin, end, animationTime);
+        lock.lock();
+
+        m_workerHasJob = false;
+        m_workerDone.notify_one();
+    }
+}
@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// animationsystem.h
+// ============
+// update the transforms of every animated instance once per frame
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class AnimationSystem
+{
+public:
+    // constructor
+    AnimationSystem();
+    // destructor
+    ~AnimationSystem();
+
+    // add an instance that spins around its Y axis at the given
+    // rate in radians per second, returns its instance index
+    int AddSpinningInstance(glm::vec3 scaleXYZ, glm::vec3 positionXYZ, float spinRate);
+
+    // evaluate every instance for the passed in animation time
+    void Update(float animationTime);
+    // remove every instance
+    void Clear();
+
+    // world matrix of an instance from the last update
+    const glm::mat4& GetInstanceMatrix(int index) const { return m_instanceMatrices[index]; }
+    // contiguous buffer of all instance matrices, ready for upload
+    const glm::mat4* GetInstanceBuffer() const { return m_instanceMatrices.data(); }
+    int GetInstanceCount() const { return static_cast<int>(m_instanceMatrices.size()); }
+
+private:
+    // build the world matrices for the instances in [begin, end)
+    void UpdateBatch(int begin, int end, float animationTime);
+    // worker thread loop that processes the second half of each update
+    void WorkerLoop();
+
+    // instance data kept as separate arrays so the batch kernel
+    // reads each value as a contiguous stream
+    std::vector<float> m_positionX;
+    std::vector<float> m_positionY;
+    std::vector<float> m_positionZ;
+    std::vector<float> m_scaleX;
+    std::vector<float> m_scaleY;
+    std::vector<float> m_scaleZ;
+    std::vector<float> m_spinRate;
+    std::vector<glm::mat4> m_instanceMatrices;
+
+    // worker thread state
+    std::thread m_worker;
+    std::mutex m_workerMutex;
+    std::condition_variable m_workerWake;
+    std::condition_variable m_workerDone;
+    int m_workerBegin;
+    int m_workerEnd;
+    float m_workerTime;
+    bool m_workerHasJob;
+    bool m_workerQuit;
+};
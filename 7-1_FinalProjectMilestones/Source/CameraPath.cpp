@@ -0,0 +1,278 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerapath.cpp
+// ============
+// record the camera of every simulation step together with the input
+// that moved it, and save or load the recording as a compact binary file
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+    // file layout, all values little endian:
+    //   "CPTH", uint32 version, float64 step, uint32 frame count,
+    //   uint32 event count, then per frame 5 float32 (position, yaw,
+    //   pitch) and a uint16 event count, then per event a uint8 type,
+    //   a float32 time since the first event, 2 float32 values, an
+    //   int16 key and a uint8 action
+    const char g_PathMagic[4] = { 'C', 'P', 'T', 'H' };
+    const uint32_t g_PathVersion = 1;
+    // bytes one frame and one event take in the file
+    const uint64_t g_FrameSize = 5 * sizeof(float) + sizeof(uint16_t);
+    const uint64_t g_EventSize = sizeof(uint8_t) + 3 * sizeof(float) + sizeof(int16_t) + sizeof(uint8_t);
+
+    /***********************************************************
+     *  IsLittleEndian()
+     *
+     *  This method returns whether the host stores the lowest
+     *  byte of a value first.
+     ***********************************************************/
+    bool IsLittleEndian()
+    {
+        const uint16_t probe = 1;
+        unsigned char firstByte = 0;
+        memcpy(&firstByte, &probe, 1);
+        return firstByte == 1;
+    }
+
+    /***********************************************************
+     *  WriteValue()
+     *
+     *  This method is used for writing one value to the file,
+     *  lowest byte first whatever the host byte order is.
+     ***********************************************************/
+    template <typename T>
+    void WriteValue(std::ofstream& file, T value)
+    {
+        char bytes[sizeof(T)];
+        memcpy(bytes, &value, sizeof(T));
+        if (!IsLittleEndian())
+            std::reverse(bytes, bytes + sizeof(T));
+        file.write(bytes, sizeof(T));
+    }
+
+    /***********************************************************
+     *  ReadValue()
+     *
+     *  This method is used for reading one value from the file
+     *  into the host byte order.
+     ***********************************************************/
+    template <typename T>
+    T ReadValue(std::ifstream& file)
+    {
+        char bytes[sizeof(T)] = {};
+        file.read(bytes, sizeof(T));
+        if (!IsLittleEndian())
+            std::reverse(bytes, bytes + sizeof(T));
+        T value = T();
+        memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+}
+
+/***********************************************************
+ *  CameraPath()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+CameraPath::CameraPath(double stepSeconds)
+    : m_step(stepSeconds), m_openEvent(0)
+{
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for starting an empty recording.
+ ***********************************************************/
+void CameraPath::Clear()
+{
+    m_frames.clear();
+    m_events.clear();
+    m_openEvent = 0;
+}
+
+/***********************************************************
+ *  AddEvent()
+ *
+ *  This method is used for adding an input event to the
+ *  step being recorded.
+ ***********************************************************/
+void CameraPath::AddEvent(const INPUT_EVENT& event)
+{
+    m_events.push_back(event);
+}
+
+/***********************************************************
+ *  AddFrame()
+ *
+ *  This method is used for closing the step being recorded.
+ *  The events added since the last frame belong to it.
+ ***********************************************************/
+void CameraPath::AddFrame(glm::vec3 position, float yaw, float pitch)
+{
+    CAMERA_PATH_FRAME frame;
+    frame.position = position;
+    frame.yaw = yaw;
+    frame.pitch = pitch;
+    frame.firstEvent = m_openEvent;
+    frame.eventCount = static_cast<uint32_t>(m_events.size()) - m_openEvent;
+    m_frames.push_back(frame);
+    m_openEvent = static_cast<uint32_t>(m_events.size());
+}
+
+/***********************************************************
+ *  GetEvents()
+ *
+ *  This method returns the input events applied in a step,
+ *  GetFrame(frame).eventCount of them.
+ ***********************************************************/
+const INPUT_EVENT* CameraPath::GetEvents(int frame) const
+{
+    if (m_frames[frame].eventCount == 0)
+        return NULL;
+    return &m_events[m_frames[frame].firstEvent];
+}
+
+/***********************************************************
+ *  Save()
+ *
+ *  This method is used for writing the closed frames and
+ *  their events.  Event times are kept relative to the first
+ *  event, which fits them into single precision.
+ ***********************************************************/
+bool CameraPath::Save(const char* filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Could not write camera path " << filename << std::endl;
+        return false;
+    }
+
+    uint32_t eventCount = m_frames.empty() ? 0 : m_frames.back().firstEvent + m_frames.back().eventCount;
+    double startTime = (eventCount > 0) ? m_events[0].time : 0.0;
+
+    file.write(g_PathMagic, sizeof(g_PathMagic));
+    WriteValue<uint32_t>(file, g_PathVersion);
+    WriteValue<double>(file, m_step);
+    WriteValue<uint32_t>(file, static_cast<uint32_t>(m_frames.size()));
+    WriteValue<uint32_t>(file, eventCount);
+
+    for (const CAMERA_PATH_FRAME& frame : m_frames)
+    {
+        WriteValue<float>(file, frame.position.x);
+        WriteValue<float>(file, frame.position.y);
+        WriteValue<float>(file, frame.position.z);
+        WriteValue<float>(file, frame.yaw);
+        WriteValue<float>(file, frame.pitch);
+        WriteValue<uint16_t>(file, static_cast<uint16_t>(frame.eventCount));
+    }
+
+    for (uint32_t i = 0; i < eventCount; i++)
+    {
+        const INPUT_EVENT& event = m_events[i];
+        WriteValue<uint8_t>(file, static_cast<uint8_t>(event.type));
+        WriteValue<float>(file, static_cast<float>(event.time - startTime));
+        WriteValue<float>(file, static_cast<float>(event.x));
+        WriteValue<float>(file, static_cast<float>(event.y));
+        WriteValue<int16_t>(file, static_cast<int16_t>(event.key));
+        WriteValue<uint8_t>(file, static_cast<uint8_t>(event.action));
+    }
+
+    if (!file)
+    {
+        std::cout << "Could not write camera path " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Saved " << m_frames.size() << " camera path frames to " << filename << std::endl;
+    return true;
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method is used for reading a recording written by
+ *  Save().  The current recording is only replaced when the
+ *  whole file could be read.  The counts in the header are
+ *  checked against the size of the file before anything is
+ *  allocated for them.
+ ***********************************************************/
+bool CameraPath::Load(const char* filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Could not open camera path " << filename << std::endl;
+        return false;
+    }
+
+    char magic[4] = { 0, 0, 0, 0 };
+    file.read(magic, sizeof(magic));
+    uint32_t version = ReadValue<uint32_t>(file);
+    if (!file || memcmp(magic, g_PathMagic, sizeof(magic)) != 0 || version != g_PathVersion)
+    {
+        std::cout << filename << " is not a camera path" << std::endl;
+        return false;
+    }
+
+    double step = ReadValue<double>(file);
+    uint32_t frameCount = ReadValue<uint32_t>(file);
+    uint32_t eventCount = ReadValue<uint32_t>(file);
+
+    std::streamoff headerEnd = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff fileEnd = file.tellg();
+    file.seekg(headerEnd);
+    if (!file || headerEnd < 0 || fileEnd < headerEnd ||
+        frameCount * g_FrameSize + eventCount * g_EventSize > static_cast<uint64_t>(fileEnd - headerEnd))
+    {
+        std::cout << "Camera path " << filename << " is truncated" << std::endl;
+        return false;
+    }
+
+    std::vector<CAMERA_PATH_FRAME> frames(frameCount);
+    uint32_t firstEvent = 0;
+    for (CAMERA_PATH_FRAME& frame : frames)
+    {
+        frame.position.x = ReadValue<float>(file);
+        frame.position.y = ReadValue<float>(file);
+        frame.position.z = ReadValue<float>(file);
+        frame.yaw = ReadValue<float>(file);
+        frame.pitch = ReadValue<float>(file);
+        frame.firstEvent = firstEvent;
+        frame.eventCount = ReadValue<uint16_t>(file);
+        firstEvent += frame.eventCount;
+    }
+
+    std::vector<INPUT_EVENT> events(eventCount);
+    for (INPUT_EVENT& event : events)
+    {
+        event.type = static_cast<INPUT_EVENT_TYPE>(ReadValue<uint8_t>(file));
+        event.time = ReadValue<float>(file);
+        event.x = ReadValue<float>(file);
+        event.y = ReadValue<float>(file);
+        event.key = ReadValue<int16_t>(file);
+        event.action = ReadValue<uint8_t>(file);
+    }
+
+    if (!file || firstEvent != eventCount)
+    {
+        std::cout << "Camera path " << filename << " is truncated" << std::endl;
+        return false;
+    }
+
+    m_step = step;
+    m_frames.swap(frames);
+    m_events.swap(events);
+    m_openEvent = eventCount;
+    return true;
+}
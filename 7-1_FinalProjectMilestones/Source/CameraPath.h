@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerapath.h
+// ============
+// record the camera of every simulation step together with the input
+// that moved it, and save or load the recording as a compact binary file
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "InputEventQueue.h"
+
+// CAMERA_PATH_FRAME structure - the camera after one simulation step
+struct CAMERA_PATH_FRAME
+{
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+    uint32_t firstEvent; // input events applied in the step
+    uint32_t eventCount;
+
+    CAMERA_PATH_FRAME()
+        : position(0.0f), yaw(0.0f), pitch(0.0f), firstEvent(0), eventCount(0) {}
+};
+
+class CameraPath
+{
+public:
+    // constructor, the step is the simulation step in seconds
+    CameraPath(double stepSeconds);
+
+    // forget the recorded frames and events
+    void Clear();
+
+    // add an input event to the step being recorded
+    void AddEvent(const INPUT_EVENT& event);
+    // close the step being recorded with the camera it ended with
+    void AddFrame(glm::vec3 position, float yaw, float pitch);
+
+    // write the recording, returns false when the file could not be written
+    bool Save(const char* filename) const;
+    // replace the recording with the one in the file, returns false
+    // when it is missing or not a camera path
+    bool Load(const char* filename);
+
+    double GetStep() const { return m_step; }
+    int GetFrameCount() const { return static_cast<int>(m_frames.size()); }
+    const CAMERA_PATH_FRAME& GetFrame(int frame) const { return m_frames[frame]; }
+    const INPUT_EVENT* GetEvents(int frame) const;
+
+private:
+    double m_step;
+    std::vector<CAMERA_PATH_FRAME> m_frames;
+    std::vector<INPUT_EVENT> m_events;
+    // the first event not yet closed by a frame
+    uint32_t m_openEvent;
+};
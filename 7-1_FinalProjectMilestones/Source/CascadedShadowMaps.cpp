@@ -0,0 +1,360 @@
+///////////////////////////////////////////////////////////////////////////////
+// cascadedshadowmaps.cpp
+// ============
+// render cascaded shadow maps for a sun light, keeping the static casters
+// in a cached layer that is only redrawn when its cascade moves
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "CascadedShadowMaps.h"
+#include "GLStateCache.h"
+#include "RenderCounters.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+    // shadows end at this view depth even when the far plane is farther
+    const float g_MaxShadowDistance = 60.0f;
+    // blend of logarithmic and even cascade splits, 1 is fully logarithmic
+    const float g_SplitLogWeight = 0.75f;
+    // closest near plane used for the splits
+    const float g_MinNearPlane = 0.01f;
+    // distance toward the light past a cascade box that still casts into it
+    const float g_CasterDistance = 60.0f;
+    // a cascade box moves in steps of its size divided by this, so the
+    // static layer is only redrawn after the camera moved that far
+    const float g_SnapSteps = 16.0f;
+    // the cascade sizes are rounded up to this step so rotating the
+    // camera does not change them
+    const float g_RadiusStep = 0.5f;
+
+    const char* g_ShadowMapName = "shadowMap";
+    const char* g_ShadowMatricesName = "shadowMatrices";
+    const char* g_CascadeSplitsName = "cascadeSplits";
+    const char* g_CascadeTexelSizesName = "cascadeTexelSizes";
+    const char* g_ShadowLightIndexName = "shadowLightIndex";
+}
+
+/***********************************************************
+ *  CascadedShadowMaps()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+CascadedShadowMaps::CascadedShadowMaps()
+    : m_resolution(0), m_staticMap(0), m_shadowMap(0), m_framebuffer(0),
+    m_lightDirection(0.0f), m_lightView(1.0f), m_staticRenderCount(0)
+{
+    for (int cascade = 0; cascade < SHADOW_CASCADE_COUNT; cascade++)
+    {
+        m_cascadeProjections[cascade] = glm::mat4(1.0f);
+        m_shadowMatrices[cascade] = glm::mat4(1.0f);
+        m_cascadeCenters[cascade] = glm::vec3(0.0f);
+        m_cascadeHalfSizes[cascade] = 0.0f;
+        m_texelSizes[cascade] = 0.0f;
+        m_cascadeSplits[cascade] = 0.0f;
+        m_staticValid[cascade] = false;
+    }
+}
+
+/***********************************************************
+ *  ~CascadedShadowMaps()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+CascadedShadowMaps::~CascadedShadowMaps()
+{
+    GLuint textures[2] = { m_staticMap, m_shadowMap };
+    for (int i = 0; i < 2; i++)
+    {
+        if (textures[i] != 0)
+        {
+            GLStateCache::Get()->NotifyTextureDeleted(textures[i]);
+            glDeleteTextures(1, &textures[i]);
+        }
+    }
+    m_staticMap = 0;
+    m_shadowMap = 0;
+    if (m_framebuffer != 0)
+    {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+}
+
+/***********************************************************
+ *  CreateDepthArray()
+ *
+ *  This method is used for creating a depth texture with one
+ *  layer per cascade, set up for filtered depth comparisons.
+ *  Lookups outside the map compare as lit.
+ ***********************************************************/
+GLuint CascadedShadowMaps::CreateDepthArray(int resolution)
+{
+    const GLfloat borderColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    GLStateCache::Get()->BindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH_COMPONENT32F, resolution, resolution, SHADOW_CASCADE_COUNT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    return texture;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the cached static layers,
+ *  the shadow map the shaders read and the framebuffer both
+ *  are drawn through.  The size must be a multiple of 16.
+ ***********************************************************/
+bool CascadedShadowMaps::Create(int resolution)
+{
+    m_resolution = resolution;
+
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->ActiveTexture(GL_TEXTURE0 + SHADOW_TEXTURE_UNIT);
+    m_staticMap = CreateDepthArray(resolution);
+    m_shadowMap = CreateDepthArray(resolution);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_shadowMap, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+
+    bool complete = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete)
+    {
+        std::cout << "Shadow map framebuffer is incomplete, shadows are disabled" << std::endl;
+        return false;
+    }
+
+    std::cout << "Shadow maps use " << 2 * SHADOW_CASCADE_COUNT * resolution * resolution * 4 << " bytes of texture memory" << std::endl;
+    return true;
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for fitting the cascades to the camera.
+ *  The shadowed part of the view depth is split between the
+ *  cascades and each cascade covers a sphere around its part
+ *  of the frustum.  The sphere size does not change when the
+ *  camera turns, and the box around it only moves in whole
+ *  steps of texels, so the shadow edges do not shimmer and the
+ *  static layer stays valid until the camera has moved a step.
+ ***********************************************************/
+void CascadedShadowMaps::Update(const glm::mat4& view, const glm::mat4& projection, glm::vec3 lightDirection)
+{
+    lightDirection = glm::normalize(lightDirection);
+    if (lightDirection != m_lightDirection)
+    {
+        m_lightDirection = lightDirection;
+        glm::vec3 up = (fabs(lightDirection.y) > 0.99f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        m_lightView = glm::lookAt(glm::vec3(0.0f), lightDirection, up);
+        InvalidateStaticCache();
+    }
+
+    // a perspective matrix has no constant term in its last row
+    float nearPlane = 0.0f;
+    float farPlane = 0.0f;
+    if (projection[3][3] == 0.0f)
+    {
+        nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+        farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+    }
+    else
+    {
+        nearPlane = (projection[3][2] + 1.0f) / projection[2][2];
+        farPlane = (projection[3][2] - 1.0f) / projection[2][2];
+    }
+    nearPlane = std::max(nearPlane, g_MinNearPlane);
+    farPlane = std::min(std::max(farPlane, nearPlane * 2.0f), g_MaxShadowDistance);
+
+    // the four frustum edges in view space, from the near to the far plane
+    glm::mat4 inverseProjection = glm::inverse(projection);
+    glm::mat4 inverseView = glm::inverse(view);
+    glm::vec3 lineStarts[4];
+    glm::vec3 lineEnds[4];
+    for (int corner = 0; corner < 4; corner++)
+    {
+        float ndcX = (corner & 1) ? 1.0f : -1.0f;
+        float ndcY = (corner >> 1) ? 1.0f : -1.0f;
+        glm::vec4 nearPoint = inverseProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+        glm::vec4 farPoint = inverseProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+        lineStarts[corner] = glm::vec3(nearPoint) / nearPoint.w;
+        lineEnds[corner] = glm::vec3(farPoint) / farPoint.w;
+    }
+
+    float splitNear = nearPlane;
+    for (int cascade = 0; cascade < SHADOW_CASCADE_COUNT; cascade++)
+    {
+        float fraction = static_cast<float>(cascade + 1) / SHADOW_CASCADE_COUNT;
+        float logSplit = nearPlane * pow(farPlane / nearPlane, fraction);
+        float evenSplit = nearPlane + (farPlane - nearPlane) * fraction;
+        float splitFar = g_SplitLogWeight * logSplit + (1.0f - g_SplitLogWeight) * evenSplit;
+
+        // the eight corners of this part of the frustum in world space
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        float depths[2] = { splitNear, splitFar };
+        for (int d = 0; d < 2; d++)
+        {
+            for (int corner = 0; corner < 4; corner++)
+            {
+                float t = (depths[d] + lineStarts[corner].z) / (lineStarts[corner].z - lineEnds[corner].z);
+                glm::vec3 point = lineStarts[corner] + (lineEnds[corner] - lineStarts[corner]) * t;
+                corners[d * 4 + corner] = glm::vec3(inverseView * glm::vec4(point, 1.0f));
+                center += corners[d * 4 + corner];
+            }
+        }
+        center /= 8.0f;
+
+        float radius = 0.0f;
+        for (int corner = 0; corner < 8; corner++)
+        {
+            radius = std::max(radius, glm::length(corners[corner] - center));
+        }
+        radius = ceil(radius / g_RadiusStep) * g_RadiusStep;
+
+        // the box has room for the sphere after the center is snapped
+        // down by up to one step, and the step is a whole number of
+        // texels because the size is a multiple of the step count
+        float halfSize = radius * g_SnapSteps / (g_SnapSteps - 2.0f);
+        float snapStep = 2.0f * halfSize / g_SnapSteps;
+        glm::vec3 lightCenter = glm::vec3(m_lightView * glm::vec4(center, 1.0f));
+        lightCenter = glm::floor(lightCenter / snapStep) * snapStep;
+
+        if (lightCenter != m_cascadeCenters[cascade] || halfSize != m_cascadeHalfSizes[cascade])
+        {
+            m_cascadeCenters[cascade] = lightCenter;
+            m_cascadeHalfSizes[cascade] = halfSize;
+            m_staticValid[cascade] = false;
+        }
+
+        // the light looks down -Z, casters toward the light sit at larger Z
+        m_cascadeProjections[cascade] = glm::ortho(
+            lightCenter.x - halfSize, lightCenter.x + halfSize,
+            lightCenter.y - halfSize, lightCenter.y + halfSize,
+            -(lightCenter.z + halfSize + g_CasterDistance), -(lightCenter.z - halfSize));
+
+        // map clip space to texture coordinates and depth
+        glm::mat4 textureBias = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f)) * glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
+        m_shadowMatrices[cascade] = textureBias * m_cascadeProjections[cascade] * m_lightView;
+        m_texelSizes[cascade] = 2.0f * halfSize / m_resolution;
+        m_cascadeSplits[cascade] = splitFar;
+
+        splitNear = splitFar;
+    }
+}
+
+/***********************************************************
+ *  IsInsideCascade()
+ *
+ *  This method is used for checking whether a bounding sphere
+ *  can cast a shadow into a cascade.
+ ***********************************************************/
+bool CascadedShadowMaps::IsInsideCascade(int cascade, glm::vec3 center, float radius) const
+{
+    glm::vec3 lightPosition = glm::vec3(m_lightView * glm::vec4(center, 1.0f));
+    glm::vec3 offset = lightPosition - m_cascadeCenters[cascade];
+    float halfSize = m_cascadeHalfSizes[cascade];
+
+    return fabs(offset.x) <= halfSize + radius &&
+        fabs(offset.y) <= halfSize + radius &&
+        offset.z >= -(halfSize + radius) &&
+        offset.z <= halfSize + g_CasterDistance + radius;
+}
+
+/***********************************************************
+ *  BindLayer()
+ *
+ *  This method is used for drawing into one layer of a depth
+ *  array.  The caller restores the viewport afterwards.
+ ***********************************************************/
+void CascadedShadowMaps::BindLayer(GLuint texture, int cascade)
+{
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, cascade);
+    // the new layer has not been cleared, even if the last one was
+    stateCache->NotifyDraw();
+    glViewport(0, 0, m_resolution, m_resolution);
+}
+
+/***********************************************************
+ *  BeginStaticPass()
+ *
+ *  This method is used for clearing the static layer of a
+ *  cascade and binding it for the static casters.
+ ***********************************************************/
+void CascadedShadowMaps::BeginStaticPass(int cascade)
+{
+    BindLayer(m_staticMap, cascade);
+    GLStateCache::Get()->Clear(GL_DEPTH_BUFFER_BIT);
+}
+
+/***********************************************************
+ *  BeginDynamicPass()
+ *
+ *  This method is used for starting the shadow map of a
+ *  cascade from a copy of its static layer, so only the
+ *  moving casters have to be drawn on top of it.
+ ***********************************************************/
+void CascadedShadowMaps::BeginDynamicPass(int cascade)
+{
+    glCopyImageSubData(
+        m_staticMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, cascade,
+        m_shadowMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, cascade,
+        m_resolution, m_resolution, 1);
+    BindLayer(m_shadowMap, cascade);
+}
+
+/***********************************************************
+ *  InvalidateStaticCache()
+ *
+ *  This method is used for redrawing every static layer on
+ *  the next frame.
+ ***********************************************************/
+void CascadedShadowMaps::InvalidateStaticCache()
+{
+    for (int cascade = 0; cascade < SHADOW_CASCADE_COUNT; cascade++)
+    {
+        m_staticValid[cascade] = false;
+    }
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the shadow map and setting
+ *  the values the shader needs to pick a cascade and look up
+ *  a fragment in it.
+ ***********************************************************/
+void CascadedShadowMaps::Bind(GLuint programID, int lightIndex) const
+{
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->ActiveTexture(GL_TEXTURE0 + SHADOW_TEXTURE_UNIT);
+    stateCache->BindTexture(GL_TEXTURE_2D_ARRAY, m_shadowMap);
+
+    glUniform1i(glGetUniformLocation(programID, g_ShadowMapName), SHADOW_TEXTURE_UNIT);
+    glUniformMatrix4fv(glGetUniformLocation(programID, g_ShadowMatricesName), SHADOW_CASCADE_COUNT, GL_FALSE, &m_shadowMatrices[0][0][0]);
+    glUniform1fv(glGetUniformLocation(programID, g_CascadeSplitsName), SHADOW_CASCADE_COUNT, m_cascadeSplits);
+    glUniform1fv(glGetUniformLocation(programID, g_CascadeTexelSizesName), SHADOW_CASCADE_COUNT, m_texelSizes);
+    glUniform1i(glGetUniformLocation(programID, g_ShadowLightIndexName), lightIndex);
+    RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 5);
+}
@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// cascadedshadowmaps.h
+// ============
+// render cascaded shadow maps for a sun light, keeping the static casters
+// in a cached layer that is only redrawn when its cascade moves
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// number of cascades the view distance is split into
+const int SHADOW_CASCADE_COUNT = 3;
+
+// texture unit the shadow map is sampled from
+const GLint SHADOW_TEXTURE_UNIT = 15;
+
+class CascadedShadowMaps
+{
+public:
+    // constructor
+    CascadedShadowMaps();
+    // destructor
+    ~CascadedShadowMaps();
+
+    // create the shadow map arrays with the passed in size per cascade
+    bool Create(int resolution);
+
+    // fit the cascades to the camera frustum for a light shining
+    // along the passed in direction
+    void Update(const glm::mat4& view, const glm::mat4& projection, glm::vec3 lightDirection);
+
+    // light view and cascade projection used to draw the casters
+    const glm::mat4& GetLightView() const { return m_lightView; }
+    const glm::mat4& GetCascadeProjection(int cascade) const { return m_cascadeProjections[cascade]; }
+    // true when a bounding sphere lies inside the box of a cascade
+    bool IsInsideCascade(int cascade, glm::vec3 center, float radius) const;
+
+    // the static layer of a cascade has to be redrawn when its box
+    // moved or the cache was invalidated
+    bool NeedsStaticRender(int cascade) const { return !m_staticValid[cascade]; }
+    // bind and clear the static layer of a cascade for drawing
+    void BeginStaticPass(int cascade);
+    void EndStaticPass(int cascade) { m_staticValid[cascade] = true; m_staticRenderCount++; }
+    // start the shadow map of a cascade from its static layer and
+    // bind it for drawing the dynamic casters
+    void BeginDynamicPass(int cascade);
+
+    // forget the static layers, used after static casters change
+    void InvalidateStaticCache();
+
+    // bind the shadow map and set the cascade values into the passed
+    // in shader program, which must be the current program.  The
+    // light index is the entry of the shadowed light in the light
+    // buffer, -1 turns the shadows off
+    void Bind(GLuint programID, int lightIndex) const;
+
+    // static layer redraws since the maps were created
+    int GetStaticRenderCount() const { return m_staticRenderCount; }
+
+private:
+    static GLuint CreateDepthArray(int resolution);
+    void BindLayer(GLuint texture, int cascade);
+
+    int m_resolution;
+    GLuint m_staticMap;
+    GLuint m_shadowMap;
+    GLuint m_framebuffer;
+
+    glm::vec3 m_lightDirection;
+    glm::mat4 m_lightView;
+    glm::mat4 m_cascadeProjections[SHADOW_CASCADE_COUNT];
+    glm::mat4 m_shadowMatrices[SHADOW_CASCADE_COUNT];
+    // light space box center and half size of every cascade
+    glm::vec3 m_cascadeCenters[SHADOW_CASCADE_COUNT];
+    float m_cascadeHalfSizes[SHADOW_CASCADE_COUNT];
+    // world size of one shadow map texel in every cascade
+    float m_texelSizes[SHADOW_CASCADE_COUNT];
+    // far view depth of every cascade
+    float m_cascadeSplits[SHADOW_CASCADE_COUNT];
+    bool m_staticValid[SHADOW_CASCADE_COUNT];
+    int m_staticRenderCount;
+};
@@ -0,0 +1,430 @@
+///////////////////////////////////////////////////////////////////////////////
+// clusteredlighting.cpp
+// ============
+// split the view frustum into clusters and build the list of lights that
+// reach each one, so fragments only evaluate nearby lights
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "ClusteredLighting.h"
+#include "RenderCounters.h"
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+    // below this many lights the hand-off to the workers costs more
+    // than the culling work it saves
+    const size_t g_WorkerThreshold = 64;
+    // most worker threads used besides the calling thread
+    const unsigned int g_MaxWorkers = 7;
+    // closest near plane used for the depth slices
+    const float g_MinNearPlane = 0.01f;
+
+    const char* g_ClusterCountsName = "clusterCounts";
+    const char* g_ClusterDepthName = "clusterDepthParams";
+    const char* g_ViewportSizeName = "viewportSize";
+    const char* g_GlobalLightCountName = "globalLightCount";
+}
+
+/***********************************************************
+ *  ClusteredLighting()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ClusteredLighting::ClusteredLighting()
+    : m_lightBuffer(0), m_clusterBuffer(0), m_lightIndexBuffer(0),
+    m_lightBufferCapacity(0), m_clusterBufferCapacity(0), m_lightIndexBufferCapacity(0),
+    m_boundsProjection(1.0f), m_boundsValid(false), m_nearPlane(0.1f), m_farPlane(100.0f),
+    m_sliceScale(0.0f), m_sliceBias(0.0f), m_globalLightCount(0), m_visibleLightCount(0), m_lightIndexCount(0),
+    m_partCount(1), m_jobGeneration(0), m_workersBusy(0), m_workerQuit(false)
+{
+    m_clusterLights.resize(static_cast<size_t>(CLUSTER_COUNT) * MAX_LIGHTS_PER_CLUSTER);
+    m_clusterLightCounts.resize(CLUSTER_COUNT, 0);
+    m_clusterRanges.resize(CLUSTER_COUNT * 2, 0);
+}
+
+/***********************************************************
+ *  ~ClusteredLighting()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ClusteredLighting::~ClusteredLighting()
+{
+    if (!m_workers.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_workerMutex);
+            m_workerQuit = true;
+        }
+        m_workerWake.notify_all();
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    if (m_lightBuffer != 0)
+    {
+        glDeleteBuffers(1, &m_lightBuffer);
+        glDeleteBuffers(1, &m_clusterBuffer);
+        glDeleteBuffers(1, &m_lightIndexBuffer);
+    }
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the shader storage
+ *  buffers that hold the lights and the cluster lists.
+ ***********************************************************/
+void ClusteredLighting::Create()
+{
+    if (m_lightBuffer != 0)
+        return;
+
+    glGenBuffers(1, &m_lightBuffer);
+    glGenBuffers(1, &m_clusterBuffer);
+    glGenBuffers(1, &m_lightIndexBuffer);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for moving the lights into view space
+ *  and uploading the ones that can reach the view.  Lights
+ *  without a radius reach every cluster, so they are kept at
+ *  the front of the light buffer and evaluated by every
+ *  fragment instead.
+ ***********************************************************/
+void ClusteredLighting::Update(const std::vector<LIGHT_SOURCE>& lights, const glm::mat4& view, const glm::mat4& projection)
+{
+    if (!m_boundsValid || projection != m_boundsProjection)
+        BuildClusterBounds(projection);
+
+    // room for every light up front, so a view that sees more
+    // lights than any before does not grow the lists mid-frame
+    m_gpuLights.clear();
+    m_cullLights.clear();
+    m_gpuLights.reserve(lights.size());
+    m_cullLights.reserve(lights.size());
+    m_bufferIndices.assign(lights.size(), -1);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        bool globalPass = (pass == 0);
+        for (size_t i = 0; i < lights.size(); i++)
+        {
+            const LIGHT_SOURCE& light = lights[i];
+            if ((light.radius <= 0.0f) != globalPass)
+                continue;
+
+            CULL_LIGHT cullLight;
+            if (!globalPass)
+            {
+                // skip lights that are entirely in front of or behind the clusters
+                cullLight.center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+                cullLight.radius = light.radius;
+                float depth = -cullLight.center.z;
+                if (depth + light.radius < m_nearPlane || depth - light.radius > m_farPlane)
+                    continue;
+
+                cullLight.firstSlice = GetSlice(depth - light.radius);
+                cullLight.lastSlice = GetSlice(depth + light.radius);
+                cullLight.index = static_cast<GLuint>(m_gpuLights.size());
+                m_cullLights.push_back(cullLight);
+            }
+
+            GPU_LIGHT gpuLight;
+            gpuLight.positionRadius = glm::vec4(light.position, light.radius);
+            gpuLight.ambientFocalStrength = glm::vec4(light.ambientColor, light.focalStrength);
+            gpuLight.diffuseSpecularIntensity = glm::vec4(light.diffuseColor, light.specularIntensity);
+            gpuLight.specularColor = glm::vec4(light.specularColor, 0.0f);
+            m_bufferIndices[i] = static_cast<GLint>(m_gpuLights.size());
+            m_gpuLights.push_back(gpuLight);
+        }
+
+        if (globalPass)
+            m_globalLightCount = static_cast<int>(m_gpuLights.size());
+    }
+    m_visibleLightCount = static_cast<int>(m_gpuLights.size());
+    m_lightIndexCount = 0;
+
+    UploadBuffer(m_lightBuffer, m_lightBufferCapacity, m_gpuLights.data(), m_gpuLights.size() * sizeof(GPU_LIGHT));
+}
+
+/***********************************************************
+ *  BuildClusters()
+ *
+ *  This method is used for sorting the lights kept by the
+ *  last update into the clusters of its view and uploading
+ *  the cluster ranges and the light index list.  Frames whose
+ *  draws all carry their own light lists skip it.
+ ***********************************************************/
+void ClusteredLighting::BuildClusters()
+{
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    unsigned int workerCount = (hardwareThreads > 1) ? std::min(hardwareThreads - 1, g_MaxWorkers) : 0;
+    if (workerCount > 0 && m_cullLights.size() >= g_WorkerThreshold)
+    {
+        if (m_workers.empty())
+        {
+            m_partCount = static_cast<int>(workerCount) + 1;
+            for (unsigned int i = 0; i < workerCount; i++)
+            {
+                m_workers.push_back(std::thread(&ClusteredLighting::WorkerLoop, this, static_cast<int>(i), m_jobGeneration));
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_workerMutex);
+            m_jobGeneration++;
+            m_workersBusy = static_cast<int>(m_workers.size());
+        }
+        m_workerWake.notify_all();
+
+        // the calling thread takes the last share
+        int lastPart = m_partCount - 1;
+        CullSlices(CLUSTER_COUNT_Z * lastPart / m_partCount, CLUSTER_COUNT_Z);
+
+        std::unique_lock<std::mutex> lock(m_workerMutex);
+        m_workerDone.wait(lock, [this] { return m_workersBusy == 0; });
+    }
+    else
+    {
+        CullSlices(0, CLUSTER_COUNT_Z);
+    }
+
+    // compact the fixed size lists into one index list, which is
+    // uploaded right away and so only needs frame arena memory
+    size_t indexCount = 0;
+    for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+    {
+        indexCount += m_clusterLightCounts[cluster];
+    }
+    GLuint* lightIndices = FrameArena::Get()->AllocateArray<GLuint>(indexCount);
+
+    size_t indexOffset = 0;
+    for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+    {
+        GLuint count = m_clusterLightCounts[cluster];
+        m_clusterRanges[cluster * 2] = static_cast<GLuint>(indexOffset);
+        m_clusterRanges[cluster * 2 + 1] = count;
+
+        const GLuint* clusterLights = &m_clusterLights[static_cast<size_t>(cluster) * MAX_LIGHTS_PER_CLUSTER];
+        std::copy(clusterLights, clusterLights + count, lightIndices + indexOffset);
+        indexOffset += count;
+    }
+    m_lightIndexCount = static_cast<int>(indexCount);
+
+    UploadBuffer(m_clusterBuffer, m_clusterBufferCapacity, m_clusterRanges.data(), m_clusterRanges.size() * sizeof(GLuint));
+    UploadBuffer(m_lightIndexBuffer, m_lightIndexBufferCapacity, lightIndices, indexCount * sizeof(GLuint));
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the light and cluster
+ *  buffers and setting the values the shader needs to find
+ *  the cluster of a fragment.
+ ***********************************************************/
+void ClusteredLighting::Bind(GLuint programID, float viewportWidth, float viewportHeight) const
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BUFFER_BINDING, m_lightBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_BUFFER_BINDING, m_clusterBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_INDEX_BUFFER_BINDING, m_lightIndexBuffer);
+
+    glUniform3i(glGetUniformLocation(programID, g_ClusterCountsName), CLUSTER_COUNT_X, CLUSTER_COUNT_Y, CLUSTER_COUNT_Z);
+    glUniform2f(glGetUniformLocation(programID, g_ClusterDepthName), m_sliceScale, m_sliceBias);
+    glUniform2f(glGetUniformLocation(programID, g_ViewportSizeName), viewportWidth, viewportHeight);
+    glUniform1i(glGetUniformLocation(programID, g_GlobalLightCountName), m_globalLightCount);
+    RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 4);
+}
+
+/***********************************************************
+ *  BuildClusterBounds()
+ *
+ *  This method is used for finding the view space box around
+ *  every cluster.  The tiles are even steps across the screen
+ *  and the depth slices grow exponentially from the near to
+ *  the far plane, so clusters stay roughly cube shaped.  The
+ *  tile corners are unprojected, so this works for both the
+ *  perspective and the orthographic projection.
+ ***********************************************************/
+void ClusteredLighting::BuildClusterBounds(const glm::mat4& projection)
+{
+    m_boundsProjection = projection;
+    m_boundsValid = true;
+
+    // a perspective matrix has no constant term in its last row
+    float nearPlane = 0.0f;
+    float farPlane = 0.0f;
+    if (projection[3][3] == 0.0f)
+    {
+        nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+        farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+    }
+    else
+    {
+        nearPlane = (projection[3][2] + 1.0f) / projection[2][2];
+        farPlane = (projection[3][2] - 1.0f) / projection[2][2];
+    }
+    m_nearPlane = std::max(nearPlane, g_MinNearPlane);
+    m_farPlane = std::max(farPlane, m_nearPlane * 2.0f);
+
+    // slice = log(depth) * scale + bias
+    float logRatio = log(m_farPlane / m_nearPlane);
+    m_sliceScale = CLUSTER_COUNT_Z / logRatio;
+    m_sliceBias = -CLUSTER_COUNT_Z * log(m_nearPlane) / logRatio;
+
+    glm::mat4 inverseProjection = glm::inverse(projection);
+
+    for (int z = 0; z < CLUSTER_COUNT_Z; z++)
+    {
+        float sliceNear = m_nearPlane * pow(m_farPlane / m_nearPlane, static_cast<float>(z) / CLUSTER_COUNT_Z);
+        float sliceFar = m_nearPlane * pow(m_farPlane / m_nearPlane, static_cast<float>(z + 1) / CLUSTER_COUNT_Z);
+
+        for (int y = 0; y < CLUSTER_COUNT_Y; y++)
+        {
+            for (int x = 0; x < CLUSTER_COUNT_X; x++)
+            {
+                glm::vec3 boundsMin(1.0e30f);
+                glm::vec3 boundsMax(-1.0e30f);
+
+                for (int corner = 0; corner < 4; corner++)
+                {
+                    float ndcX = -1.0f + 2.0f * static_cast<float>(x + (corner & 1)) / CLUSTER_COUNT_X;
+                    float ndcY = -1.0f + 2.0f * static_cast<float>(y + (corner >> 1)) / CLUSTER_COUNT_Y;
+
+                    // the line through this corner from the near to the far plane
+                    glm::vec4 nearPoint = inverseProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+                    glm::vec4 farPoint = inverseProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+                    glm::vec3 lineStart = glm::vec3(nearPoint) / nearPoint.w;
+                    glm::vec3 lineEnd = glm::vec3(farPoint) / farPoint.w;
+
+                    float depths[2] = { sliceNear, sliceFar };
+                    for (int d = 0; d < 2; d++)
+                    {
+                        float t = (depths[d] + lineStart.z) / (lineStart.z - lineEnd.z);
+                        glm::vec3 point = lineStart + (lineEnd - lineStart) * t;
+                        boundsMin = glm::min(boundsMin, point);
+                        boundsMax = glm::max(boundsMax, point);
+                    }
+                }
+
+                int cluster = (z * CLUSTER_COUNT_Y + y) * CLUSTER_COUNT_X + x;
+                m_clusterMin[cluster] = boundsMin;
+                m_clusterMax[cluster] = boundsMax;
+            }
+        }
+    }
+}
+
+/***********************************************************
+ *  GetSlice()
+ *
+ *  This method returns the depth slice that holds a positive
+ *  view space depth, clamped to the slices that exist.
+ ***********************************************************/
+int ClusteredLighting::GetSlice(float depth) const
+{
+    if (depth <= m_nearPlane)
+        return 0;
+
+    int slice = static_cast<int>(log(depth) * m_sliceScale + m_sliceBias);
+    return std::min(std::max(slice, 0), CLUSTER_COUNT_Z - 1);
+}
+
+/***********************************************************
+ *  CullSlices()
+ *
+ *  This method is used for filling the light lists of every
+ *  cluster in a range of depth slices.  Each caller owns its
+ *  slices, so the workers never write the same lists.
+ ***********************************************************/
+void ClusteredLighting::CullSlices(int begin, int end)
+{
+    int firstCluster = begin * CLUSTER_COUNT_X * CLUSTER_COUNT_Y;
+    int lastCluster = end * CLUSTER_COUNT_X * CLUSTER_COUNT_Y;
+    for (int cluster = firstCluster; cluster < lastCluster; cluster++)
+    {
+        m_clusterLightCounts[cluster] = 0;
+    }
+
+    for (const auto& light : m_cullLights)
+    {
+        int firstSlice = std::max(light.firstSlice, begin);
+        int lastSlice = std::min(light.lastSlice, end - 1);
+        float radiusSquared = light.radius * light.radius;
+
+        for (int z = firstSlice; z <= lastSlice; z++)
+        {
+            for (int cluster = z * CLUSTER_COUNT_X * CLUSTER_COUNT_Y; cluster < (z + 1) * CLUSTER_COUNT_X * CLUSTER_COUNT_Y; cluster++)
+            {
+                // distance from the sphere center to the closest point of the box
+                glm::vec3 closest = glm::clamp(light.center, m_clusterMin[cluster], m_clusterMax[cluster]);
+                glm::vec3 offset = closest - light.center;
+                if (glm::dot(offset, offset) > radiusSquared)
+                    continue;
+
+                GLuint& count = m_clusterLightCounts[cluster];
+                if (count < MAX_LIGHTS_PER_CLUSTER)
+                {
+                    m_clusterLights[static_cast<size_t>(cluster) * MAX_LIGHTS_PER_CLUSTER + count] = light.index;
+                    count++;
+                }
+            }
+        }
+    }
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method runs on a worker thread and culls the share of
+ *  the depth slices that belongs to the worker every time
+ *  Update() starts a new job.
+ ***********************************************************/
+void ClusteredLighting::WorkerLoop(int worker, unsigned int generation)
+{
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    while (true)
+    {
+        m_workerWake.wait(lock, [this, generation] { return m_workerQuit || m_jobGeneration != generation; });
+        if (m_workerQuit)
+            return;
+        generation = m_jobGeneration;
+
+        lock.unlock();
+        CullSlices(CLUSTER_COUNT_Z * worker / m_partCount, CLUSTER_COUNT_Z * (worker + 1) / m_partCount);
+        lock.lock();
+
+        m_workersBusy--;
+        if (m_workersBusy == 0)
+            m_workerDone.notify_one();
+    }
+}
+
+/***********************************************************
+ *  UploadBuffer()
+ *
+ *  This method is used for replacing the contents of a shader
+ *  storage buffer.  The storage is orphaned so the driver
+ *  does not wait for draws still reading the old contents,
+ *  and it never shrinks, so a binding is never empty.
+ ***********************************************************/
+void ClusteredLighting::UploadBuffer(GLuint buffer, GLsizeiptr& capacity, const void* data, GLsizeiptr size)
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    if (size > capacity || capacity == 0)
+        capacity = std::max<GLsizeiptr>(std::max<GLsizeiptr>(size, capacity * 2), 256);
+
+    glBufferData(GL_SHADER_STORAGE_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+    if (size > 0)
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+    RenderCounters::Get()->Add(COUNTER_BUFFER_BYTES, static_cast<uint64_t>(size));
+}
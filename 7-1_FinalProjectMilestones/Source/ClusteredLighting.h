@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////
+// clusteredlighting.h
+// ============
+// split the view frustum into clusters and build the list of lights that
+// reach each one, so fragments only evaluate nearby lights
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// LIGHT_SOURCE structure
+struct LIGHT_SOURCE
+{
+    glm::vec3 position;
+    glm::vec3 ambientColor;
+    glm::vec3 diffuseColor;
+    glm::vec3 specularColor;
+    float focalStrength;
+    float specularIntensity;
+    float radius; // distance the light reaches, 0 lights the whole scene
+
+    LIGHT_SOURCE()
+        : position(0.0f), ambientColor(0.0f), diffuseColor(0.0f), specularColor(0.0f), focalStrength(1.0f), specularIntensity(1.0f), radius(0.0f) {}
+};
+
+// cluster grid size - screen tiles across, down and depth slices
+const int CLUSTER_COUNT_X = 16;
+const int CLUSTER_COUNT_Y = 9;
+const int CLUSTER_COUNT_Z = 24;
+const int CLUSTER_COUNT = CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z;
+
+// lights beyond this many in one cluster are dropped from it
+const int MAX_LIGHTS_PER_CLUSTER = 256;
+
+// shader storage binding points, the per-draw data uses binding 0
+const GLuint LIGHT_BUFFER_BINDING = 1;
+const GLuint CLUSTER_BUFFER_BINDING = 2;
+const GLuint LIGHT_INDEX_BUFFER_BINDING = 3;
+
+class ClusteredLighting
+{
+public:
+    // constructor
+    ClusteredLighting();
+    // destructor
+    ~ClusteredLighting();
+
+    // create the shader storage buffers
+    void Create();
+
+    // rebuild and upload the light buffer for the passed in lights
+    // and camera, the cluster lists are left for BuildClusters()
+    void Update(const std::vector<LIGHT_SOURCE>& lights, const glm::mat4& view, const glm::mat4& projection);
+    // sort the lights of the last update into the clusters and upload
+    // the lists, only needed when a shader reads them this frame
+    void BuildClusters();
+
+    // bind the buffers and set the cluster lookup values into the
+    // passed in shader program, which must be the current program
+    void Bind(GLuint programID, float viewportWidth, float viewportHeight) const;
+
+    // lights kept by the last update - the global lights and the
+    // lights inside the depth range of the clusters
+    int GetVisibleLightCount() const { return m_visibleLightCount; }
+    // total cluster entries written since the last update, 0 when
+    // the lists were not built
+    int GetLightIndexCount() const { return m_lightIndexCount; }
+    // light buffer entry of a light passed to the last update, -1 when
+    // it was culled
+    GLint GetBufferIndex(int lightIndex) const { return m_bufferIndices[lightIndex]; }
+
+private:
+    // GPU_LIGHT structure - std430 light layout, must match the shaders
+    struct GPU_LIGHT
+    {
+        glm::vec4 positionRadius;
+        glm::vec4 ambientFocalStrength;
+        glm::vec4 diffuseSpecularIntensity;
+        glm::vec4 specularColor;
+    };
+
+    // a light in view space, ready for the cluster tests
+    struct CULL_LIGHT
+    {
+        glm::vec3 center;
+        float radius;
+        int firstSlice;
+        int lastSlice;
+        GLuint index; // entry in the light buffer
+    };
+
+    // rebuild the view space bounds of every cluster
+    void BuildClusterBounds(const glm::mat4& projection);
+    // find the lights of every cluster in the depth slices [begin, end)
+    void CullSlices(int begin, int end);
+    // depth slice that contains a view space depth
+    int GetSlice(float depth) const;
+    // worker thread loop that culls its share of the slices for
+    // every job started after the passed in generation
+    void WorkerLoop(int worker, unsigned int generation);
+    // replace the contents of a shader storage buffer, growing it when needed
+    static void UploadBuffer(GLuint buffer, GLsizeiptr& capacity, const void* data, GLsizeiptr size);
+
+    GLuint m_lightBuffer;
+    GLuint m_clusterBuffer;
+    GLuint m_lightIndexBuffer;
+    GLsizeiptr m_lightBufferCapacity;
+    GLsizeiptr m_clusterBufferCapacity;
+    GLsizeiptr m_lightIndexBufferCapacity;
+
+    // the cluster bounds only change with the projection
+    glm::mat4 m_boundsProjection;
+    bool m_boundsValid;
+    glm::vec3 m_clusterMin[CLUSTER_COUNT];
+    glm::vec3 m_clusterMax[CLUSTER_COUNT];
+    float m_nearPlane;
+    float m_farPlane;
+    float m_sliceScale;
+    float m_sliceBias;
+
+    // per-frame light data
+    int m_globalLightCount;
+    int m_visibleLightCount;
+    std::vector<GPU_LIGHT> m_gpuLights;
+    std::vector<GLint> m_bufferIndices; // light buffer entry of every passed in light
+    std::vector<CULL_LIGHT> m_cullLights;
+    // fixed size lists filled by the workers, compacted before upload
+    std::vector<GLuint> m_clusterLights;
+    std::vector<GLuint> m_clusterLightCounts;
+    std::vector<GLuint> m_clusterRanges; // offset and count for every cluster
+    int m_lightIndexCount; // entries of the index list, which only lives in the frame arena
+
+    // worker thread state
+    std::vector<std::thread> m_workers;
+    int m_partCount; // slice ranges per job, the workers plus the calling thread
+    std::mutex m_workerMutex;
+    std::condition_variable m_workerWake;
+    std::condition_variable m_workerDone;
+    unsigned int m_jobGeneration;
+    int m_workersBusy;
+    bool m_workerQuit;
+};
@@ -0,0 +1,272 @@
+///////////////////////////////////////////////////////////////////////////////
+// deferredrenderer.cpp
+// ============
+// render the scene into a G-buffer and light it in one screen space pass
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "DeferredRenderer.h"
+#include "GLStateCache.h"
+#include "RenderCounters.h"
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+    // the G-buffer textures sit on the last units, away from the
+    // scene textures that fill the units from 0 up
+    const GLint g_AlbedoUnit = 12;
+    const GLint g_NormalUnit = 13;
+    const GLint g_DepthUnit = 14;
+
+    // 12 bytes per pixel - RGBA8 albedo, RGB10_A2 normal and a 24 bit depth
+    const GLenum g_AlbedoFormat = GL_RGBA8;
+    const GLenum g_NormalFormat = GL_RGB10_A2;
+    const GLenum g_DepthFormat = GL_DEPTH_COMPONENT24;
+    const GLsizeiptr g_BytesPerPixel = 4 + 4 + 4;
+
+    /***********************************************************
+     *  CreateTarget()
+     *
+     *  This method is used for creating one G-buffer texture.
+     ***********************************************************/
+    GLuint CreateTarget(GLenum internalFormat, int width, int height)
+    {
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        GLStateCache::Get()->BindTexture(GL_TEXTURE_2D, texture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, width, height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return texture;
+    }
+}
+
+/***********************************************************
+ *  DeferredRenderer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+DeferredRenderer::DeferredRenderer()
+    : m_geometryShader(NULL), m_lightingShader(NULL), m_framebuffer(0),
+    m_albedoTexture(0), m_normalTexture(0), m_depthTexture(0), m_fullscreenVAO(0),
+    m_width(0), m_height(0), m_blendWasEnabled(false)
+{
+}
+
+/***********************************************************
+ *  ~DeferredRenderer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+DeferredRenderer::~DeferredRenderer()
+{
+    DestroyTextures();
+    if (m_framebuffer != 0)
+    {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_fullscreenVAO != 0)
+    {
+        glDeleteVertexArrays(1, &m_fullscreenVAO);
+        m_fullscreenVAO = 0;
+    }
+    delete m_geometryShader;
+    m_geometryShader = NULL;
+    delete m_lightingShader;
+    m_lightingShader = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for loading the shaders of both
+ *  passes.  The G-buffer pass reuses the forward vertex
+ *  shader, so both paths place the geometry identically.
+ ***********************************************************/
+bool DeferredRenderer::Create()
+{
+    m_geometryShader = new ShaderManager();
+    m_geometryShader->LoadShaders(
+        "shaders/vertexShader.glsl",
+        "shaders/gBufferFragmentShader.glsl");
+
+    m_lightingShader = new ShaderManager();
+    m_lightingShader->LoadShaders(
+        "shaders/deferredLightingVertexShader.glsl",
+        "shaders/deferredLightingFragmentShader.glsl");
+
+    if (m_geometryShader->m_programID == 0 || m_lightingShader->m_programID == 0)
+    {
+        std::cout << "Deferred shaders failed to load, the deferred path is disabled" << std::endl;
+        delete m_geometryShader;
+        m_geometryShader = NULL;
+        delete m_lightingShader;
+        m_lightingShader = NULL;
+        return false;
+    }
+
+    glGenFramebuffers(1, &m_framebuffer);
+    // core profile draws need a vertex array even without attributes
+    glGenVertexArrays(1, &m_fullscreenVAO);
+
+    // the G-buffer units never change
+    GLStateCache::Get()->UseProgram(m_lightingShader->m_programID);
+    m_lightingShader->setSampler2DValue("gBufferAlbedo", g_AlbedoUnit);
+    m_lightingShader->setSampler2DValue("gBufferNormal", g_NormalUnit);
+    m_lightingShader->setSampler2DValue("gBufferDepth", g_DepthUnit);
+
+    return true;
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for recreating the G-buffer textures
+ *  when the render size grows beyond them.  A smaller render
+ *  size uses their lower left corner, so a changing dynamic
+ *  resolution does not reallocate them every few frames.
+ ***********************************************************/
+void DeferredRenderer::Resize(int width, int height)
+{
+    if (width <= m_width && height <= m_height)
+        return;
+
+    width = std::max(width, m_width);
+    height = std::max(height, m_height);
+    DestroyTextures();
+    m_width = width;
+    m_height = height;
+
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->ActiveTexture(GL_TEXTURE0 + g_AlbedoUnit);
+
+    m_albedoTexture = CreateTarget(g_AlbedoFormat, width, height);
+    m_normalTexture = CreateTarget(g_NormalFormat, width, height);
+    m_depthTexture = CreateTarget(g_DepthFormat, width, height);
+
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_albedoTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_normalTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture, 0);
+
+    const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, drawBuffers);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "G-buffer framebuffer is incomplete at " << width << "x" << height << std::endl;
+    }
+}
+
+/***********************************************************
+ *  DestroyTextures()
+ *
+ *  This method is used for freeing the G-buffer textures.
+ ***********************************************************/
+void DeferredRenderer::DestroyTextures()
+{
+    GLuint textures[3] = { m_albedoTexture, m_normalTexture, m_depthTexture };
+    for (int i = 0; i < 3; i++)
+    {
+        if (textures[i] != 0)
+        {
+            GLStateCache::Get()->NotifyTextureDeleted(textures[i]);
+            glDeleteTextures(1, &textures[i]);
+        }
+    }
+    m_albedoTexture = 0;
+    m_normalTexture = 0;
+    m_depthTexture = 0;
+    m_width = 0;
+    m_height = 0;
+}
+
+/***********************************************************
+ *  BeginGeometryPass()
+ *
+ *  This method is used for preparing the G-buffer for the
+ *  scene draws.  Blending is turned off, since the values
+ *  written are not colors.
+ ***********************************************************/
+void DeferredRenderer::BeginGeometryPass(int width, int height)
+{
+    Resize(width, height);
+
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+
+    m_blendWasEnabled = stateCache->IsEnabled(GL_BLEND);
+    stateCache->Disable(GL_BLEND);
+    stateCache->Enable(GL_DEPTH_TEST);
+    stateCache->DepthMask(GL_TRUE);
+    stateCache->DepthFunc(GL_LESS);
+
+    stateCache->ClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    stateCache->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    stateCache->UseProgram(m_geometryShader->m_programID);
+}
+
+/***********************************************************
+ *  BeginLightingPass()
+ *
+ *  This method is used for switching from the G-buffer to the
+ *  target framebuffer and binding the G-buffer for reading.
+ ***********************************************************/
+void DeferredRenderer::BeginLightingPass(GLuint targetFramebuffer)
+{
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, targetFramebuffer);
+
+    // every pixel is written once, so the depth test has nothing to do
+    stateCache->Disable(GL_DEPTH_TEST);
+
+    stateCache->UseProgram(m_lightingShader->m_programID);
+    stateCache->ActiveTexture(GL_TEXTURE0 + g_AlbedoUnit);
+    stateCache->BindTexture(GL_TEXTURE_2D, m_albedoTexture);
+    stateCache->ActiveTexture(GL_TEXTURE0 + g_NormalUnit);
+    stateCache->BindTexture(GL_TEXTURE_2D, m_normalTexture);
+    stateCache->ActiveTexture(GL_TEXTURE0 + g_DepthUnit);
+    stateCache->BindTexture(GL_TEXTURE_2D, m_depthTexture);
+}
+
+/***********************************************************
+ *  EndLightingPass()
+ *
+ *  This method is used for lighting every pixel with one
+ *  screen covering triangle and putting back the state the
+ *  forward path expects.
+ ***********************************************************/
+void DeferredRenderer::EndLightingPass()
+{
+    GLStateCache* stateCache = GLStateCache::Get();
+
+    glBindVertexArray(m_fullscreenVAO);
+    stateCache->NotifyDraw();
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    RenderCounters::Get()->Add(COUNTER_DRAW_CALLS, 1);
+    RenderCounters::Get()->Add(COUNTER_TRIANGLES, 1);
+
+    stateCache->Enable(GL_DEPTH_TEST);
+    if (m_blendWasEnabled)
+        stateCache->Enable(GL_BLEND);
+}
+
+/***********************************************************
+ *  GetBufferBytes()
+ *
+ *  This method returns the memory used by the G-buffer at its
+ *  current size.
+ ***********************************************************/
+GLsizeiptr DeferredRenderer::GetBufferBytes() const
+{
+    return static_cast<GLsizeiptr>(m_width) * m_height * g_BytesPerPixel;
+}
@@ -0,0 +1,61 @@
+///////////////////////////////////////////////////////////////////////////////
+// deferredrenderer.h
+// ============
+// render the scene into a G-buffer and light it in one screen space pass
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include "ShaderManager.h"
+
+class DeferredRenderer
+{
+public:
+    // constructor
+    DeferredRenderer();
+    // destructor
+    ~DeferredRenderer();
+
+    // load the G-buffer and lighting shaders, returns false when
+    // either of them failed to load
+    bool Create();
+
+    // program that writes the G-buffer, draws use it like the
+    // forward shader
+    ShaderManager* GetGeometryShader() const { return m_geometryShader; }
+    // program of the lighting pass, its uniforms are set between
+    // BeginLightingPass() and EndLightingPass()
+    ShaderManager* GetLightingShader() const { return m_lightingShader; }
+
+    // bind and clear the G-buffer, growing it to the passed in size
+    void BeginGeometryPass(int width, int height);
+    // bind the target framebuffer, the lighting program and the
+    // G-buffer textures
+    void BeginLightingPass(GLuint targetFramebuffer);
+    // draw the screen covering triangle and restore the state
+    void EndLightingPass();
+
+    // bytes of GPU memory used by the G-buffer
+    GLsizeiptr GetBufferBytes() const;
+
+private:
+    // recreate the G-buffer textures for a larger size
+    void Resize(int width, int height);
+    void DestroyTextures();
+
+    ShaderManager* m_geometryShader;
+    ShaderManager* m_lightingShader;
+    GLuint m_framebuffer;
+    GLuint m_albedoTexture;
+    GLuint m_normalTexture;
+    GLuint m_depthTexture;
+    GLuint m_fullscreenVAO;
+    int m_width;
+    int m_height;
+    bool m_blendWasEnabled;
+};
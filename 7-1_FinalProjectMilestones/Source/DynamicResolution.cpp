@@ -0,0 +1,290 @@
+///////////////////////////////////////////////////////////////////////////////
+// dynamicresolution.cpp
+// ============
+// render the scene offscreen at a scale of the window size that follows
+// the GPU frame time, and stretch the result over the window
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "DynamicResolution.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+    // range the scale on each axis is kept in
+    const float g_MinScale = 0.5f;
+    const float g_MaxScale = 1.0f;
+    // controller gains, applied to the frame time error relative to
+    // the target, so they do not depend on the target itself
+    const float g_ProportionalGain = 0.10f;
+    const float g_IntegralGain = 0.04f;
+    const float g_DerivativeGain = 0.02f;
+    // errors smaller than this leave the scale alone, so noise in
+    // the timings does not keep changing the resolution
+    const float g_ErrorDeadband = 0.05f;
+    // render sizes are rounded to multiples of this many pixels
+    const int g_SizeStep = 8;
+    // 60 frames per second
+    const float g_DefaultTargetMilliseconds = 1000.0f / 60.0f;
+}
+
+/***********************************************************
+ *  DynamicResolution()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+DynamicResolution::DynamicResolution()
+    : m_framebuffer(0), m_colorTexture(0), m_depthRenderbuffer(0), m_targetWidth(0), m_targetHeight(0),
+    m_windowWidth(0), m_windowHeight(0), m_renderWidth(0), m_renderHeight(0),
+    m_nextQuery(0), m_activeQuery(-1), m_scale(g_MaxScale), m_fixedScale(false), m_targetMilliseconds(g_DefaultTargetMilliseconds),
+    m_lastMilliseconds(0.0f), m_previousError(0.0f), m_olderError(0.0f)
+{
+    for (int i = 0; i < QUERY_COUNT; i++)
+    {
+        m_queries[i] = 0;
+        m_pending[i] = false;
+    }
+}
+
+/***********************************************************
+ *  ~DynamicResolution()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+DynamicResolution::~DynamicResolution()
+{
+    DestroyTarget();
+    if (m_framebuffer != 0)
+    {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_queries[0] != 0)
+    {
+        glDeleteQueries(QUERY_COUNT, m_queries);
+    }
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the offscreen target at
+ *  the full window size and the frame timers.
+ ***********************************************************/
+bool DynamicResolution::Create(int windowWidth, int windowHeight)
+{
+    glGenFramebuffers(1, &m_framebuffer);
+    glGenQueries(QUERY_COUNT, m_queries);
+
+    m_windowWidth = windowWidth;
+    m_windowHeight = windowHeight;
+    CreateTarget(windowWidth, windowHeight);
+
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    bool complete = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete)
+    {
+        std::cout << "Dynamic resolution target is incomplete, rendering at the window size" << std::endl;
+        return false;
+    }
+
+    UpdateRenderSize();
+    return true;
+}
+
+/***********************************************************
+ *  CreateTarget()
+ *
+ *  This method is used for creating the color texture and
+ *  depth buffer of the offscreen target.
+ ***********************************************************/
+void DynamicResolution::CreateTarget(int width, int height)
+{
+    DestroyTarget();
+    m_targetWidth = width;
+    m_targetHeight = height;
+
+    GLStateCache* stateCache = GLStateCache::Get();
+    glGenTextures(1, &m_colorTexture);
+    stateCache->BindTexture(GL_TEXTURE_2D, m_colorTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glGenRenderbuffers(1, &m_depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+}
+
+/***********************************************************
+ *  DestroyTarget()
+ *
+ *  This method is used for freeing the offscreen target.
+ ***********************************************************/
+void DynamicResolution::DestroyTarget()
+{
+    if (m_colorTexture != 0)
+    {
+        GLStateCache::Get()->NotifyTextureDeleted(m_colorTexture);
+        glDeleteTextures(1, &m_colorTexture);
+        m_colorTexture = 0;
+    }
+    if (m_depthRenderbuffer != 0)
+    {
+        glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+        m_depthRenderbuffer = 0;
+    }
+    m_targetWidth = 0;
+    m_targetHeight = 0;
+}
+
+/***********************************************************
+ *  SetFixedScale()
+ *
+ *  This method is used for setting the scale and keeping it,
+ *  the frame timings are still measured.
+ ***********************************************************/
+void DynamicResolution::SetFixedScale(float scale)
+{
+    m_scale = std::min(std::max(scale, g_MinScale), g_MaxScale);
+    m_fixedScale = true;
+    m_previousError = 0.0f;
+    m_olderError = 0.0f;
+    UpdateRenderSize();
+}
+
+/***********************************************************
+ *  UpdateRenderSize()
+ *
+ *  This method is used for turning the scale into the render
+ *  size, rounded to whole steps so small scale changes do not
+ *  change the size every frame.
+ ***********************************************************/
+void DynamicResolution::UpdateRenderSize()
+{
+    int width = static_cast<int>(m_windowWidth * m_scale) / g_SizeStep * g_SizeStep;
+    int height = static_cast<int>(m_windowHeight * m_scale) / g_SizeStep * g_SizeStep;
+    m_renderWidth = std::min(std::max(width, g_SizeStep), m_windowWidth);
+    m_renderHeight = std::min(std::max(height, g_SizeStep), m_windowHeight);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for collecting the oldest finished
+ *  frame timing, adjusting the scale with it and starting
+ *  the frame in the lower left corner of the offscreen
+ *  target.  The target is only reallocated when the window
+ *  grows beyond it, scale changes just use less of it.
+ ***********************************************************/
+void DynamicResolution::BeginFrame(int windowWidth, int windowHeight)
+{
+    if (windowWidth != m_windowWidth || windowHeight != m_windowHeight)
+    {
+        m_windowWidth = windowWidth;
+        m_windowHeight = windowHeight;
+        if (windowWidth > m_targetWidth || windowHeight > m_targetHeight)
+            CreateTarget(std::max(windowWidth, m_targetWidth), std::max(windowHeight, m_targetHeight));
+        UpdateRenderSize();
+    }
+
+    m_activeQuery = -1;
+    int query = m_nextQuery;
+    if (m_pending[query])
+    {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(m_queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+        {
+            GLuint64 elapsedNanoseconds = 0;
+            glGetQueryObjectui64v(m_queries[query], GL_QUERY_RESULT, &elapsedNanoseconds);
+            m_pending[query] = false;
+            UpdateController(static_cast<float>(elapsedNanoseconds) / 1000000.0f);
+        }
+    }
+
+    GLStateCache::Get()->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_renderWidth, m_renderHeight);
+
+    if (!m_pending[query])
+    {
+        glBeginQuery(GL_TIME_ELAPSED, m_queries[query]);
+        m_activeQuery = query;
+    }
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for stretching the rendered corner of
+ *  the offscreen target over the whole window with linear
+ *  filtering.
+ ***********************************************************/
+void DynamicResolution::EndFrame(GLuint windowFramebuffer)
+{
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->BindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    stateCache->BindFramebuffer(GL_DRAW_FRAMEBUFFER, windowFramebuffer);
+    glBlitFramebuffer(0, 0, m_renderWidth, m_renderHeight,
+        0, 0, m_windowWidth, m_windowHeight,
+        GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, windowFramebuffer);
+    stateCache->NotifyDraw();
+    glViewport(0, 0, m_windowWidth, m_windowHeight);
+
+    if (m_activeQuery != -1)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_pending[m_activeQuery] = true;
+        m_nextQuery = (m_activeQuery + 1) % QUERY_COUNT;
+        m_activeQuery = -1;
+    }
+}
+
+/***********************************************************
+ *  UpdateController()
+ *
+ *  This method is used for moving the scale towards the
+ *  target frame time.  The controller works on the change of
+ *  the scale, the velocity form of a PID controller, so the
+ *  clamped scale never lets a summed error build up.  The
+ *  error is measured in pixel area, which the frame time
+ *  roughly follows, and turned back into a per axis scale.
+ ***********************************************************/
+void DynamicResolution::UpdateController(float frameMilliseconds)
+{
+    m_lastMilliseconds = frameMilliseconds;
+    if (m_fixedScale || frameMilliseconds <= 0.0f || m_targetMilliseconds <= 0.0f)
+        return;
+
+    // positive when there is time to spare
+    float error = (m_targetMilliseconds - frameMilliseconds) / m_targetMilliseconds;
+    if (error > -g_ErrorDeadband && error < g_ErrorDeadband)
+        error = 0.0f;
+
+    float areaChange = g_ProportionalGain * (error - m_previousError)
+        + g_IntegralGain * error
+        + g_DerivativeGain * (error - 2.0f * m_previousError + m_olderError);
+    m_olderError = m_previousError;
+    m_previousError = error;
+
+    float area = std::max(m_scale * m_scale + areaChange, 0.0f);
+    float scale = std::min(std::max(std::sqrt(area), g_MinScale), g_MaxScale);
+    if (scale != m_scale)
+    {
+        m_scale = scale;
+        UpdateRenderSize();
+    }
+}
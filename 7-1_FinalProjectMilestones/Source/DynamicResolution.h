@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+// dynamicresolution.h
+// ============
+// render the scene offscreen at a scale of the window size that follows
+// the GPU frame time, and stretch the result over the window
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+class DynamicResolution
+{
+public:
+    // constructor
+    DynamicResolution();
+    // destructor
+    ~DynamicResolution();
+
+    // create the offscreen target and the timer queries for the
+    // passed in window framebuffer size, returns false on failure
+    bool Create(int windowWidth, int windowHeight);
+
+    // GPU time per frame the resolution is adjusted to hold
+    void SetTargetFrameTime(float milliseconds) { m_targetMilliseconds = milliseconds; }
+    float GetTargetFrameTime() const { return m_targetMilliseconds; }
+
+    // bind the offscreen target with a viewport of the current render
+    // size and start timing the frame, the target grows with the window
+    void BeginFrame(int windowWidth, int windowHeight);
+    // stop timing, stretch the rendered image over the window
+    // framebuffer and leave it bound with a full window viewport
+    void EndFrame(GLuint windowFramebuffer);
+
+    // hold the scale at a fixed value instead of following the frame
+    // time, so runs that are compared render the same pixels
+    void SetFixedScale(float scale);
+
+    // fraction of the window size rendered on each axis
+    float GetScale() const { return m_scale; }
+    int GetRenderWidth() const { return m_renderWidth; }
+    int GetRenderHeight() const { return m_renderHeight; }
+    // GPU time of the latest measured frame
+    float GetLastFrameTime() const { return m_lastMilliseconds; }
+
+private:
+    // adjust the scale towards the target frame time
+    void UpdateController(float frameMilliseconds);
+    void UpdateRenderSize();
+    void CreateTarget(int width, int height);
+    void DestroyTarget();
+
+    static const int QUERY_COUNT = 4;
+
+    GLuint m_framebuffer;
+    GLuint m_colorTexture;
+    GLuint m_depthRenderbuffer;
+    int m_targetWidth; // allocated size of the offscreen target
+    int m_targetHeight;
+    int m_windowWidth;
+    int m_windowHeight;
+    int m_renderWidth;
+    int m_renderHeight;
+
+    // GPU timers, read a few frames after they were issued so the
+    // frame never waits on them
+    GLuint m_queries[QUERY_COUNT];
+    bool m_pending[QUERY_COUNT];
+    int m_nextQuery;
+    int m_activeQuery; // -1 when the current frame is not timed
+
+    float m_scale;
+    bool m_fixedScale; // the controller leaves the scale alone
+    float m_targetMilliseconds;
+    float m_lastMilliseconds;
+    // errors of the two previous measurements, for the controller
+    float m_previousError;
+    float m_olderError;
+};
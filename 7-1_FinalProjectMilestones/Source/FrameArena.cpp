@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.cpp
+// ============
+// hand out memory for data that only lives for one frame from one block,
+// which is reused from frame to frame instead of going to the heap
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "FrameArena.h"
+
+#include <cassert>
+#include <new>
+
+// declaration of global variables
+namespace
+{
+    // size of the block before any frame needed more
+    const size_t g_InitialCapacity = 1 << 20;
+}
+
+/***********************************************************
+ *  Get()
+ *
+ *  This method returns the arena shared by the renderer.
+ ***********************************************************/
+FrameArena* FrameArena::Get()
+{
+    static FrameArena arena;
+    return &arena;
+}
+
+/***********************************************************
+ *  FrameArena()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameArena::FrameArena()
+    : m_block(static_cast<unsigned char*>(::operator new(g_InitialCapacity))), m_capacity(g_InitialCapacity),
+    m_offset(0), m_overflowBytes(0)
+{
+}
+
+/***********************************************************
+ *  ~FrameArena()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameArena::~FrameArena()
+{
+    Reset();
+    ::operator delete(m_block);
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for releasing everything the frame
+ *  allocated.  When the frame overflowed the block, the
+ *  block is replaced with one that holds all of it with some
+ *  room to spare, so the overflow does not repeat.
+ ***********************************************************/
+void FrameArena::Reset()
+{
+    size_t usedBytes = GetUsedBytes();
+
+    for (void* block : m_overflowBlocks)
+    {
+        ::operator delete(block);
+    }
+    m_overflowBlocks.clear();
+    m_overflowBytes = 0;
+    m_offset = 0;
+
+    if (usedBytes > m_capacity)
+    {
+        ::operator delete(m_block);
+        m_capacity = usedBytes + usedBytes / 2;
+        m_block = static_cast<unsigned char*>(::operator new(m_capacity));
+    }
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  This method is used for taking the next aligned piece of
+ *  the block.  A piece that does not fit comes from the heap
+ *  for this frame only.
+ ***********************************************************/
+void* FrameArena::Allocate(size_t bytes, size_t alignment)
+{
+    assert(alignment <= alignof(std::max_align_t) && (alignment & (alignment - 1)) == 0);
+
+    size_t start = (m_offset + alignment - 1) & ~(alignment - 1);
+    if (start + bytes <= m_capacity)
+    {
+        m_offset = start + bytes;
+        return m_block + start;
+    }
+
+    void* block = ::operator new(bytes > 0 ? bytes : 1);
+    m_overflowBlocks.push_back(block);
+    m_overflowBytes += bytes + alignment;
+    return block;
+}
@@ -0,0 +1,50 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.h
+// ============
+// hand out memory for data that only lives for one frame from one block,
+// which is reused from frame to frame instead of going to the heap
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+class FrameArena
+{
+public:
+    // the arena of the thread that owns the OpenGL context
+    static FrameArena* Get();
+
+    // start the next frame, everything handed out before is released,
+    // and the block grows when the last frame did not fit in it
+    void Reset();
+
+    // memory that stays valid until the next Reset()
+    void* Allocate(size_t bytes, size_t alignment);
+    // an uninitialized array, only for types that need no destructor
+    template <typename T>
+    T* AllocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "frame arena memory is never destroyed");
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    size_t GetCapacity() const { return m_capacity; }
+    size_t GetUsedBytes() const { return m_offset + m_overflowBytes; }
+
+private:
+    FrameArena();
+    ~FrameArena();
+
+    unsigned char* m_block;
+    size_t m_capacity;
+    size_t m_offset;
+    // allocations that did not fit in the block this frame
+    std::vector<void*> m_overflowBlocks;
+    size_t m_overflowBytes;
+};
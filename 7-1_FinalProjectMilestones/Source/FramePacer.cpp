@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.cpp
+// ============
+// pace the presented frames with the swap interval or a frame rate cap,
+// and measure how evenly the frames are spaced
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "FramePacer.h"
+
+#include "GLFW/glfw3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+    // limits of the spin margin, a sleep that wakes up later than the
+    // largest margin makes a capped frame late
+    const std::chrono::microseconds g_MinSpinMargin(500);
+    const std::chrono::microseconds g_MaxSpinMargin(4000);
+}
+
+/***********************************************************
+ *  FramePacer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FramePacer::FramePacer()
+    : m_mode(FRAME_PACING_UNCAPPED), m_capInterval(Clock::duration::zero()), m_hasLastPresent(false),
+    m_spinMargin(std::chrono::duration_cast<Clock::duration>(g_MaxSpinMargin / 2)),
+    m_frameTimes(HISTORY_SIZE, 0.0f), m_nextFrameTime(0), m_frameTimeCount(0)
+{
+#ifdef _WIN32
+    // the default Windows timer wakes sleeps up to 15.6 ms late
+    timeBeginPeriod(1);
+#endif
+}
+
+/***********************************************************
+ *  ~FramePacer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+/***********************************************************
+ *  GetModeName()
+ *
+ *  This method returns the printed name of a pacing mode.
+ ***********************************************************/
+const char* FramePacer::GetModeName(FRAME_PACING_MODE mode)
+{
+    switch (mode)
+    {
+    case FRAME_PACING_VSYNC:
+        return "vsync";
+    case FRAME_PACING_ADAPTIVE_VSYNC:
+        return "adaptive";
+    case FRAME_PACING_CAPPED:
+        return "capped";
+    default:
+        return "uncapped";
+    }
+}
+
+/***********************************************************
+ *  SetMode()
+ *
+ *  This method is used for switching the pacing and setting
+ *  the matching swap interval.  Adaptive vsync is a negative
+ *  interval, which only the swap control tear extensions
+ *  accept.  The measured frames start over.
+ ***********************************************************/
+void FramePacer::SetMode(FRAME_PACING_MODE mode, double capFramesPerSecond)
+{
+    if (mode == FRAME_PACING_ADAPTIVE_VSYNC &&
+        !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+        !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+    {
+        std::cout << "Adaptive vsync is not supported, using vsync" << std::endl;
+        mode = FRAME_PACING_VSYNC;
+    }
+
+    m_mode = mode;
+    switch (mode)
+    {
+    case FRAME_PACING_VSYNC:
+        glfwSwapInterval(1);
+        break;
+    case FRAME_PACING_ADAPTIVE_VSYNC:
+        glfwSwapInterval(-1);
+        break;
+    default:
+        glfwSwapInterval(0);
+        break;
+    }
+
+    if (capFramesPerSecond <= 0.0)
+        capFramesPerSecond = 60.0;
+    m_capInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / capFramesPerSecond));
+    m_nextPresent = Clock::now() + m_capInterval;
+    m_hasLastPresent = false;
+    m_nextFrameTime = 0;
+    m_frameTimeCount = 0;
+}
+
+/***********************************************************
+ *  WaitForPresent()
+ *
+ *  This method is used for holding a capped frame until it
+ *  is due.  Most of the wait is slept, which frees the core,
+ *  and the last part is spun, since a sleep can wake up late.
+ *  A frame that is already late starts the schedule over
+ *  instead of rushing the next frames to catch up.
+ ***********************************************************/
+void FramePacer::WaitForPresent()
+{
+    if (m_mode != FRAME_PACING_CAPPED)
+        return;
+
+    Clock::time_point now = Clock::now();
+    if (now >= m_nextPresent)
+    {
+        m_nextPresent = now + m_capInterval;
+        return;
+    }
+
+    Clock::duration sleepTime = (m_nextPresent - now) - m_spinMargin;
+    if (sleepTime > Clock::duration::zero())
+    {
+        Clock::time_point wakeDue = now + sleepTime;
+        std::this_thread::sleep_for(sleepTime);
+
+        // keep the margin a little above how late the sleeps wake up
+        Clock::duration lateness = Clock::now() - wakeDue;
+        Clock::duration target = lateness + lateness / 2;
+        m_spinMargin = (m_spinMargin * 7 + target) / 8;
+        m_spinMargin = std::min(std::max(m_spinMargin, std::chrono::duration_cast<Clock::duration>(g_MinSpinMargin)),
+            std::chrono::duration_cast<Clock::duration>(g_MaxSpinMargin));
+    }
+
+    while (Clock::now() < m_nextPresent)
+    {
+        std::this_thread::yield();
+    }
+    m_nextPresent += m_capInterval;
+}
+
+/***********************************************************
+ *  FramePresented()
+ *
+ *  This method is used for recording the time between this
+ *  frame's swap and the last one.
+ ***********************************************************/
+void FramePacer::FramePresented()
+{
+    Clock::time_point now = Clock::now();
+    if (m_hasLastPresent)
+    {
+        m_frameTimes[m_nextFrameTime] = std::chrono::duration<float, std::milli>(now - m_lastPresent).count();
+        m_nextFrameTime = (m_nextFrameTime + 1) % HISTORY_SIZE;
+        m_frameTimeCount = std::min(m_frameTimeCount + 1, HISTORY_SIZE);
+    }
+    m_lastPresent = now;
+    m_hasLastPresent = true;
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method returns the mean, standard deviation and
+ *  longest of the recorded frame times.
+ ***********************************************************/
+FRAME_PACING_STATS FramePacer::GetStats() const
+{
+    FRAME_PACING_STATS stats;
+    stats.frameCount = m_frameTimeCount;
+    if (m_frameTimeCount == 0)
+        return stats;
+
+    double total = 0.0;
+    for (int i = 0; i < m_frameTimeCount; i++)
+    {
+        total += m_frameTimes[i];
+        stats.worstMilliseconds = std::max(stats.worstMilliseconds, m_frameTimes[i]);
+    }
+    double mean = total / m_frameTimeCount;
+
+    double variance = 0.0;
+    for (int i = 0; i < m_frameTimeCount; i++)
+    {
+        double difference = m_frameTimes[i] - mean;
+        variance += difference * difference;
+    }
+
+    stats.meanMilliseconds = static_cast<float>(mean);
+    stats.jitterMilliseconds = static_cast<float>(std::sqrt(variance / m_frameTimeCount));
+    return stats;
+}
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.h
+// ============
+// pace the presented frames with the swap interval or a frame rate cap,
+// and measure how evenly the frames are spaced
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+// ways the frames can be paced
+enum FRAME_PACING_MODE {
+    // wait for every vertical blank, lowest power
+    FRAME_PACING_VSYNC,
+    // wait for the vertical blank, but present late frames right away
+    // instead of waiting a whole refresh, vsync where unsupported
+    FRAME_PACING_ADAPTIVE_VSYNC,
+    // no vertical blank, sleep and then spin to a fixed frame rate
+    FRAME_PACING_CAPPED,
+    // present as fast as possible, lowest latency
+    FRAME_PACING_UNCAPPED
+};
+
+// FRAME_PACING_STATS structure - spacing of the recent frames
+struct FRAME_PACING_STATS
+{
+    int frameCount;
+    float meanMilliseconds;
+    float jitterMilliseconds; // standard deviation of the frame times
+    float worstMilliseconds;
+
+    FRAME_PACING_STATS() : frameCount(0), meanMilliseconds(0.0f), jitterMilliseconds(0.0f), worstMilliseconds(0.0f) {}
+};
+
+class FramePacer
+{
+public:
+    // constructor
+    FramePacer();
+    // destructor
+    ~FramePacer();
+
+    // switch the pacing, the cap is only used by FRAME_PACING_CAPPED.
+    // Sets the swap interval, so the window context must be current
+    void SetMode(FRAME_PACING_MODE mode, double capFramesPerSecond = 60.0);
+    FRAME_PACING_MODE GetMode() const { return m_mode; }
+    static const char* GetModeName(FRAME_PACING_MODE mode);
+
+    // called right before the buffers are swapped, waits for the
+    // frame's turn when the frame rate is capped
+    void WaitForPresent();
+    // called right after the buffers are swapped, records the time
+    // since the last frame
+    void FramePresented();
+
+    // spacing of the frames measured since the mode was set, over the
+    // most recent frames
+    FRAME_PACING_STATS GetStats() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    static const int HISTORY_SIZE = 240;
+
+    FRAME_PACING_MODE m_mode;
+    Clock::duration m_capInterval;
+    // time the next capped frame is due
+    Clock::time_point m_nextPresent;
+    Clock::time_point m_lastPresent;
+    bool m_hasLastPresent;
+    // part of the wait spent spinning instead of sleeping, adjusted
+    // to how late the sleeps wake up
+    Clock::duration m_spinMargin;
+    // frame times in a ring
+    std::vector<float> m_frameTimes;
+    int m_nextFrameTime;
+    int m_frameTimeCount;
+};
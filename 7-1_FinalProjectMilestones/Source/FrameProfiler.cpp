@@ -0,0 +1,348 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.cpp
+// ============
+// time the stages of every frame on the CPU and the GPU, keep the timings
+// in a lock-free ring and export a range of frames as a Chrome trace
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/***********************************************************
+ *  Get()
+ *
+ *  This method returns the profiler shared by the whole
+ *  application.
+ ***********************************************************/
+FrameProfiler* FrameProfiler::Get()
+{
+    static FrameProfiler profiler;
+    return &profiler;
+}
+
+/***********************************************************
+ *  FrameProfiler()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameProfiler::FrameProfiler()
+    : m_start(std::chrono::steady_clock::now()),
+      m_frame(0),
+      m_ring(new RING_SLOT[RING_SIZE]),
+      m_writeIndex(0),
+      m_frameSet(0),
+      m_hasQueries(false)
+{
+    for (uint64_t i = 0; i < RING_SIZE; i++)
+        m_ring[i].sequence.store(0, std::memory_order_relaxed);
+
+    for (int set = 0; set < FRAME_SETS; set++)
+    {
+        m_gpuScopeCount[set] = 0;
+        m_gpuFrame[set] = 0;
+        m_gpuClockOffset[set] = 0;
+        m_gpuPending[set] = false;
+        for (int i = 0; i < MAX_GPU_SCOPES; i++)
+        {
+            m_gpuScopes[set][i].name = "";
+            m_gpuScopes[set][i].beginQuery = 0;
+            m_gpuScopes[set][i].endQuery = 0;
+        }
+    }
+}
+
+/***********************************************************
+ *  ~FrameProfiler()
+ *
+ *  The destructor for the class.  The queries are left to
+ *  the OpenGL context, which is already gone at this point.
+ ***********************************************************/
+FrameProfiler::~FrameProfiler()
+{
+    delete[] m_ring;
+}
+
+/***********************************************************
+ *  CreateQueries()
+ *
+ *  This method is used for creating the timestamp queries of
+ *  every frame set.
+ ***********************************************************/
+void FrameProfiler::CreateQueries()
+{
+    if (m_hasQueries)
+        return;
+
+    for (int set = 0; set < FRAME_SETS; set++)
+    {
+        for (int i = 0; i < MAX_GPU_SCOPES; i++)
+        {
+            glGenQueries(1, &m_gpuScopes[set][i].beginQuery);
+            glGenQueries(1, &m_gpuScopes[set][i].endQuery);
+        }
+    }
+    m_hasQueries = true;
+}
+
+/***********************************************************
+ *  Now()
+ *
+ *  This method returns the nanoseconds since the profiler
+ *  was created.
+ ***********************************************************/
+int64_t FrameProfiler::Now() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_start).count();
+}
+
+/***********************************************************
+ *  GetThreadNumber()
+ *
+ *  This method returns a small number for the calling thread,
+ *  handed out the first time the thread records a scope.
+ ***********************************************************/
+uint32_t FrameProfiler::GetThreadNumber()
+{
+    static std::atomic<uint32_t> nextThread(1);
+    thread_local uint32_t thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+    return thread;
+}
+
+/***********************************************************
+ *  PushEvent()
+ *
+ *  This method is used for writing an event into the next
+ *  ring slot.  The sequence is cleared while the event is
+ *  written, so a reader copying the slot at the same time
+ *  sees the sequence change and skips it.
+ ***********************************************************/
+void FrameProfiler::PushEvent(const PROFILE_EVENT& event)
+{
+    uint64_t index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+    RING_SLOT& slot = m_ring[index & (RING_SIZE - 1)];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = event;
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+/***********************************************************
+ *  AddCPUEvent()
+ *
+ *  This method is used for recording a finished CPU scope of
+ *  the calling thread in the current frame.
+ ***********************************************************/
+void FrameProfiler::AddCPUEvent(const char* name, int64_t startNanoseconds, int64_t endNanoseconds)
+{
+    PROFILE_EVENT event;
+    event.name = name;
+    event.startNanoseconds = startNanoseconds;
+    event.endNanoseconds = endNanoseconds;
+    event.frame = GetFrame();
+    event.thread = GetThreadNumber();
+    PushEvent(event);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting a new frame.  The frame
+ *  set about to be reused holds the oldest frame, whose GPU
+ *  timings are read when the GPU has finished them and
+ *  dropped otherwise, so the CPU never waits.
+ ***********************************************************/
+void FrameProfiler::BeginFrame()
+{
+    uint32_t frame = m_frame.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (!m_hasQueries)
+        return;
+
+    int frameSet = (m_frameSet + 1) % FRAME_SETS;
+    if (m_gpuPending[frameSet])
+        CollectGPUFrame(frameSet);
+
+    m_frameSet = frameSet;
+    m_gpuScopeCount[frameSet] = 0;
+    m_gpuFrame[frameSet] = frame;
+    m_gpuPending[frameSet] = false;
+
+    // both clocks are read close together, which lines the GPU
+    // scopes up with the CPU ones in the trace
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    m_gpuClockOffset[frameSet] = static_cast<int64_t>(gpuTime) - Now();
+}
+
+/***********************************************************
+ *  CollectGPUFrame()
+ *
+ *  This method is used for turning the timestamp queries of
+ *  a frame set into GPU events.  The queries finish in order,
+ *  so once the last one is available all of them are.
+ ***********************************************************/
+void FrameProfiler::CollectGPUFrame(int frameSet)
+{
+    m_gpuPending[frameSet] = false;
+    int count = m_gpuScopeCount[frameSet];
+    if (count == 0)
+        return;
+
+    GLint available = 0;
+    glGetQueryObjectiv(m_gpuScopes[frameSet][count - 1].endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return;
+
+    for (int i = 0; i < count; i++)
+    {
+        const GPU_SCOPE& scope = m_gpuScopes[frameSet][i];
+        GLuint64 beginTime = 0;
+        GLuint64 endTime = 0;
+        glGetQueryObjectui64v(scope.beginQuery, GL_QUERY_RESULT, &beginTime);
+        glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &endTime);
+
+        PROFILE_EVENT event;
+        event.name = scope.name;
+        event.startNanoseconds = static_cast<int64_t>(beginTime) - m_gpuClockOffset[frameSet];
+        event.endNanoseconds = static_cast<int64_t>(endTime) - m_gpuClockOffset[frameSet];
+        event.frame = m_gpuFrame[frameSet];
+        event.thread = GPU_THREAD;
+        PushEvent(event);
+    }
+}
+
+/***********************************************************
+ *  BeginGPUScope()
+ *
+ *  This method is used for placing the start timestamp of a
+ *  GPU scope.  Timestamps are used instead of elapsed time
+ *  queries, since those cannot nest and the dynamic
+ *  resolution already times the whole frame with one.
+ ***********************************************************/
+int FrameProfiler::BeginGPUScope(const char* name)
+{
+    if (!m_hasQueries || m_gpuScopeCount[m_frameSet] == MAX_GPU_SCOPES)
+        return -1;
+
+    int scope = m_gpuScopeCount[m_frameSet]++;
+    m_gpuScopes[m_frameSet][scope].name = name;
+    glQueryCounter(m_gpuScopes[m_frameSet][scope].beginQuery, GL_TIMESTAMP);
+    return scope;
+}
+
+/***********************************************************
+ *  EndGPUScope()
+ *
+ *  This method is used for placing the end timestamp of a
+ *  GPU scope.
+ ***********************************************************/
+void FrameProfiler::EndGPUScope(int scope)
+{
+    if (scope < 0)
+        return;
+
+    glQueryCounter(m_gpuScopes[m_frameSet][scope].endQuery, GL_TIMESTAMP);
+    m_gpuPending[m_frameSet] = true;
+}
+
+/***********************************************************
+ *  WriteChromeTrace()
+ *
+ *  This method is used for writing the events of a range of
+ *  frames as complete events of the Chrome trace format,
+ *  which chrome://tracing and Perfetto open.  Slots that are
+ *  being overwritten while they are copied are skipped.
+ ***********************************************************/
+bool FrameProfiler::WriteChromeTrace(const char* filename, uint32_t firstFrame, uint32_t lastFrame) const
+{
+    uint64_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+    uint64_t readIndex = (writeIndex > RING_SIZE) ? writeIndex - RING_SIZE : 0;
+
+    std::vector<PROFILE_EVENT> events;
+    events.reserve(static_cast<size_t>(writeIndex - readIndex));
+    for (uint64_t index = readIndex; index < writeIndex; index++)
+    {
+        const RING_SLOT& slot = m_ring[index & (RING_SIZE - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != index + 1)
+            continue;
+        PROFILE_EVENT event = slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+            continue;
+
+        if (event.frame >= firstFrame && event.frame <= lastFrame)
+            events.push_back(event);
+    }
+
+    std::sort(events.begin(), events.end(),
+        [](const PROFILE_EVENT& a, const PROFILE_EVENT& b) { return a.startNanoseconds < b.startNanoseconds; });
+
+    std::ofstream file(filename);
+    if (!file)
+    {
+        std::cout << "Could not write the trace file " << filename << std::endl;
+        return false;
+    }
+
+    // microseconds with nanosecond digits
+    file << std::fixed << std::setprecision(3);
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU main\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << GPU_THREAD << ",\"args\":{\"name\":\"GPU\"}}";
+    for (const PROFILE_EVENT& event : events)
+    {
+        file << ",\n{\"name\":\"" << event.name
+            << "\",\"cat\":\"" << ((event.thread == GPU_THREAD) ? "gpu" : "cpu")
+            << "\",\"ph\":\"X\",\"ts\":" << event.startNanoseconds / 1000.0
+            << ",\"dur\":" << (event.endNanoseconds - event.startNanoseconds) / 1000.0
+            << ",\"pid\":1,\"tid\":" << event.thread
+            << ",\"args\":{\"frame\":" << event.frame << "}}";
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    if (!file)
+    {
+        std::cout << "Could not write the trace file " << filename << std::endl;
+        return false;
+    }
+
+    std::cout << "Wrote " << events.size() << " profiler events of frames " << firstFrame
+        << " to " << lastFrame << " to " << filename << std::endl;
+    return true;
+}
+
+/***********************************************************
+ *  ProfileScope()
+ *
+ *  The constructor for the class, which starts the scope
+ ***********************************************************/
+ProfileScope::ProfileScope(const char* name, bool gpu)
+    : m_name(name),
+      m_startNanoseconds(0),
+      m_gpuScope(-1)
+{
+    FrameProfiler* profiler = FrameProfiler::Get();
+    if (gpu)
+        m_gpuScope = profiler->BeginGPUScope(name);
+    m_startNanoseconds = profiler->Now();
+}
+
+/***********************************************************
+ *  ~ProfileScope()
+ *
+ *  The destructor for the class, which records the scope
+ ***********************************************************/
+ProfileScope::~ProfileScope()
+{
+    FrameProfiler* profiler = FrameProfiler::Get();
+    profiler->AddCPUEvent(m_name, m_startNanoseconds, profiler->Now());
+    profiler->EndGPUScope(m_gpuScope);
+}
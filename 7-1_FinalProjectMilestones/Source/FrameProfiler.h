@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.h
+// ============
+// time the stages of every frame on the CPU and the GPU, keep the timings
+// in a lock-free ring and export a range of frames as a Chrome trace
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// time the rest of the enclosing block on the CPU, the name must be a
+// string that outlives the profiler, such as a literal
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name, false)
+// time the rest of the enclosing block on the CPU and the GPU, only on
+// the thread that owns the OpenGL context
+#define PROFILE_GPU_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name, true)
+
+// PROFILE_EVENT structure - one timed scope
+struct PROFILE_EVENT
+{
+    const char* name;
+    int64_t startNanoseconds; // since the profiler was created
+    int64_t endNanoseconds;
+    uint32_t frame;
+    uint32_t thread; // small number per thread, GPU_THREAD for GPU work
+
+    PROFILE_EVENT() : name(""), startNanoseconds(0), endNanoseconds(0), frame(0), thread(0) {}
+};
+
+class FrameProfiler
+{
+public:
+    // track the GPU scopes are listed on
+    static const uint32_t GPU_THREAD = 1000;
+
+    // the one profiler of the application
+    static FrameProfiler* Get();
+
+    // create the GPU timer queries, needs a current OpenGL context
+    void CreateQueries();
+
+    // start a new frame, collecting the GPU timings of the oldest
+    // frame still waiting for them
+    void BeginFrame();
+    uint32_t GetFrame() const { return m_frame.load(std::memory_order_relaxed); }
+
+    // nanoseconds since the profiler was created
+    int64_t Now() const;
+    // add a finished CPU scope of the calling thread
+    void AddCPUEvent(const char* name, int64_t startNanoseconds, int64_t endNanoseconds);
+    // start and end a GPU scope, returns -1 when the scope is not timed
+    int BeginGPUScope(const char* name);
+    void EndGPUScope(int scope);
+
+    // write the events of the frames from first to last, as far as the
+    // ring still holds them, in the Chrome trace event format
+    bool WriteChromeTrace(const char* filename, uint32_t firstFrame, uint32_t lastFrame) const;
+
+private:
+    FrameProfiler();
+    ~FrameProfiler();
+
+    // claim a ring slot and fill it, any thread
+    void PushEvent(const PROFILE_EVENT& event);
+    // turn the finished GPU queries of a frame set into events
+    void CollectGPUFrame(int frameSet);
+    static uint32_t GetThreadNumber();
+
+    // RING_SLOT structure - an event and the write that filled it
+    struct RING_SLOT
+    {
+        // index the slot was written for plus one, 0 while empty
+        std::atomic<uint64_t> sequence;
+        PROFILE_EVENT event;
+    };
+
+    // GPU_SCOPE structure - a pair of timestamp queries
+    struct GPU_SCOPE
+    {
+        const char* name;
+        GLuint beginQuery;
+        GLuint endQuery;
+    };
+
+    static const uint64_t RING_SIZE = 1 << 16;
+    static const int FRAME_SETS = 3;
+    static const int MAX_GPU_SCOPES = 32;
+
+    std::chrono::steady_clock::time_point m_start;
+    std::atomic<uint32_t> m_frame;
+
+    RING_SLOT* m_ring;
+    std::atomic<uint64_t> m_writeIndex;
+
+    // GPU scopes of the last few frames, read back FRAME_SETS - 1
+    // frames later so the CPU never waits for them
+    GPU_SCOPE m_gpuScopes[FRAME_SETS][MAX_GPU_SCOPES];
+    int m_gpuScopeCount[FRAME_SETS];
+    uint32_t m_gpuFrame[FRAME_SETS];
+    // GPU clock minus the profiler clock, measured at the frame start
+    int64_t m_gpuClockOffset[FRAME_SETS];
+    bool m_gpuPending[FRAME_SETS];
+    int m_frameSet;
+    bool m_hasQueries;
+};
+
+class ProfileScope
+{
+public:
+    ProfileScope(const char* name, bool gpu);
+    ~ProfileScope();
+
+private:
+    const char* m_name;
+    int64_t m_startNanoseconds;
+    int m_gpuScope;
+};
@@ -0,0 +1,440 @@
+///////////////////////////////////////////////////////////////////////////////
+// glstatecache.cpp
+// ============
+// track the OpenGL state so calls that would not change it are dropped
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "GLStateCache.h"
+#include "RenderCounters.h"
+
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+    // capabilities whose enabled state is tracked, any other
+    // capability is always passed through
+    const GLenum g_TrackedCapabilities[] = {
+        GL_DEPTH_TEST,
+        GL_BLEND,
+        GL_CULL_FACE,
+        GL_SCISSOR_TEST,
+        GL_STENCIL_TEST,
+        GL_FRAMEBUFFER_SRGB
+    };
+
+    // texture targets whose bindings are tracked per unit
+    const GLenum g_TrackedTextureTargets[] = {
+        GL_TEXTURE_2D,
+        GL_TEXTURE_2D_ARRAY
+    };
+
+    // only report the first redundant clear so the console is not flooded
+    bool g_RedundantClearReported = false;
+}
+
+/***********************************************************
+ *  Get()
+ *
+ *  This method returns the state cache shared by everything
+ *  that renders into the OpenGL context.
+ ***********************************************************/
+GLStateCache* GLStateCache::Get()
+{
+    static GLStateCache stateCache;
+    return &stateCache;
+}
+
+/***********************************************************
+ *  GLStateCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GLStateCache::GLStateCache()
+{
+    Invalidate();
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for closing the counts of the last
+ *  frame and starting new ones.
+ ***********************************************************/
+void GLStateCache::BeginFrame()
+{
+    m_lastFrameStats = m_frameStats;
+    m_frameStats = GL_STATE_STATS();
+
+    // the back buffer contents are undefined after a swap
+    m_clearedBuffers = 0;
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for marking every tracked value as
+ *  unknown, so the next call for each of them is issued.
+ ***********************************************************/
+void GLStateCache::Invalidate()
+{
+    for (int i = 0; i < CAPABILITY_COUNT; i++)
+    {
+        m_capabilities[i] = -1;
+    }
+    m_depthFunc = -1;
+    m_depthMask = -1;
+    m_colorMask = -1;
+    m_blendSource = -1;
+    m_blendDestination = -1;
+    m_clearColorKnown = false;
+    m_drawFramebuffer = -1;
+    m_readFramebuffer = -1;
+    m_program = -1;
+    m_activeUnit = -1;
+    for (int unit = 0; unit < TEXTURE_UNIT_COUNT; unit++)
+    {
+        for (int target = 0; target < TEXTURE_TARGET_COUNT; target++)
+        {
+            m_boundTextures[unit][target] = -1;
+        }
+    }
+    m_clearedBuffers = 0;
+}
+
+/***********************************************************
+ *  Track()
+ *
+ *  This method is used for counting a state call as issued
+ *  or suppressed and tells the caller whether to issue it.
+ ***********************************************************/
+bool GLStateCache::Track(bool changed)
+{
+    if (changed)
+        m_frameStats.issuedCalls++;
+    else
+        m_frameStats.suppressedCalls++;
+
+    return changed;
+}
+
+/***********************************************************
+ *  FindCapability()
+ *
+ *  This method returns the tracking slot of a capability or
+ *  -1 if the capability is not tracked.
+ ***********************************************************/
+int GLStateCache::FindCapability(GLenum capability) const
+{
+    for (int i = 0; i < CAPABILITY_COUNT; i++)
+    {
+        if (g_TrackedCapabilities[i] == capability)
+            return i;
+    }
+    return -1;
+}
+
+/***********************************************************
+ *  FindTextureTarget()
+ *
+ *  This method returns the tracking slot of a texture target
+ *  or -1 if the target is not tracked.
+ ***********************************************************/
+int GLStateCache::FindTextureTarget(GLenum target) const
+{
+    for (int i = 0; i < TEXTURE_TARGET_COUNT; i++)
+    {
+        if (g_TrackedTextureTargets[i] == target)
+            return i;
+    }
+    return -1;
+}
+
+/***********************************************************
+ *  Enable()
+ *
+ *  This method is used for enabling a capability.
+ ***********************************************************/
+void GLStateCache::Enable(GLenum capability)
+{
+    int slot = FindCapability(capability);
+    if (slot == -1)
+    {
+        Track(true);
+        glEnable(capability);
+        return;
+    }
+
+    if (Track(m_capabilities[slot] != 1))
+    {
+        glEnable(capability);
+        m_capabilities[slot] = 1;
+    }
+}
+
+/***********************************************************
+ *  Disable()
+ *
+ *  This method is used for disabling a capability.
+ ***********************************************************/
+void GLStateCache::Disable(GLenum capability)
+{
+    int slot = FindCapability(capability);
+    if (slot == -1)
+    {
+        Track(true);
+        glDisable(capability);
+        return;
+    }
+
+    if (Track(m_capabilities[slot] != 0))
+    {
+        glDisable(capability);
+        m_capabilities[slot] = 0;
+    }
+}
+
+/***********************************************************
+ *  IsEnabled()
+ *
+ *  This method returns whether a capability is enabled,
+ *  asking OpenGL only when the state is not known yet.
+ ***********************************************************/
+bool GLStateCache::IsEnabled(GLenum capability)
+{
+    int slot = FindCapability(capability);
+    if (slot == -1)
+        return glIsEnabled(capability) == GL_TRUE;
+
+    if (m_capabilities[slot] == -1)
+        m_capabilities[slot] = (glIsEnabled(capability) == GL_TRUE) ? 1 : 0;
+
+    return m_capabilities[slot] == 1;
+}
+
+/***********************************************************
+ *  DepthFunc()
+ *
+ *  This method is used for setting the depth comparison.
+ ***********************************************************/
+void GLStateCache::DepthFunc(GLenum func)
+{
+    if (Track(m_depthFunc != static_cast<GLint>(func)))
+    {
+        glDepthFunc(func);
+        m_depthFunc = func;
+    }
+}
+
+/***********************************************************
+ *  DepthMask()
+ *
+ *  This method is used for turning depth writes on or off.
+ ***********************************************************/
+void GLStateCache::DepthMask(GLboolean flag)
+{
+    if (Track(m_depthMask != static_cast<GLint>(flag)))
+    {
+        glDepthMask(flag);
+        m_depthMask = flag;
+    }
+}
+
+/***********************************************************
+ *  ColorMask()
+ *
+ *  This method is used for turning color writes on or off for
+ *  each channel.
+ ***********************************************************/
+void GLStateCache::ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    GLint mask = (red ? 1 : 0) | (green ? 2 : 0) | (blue ? 4 : 0) | (alpha ? 8 : 0);
+    if (Track(m_colorMask != mask))
+    {
+        glColorMask(red, green, blue, alpha);
+        m_colorMask = mask;
+    }
+}
+
+/***********************************************************
+ *  BlendFunc()
+ *
+ *  This method is used for setting the blending factors.
+ ***********************************************************/
+void GLStateCache::BlendFunc(GLenum sourceFactor, GLenum destinationFactor)
+{
+    if (Track(m_blendSource != static_cast<GLint>(sourceFactor) ||
+        m_blendDestination != static_cast<GLint>(destinationFactor)))
+    {
+        glBlendFunc(sourceFactor, destinationFactor);
+        m_blendSource = sourceFactor;
+        m_blendDestination = destinationFactor;
+    }
+}
+
+/***********************************************************
+ *  ClearColor()
+ *
+ *  This method is used for setting the color buffer clear
+ *  value.
+ ***********************************************************/
+void GLStateCache::ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    bool changed = !m_clearColorKnown ||
+        m_clearColor[0] != red || m_clearColor[1] != green ||
+        m_clearColor[2] != blue || m_clearColor[3] != alpha;
+
+    if (Track(changed))
+    {
+        glClearColor(red, green, blue, alpha);
+        m_clearColor[0] = red;
+        m_clearColor[1] = green;
+        m_clearColor[2] = blue;
+        m_clearColor[3] = alpha;
+        m_clearColorKnown = true;
+
+        // clearing the color buffer again now gives a new result
+        m_clearedBuffers &= ~GL_COLOR_BUFFER_BIT;
+    }
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for clearing the buffers of the bound
+ *  framebuffer.  Buffers that were already cleared with
+ *  nothing drawn since are left out, and a clear with nothing
+ *  left to do is dropped and reported as a double clear.
+ ***********************************************************/
+void GLStateCache::Clear(GLbitfield mask)
+{
+    GLbitfield needed = mask & ~m_clearedBuffers;
+    if (needed != mask)
+    {
+        m_frameStats.redundantClears++;
+        if (!g_RedundantClearReported)
+        {
+            std::cout << "GLStateCache: buffers cleared twice in one frame with nothing drawn in between" << std::endl;
+            g_RedundantClearReported = true;
+        }
+    }
+
+    if (Track(needed != 0))
+    {
+        glClear(needed);
+        m_clearedBuffers |= needed;
+    }
+}
+
+/***********************************************************
+ *  BindFramebuffer()
+ *
+ *  This method is used for binding a framebuffer object.
+ ***********************************************************/
+void GLStateCache::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    bool drawChanged = (target != GL_READ_FRAMEBUFFER) && (m_drawFramebuffer != static_cast<GLint>(framebuffer));
+    bool readChanged = (target != GL_DRAW_FRAMEBUFFER) && (m_readFramebuffer != static_cast<GLint>(framebuffer));
+
+    if (Track(drawChanged || readChanged))
+    {
+        glBindFramebuffer(target, framebuffer);
+        if (target != GL_READ_FRAMEBUFFER)
+        {
+            m_drawFramebuffer = framebuffer;
+            // clears now go to different buffers
+            m_clearedBuffers = 0;
+        }
+        if (target != GL_DRAW_FRAMEBUFFER)
+            m_readFramebuffer = framebuffer;
+    }
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used for making a shader program current.
+ ***********************************************************/
+void GLStateCache::UseProgram(GLuint program)
+{
+    if (Track(m_program != static_cast<GLint>(program)))
+    {
+        glUseProgram(program);
+        m_program = program;
+        RenderCounters::Get()->Add(COUNTER_PROGRAM_SWITCHES, 1);
+    }
+}
+
+/***********************************************************
+ *  GetProgram()
+ *
+ *  This method returns the program in use, asking OpenGL
+ *  only when it is not known yet.
+ ***********************************************************/
+GLuint GLStateCache::GetProgram()
+{
+    if (m_program == -1)
+        glGetIntegerv(GL_CURRENT_PROGRAM, &m_program);
+
+    return static_cast<GLuint>(m_program);
+}
+
+/***********************************************************
+ *  ActiveTexture()
+ *
+ *  This method is used for selecting the active texture unit.
+ ***********************************************************/
+void GLStateCache::ActiveTexture(GLenum textureUnit)
+{
+    if (Track(m_activeUnit != static_cast<GLint>(textureUnit)))
+    {
+        glActiveTexture(textureUnit);
+        m_activeUnit = textureUnit;
+    }
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for binding a texture to the active
+ *  texture unit.
+ ***********************************************************/
+void GLStateCache::BindTexture(GLenum target, GLuint texture)
+{
+    int unit = m_activeUnit - GL_TEXTURE0;
+    int slot = FindTextureTarget(target);
+    if (m_activeUnit == -1 || unit >= TEXTURE_UNIT_COUNT || slot == -1)
+    {
+        Track(true);
+        glBindTexture(target, texture);
+        RenderCounters::Get()->Add(COUNTER_TEXTURE_BINDS, 1);
+        return;
+    }
+
+    if (Track(m_boundTextures[unit][slot] != static_cast<GLint>(texture)))
+    {
+        glBindTexture(target, texture);
+        m_boundTextures[unit][slot] = texture;
+        RenderCounters::Get()->Add(COUNTER_TEXTURE_BINDS, 1);
+    }
+}
+
+/***********************************************************
+ *  NotifyTextureDeleted()
+ *
+ *  This method is used for forgetting a deleted texture, so
+ *  a new texture that reuses its name is bound again.
+ ***********************************************************/
+void GLStateCache::NotifyTextureDeleted(GLuint texture)
+{
+    for (int unit = 0; unit < TEXTURE_UNIT_COUNT; unit++)
+    {
+        for (int target = 0; target < TEXTURE_TARGET_COUNT; target++)
+        {
+            if (m_boundTextures[unit][target] == static_cast<GLint>(texture))
+                m_boundTextures[unit][target] = 0;
+        }
+    }
+}
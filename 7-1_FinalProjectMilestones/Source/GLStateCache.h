@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+// glstatecache.h
+// ============
+// track the OpenGL state so calls that would not change it are dropped
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+// GL_STATE_STATS structure - call counts for one frame
+struct GL_STATE_STATS
+{
+    unsigned int issuedCalls;
+    unsigned int suppressedCalls;
+    unsigned int redundantClears;
+
+    GL_STATE_STATS() : issuedCalls(0), suppressedCalls(0), redundantClears(0) {}
+};
+
+class GLStateCache
+{
+public:
+    // the one state cache for the OpenGL context
+    static GLStateCache* Get();
+
+    // start counting a new frame, the counts of the finished frame
+    // stay available through GetLastFrameStats()
+    void BeginFrame();
+    const GL_STATE_STATS& GetLastFrameStats() const { return m_lastFrameStats; }
+    const GL_STATE_STATS& GetCurrentFrameStats() const { return m_frameStats; }
+
+    // forget everything known about the context, used after code
+    // outside the cache has changed the state
+    void Invalidate();
+
+    // capabilities
+    void Enable(GLenum capability);
+    void Disable(GLenum capability);
+    bool IsEnabled(GLenum capability);
+
+    // depth and blending
+    void DepthFunc(GLenum func);
+    void DepthMask(GLboolean flag);
+    void ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+    void BlendFunc(GLenum sourceFactor, GLenum destinationFactor);
+
+    // clearing - a clear of buffers that nothing was drawn into since
+    // their last clear is dropped and counted as a redundant clear
+    void ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+    void Clear(GLbitfield mask);
+
+    // framebuffer, program and texture bindings
+    void BindFramebuffer(GLenum target, GLuint framebuffer);
+    void UseProgram(GLuint program);
+    GLuint GetProgram();
+    void ActiveTexture(GLenum textureUnit);
+    void BindTexture(GLenum target, GLuint texture);
+    void NotifyTextureDeleted(GLuint texture);
+
+    // called for every draw so clears know the buffers were used
+    void NotifyDraw() { m_clearedBuffers = 0; }
+
+private:
+    GLStateCache();
+
+    // returns true when the call is needed, counting it either way
+    bool Track(bool changed);
+    int FindCapability(GLenum capability) const;
+    int FindTextureTarget(GLenum target) const;
+
+    static const int CAPABILITY_COUNT = 6;
+    static const int TEXTURE_UNIT_COUNT = 32;
+    static const int TEXTURE_TARGET_COUNT = 2;
+
+    // -1 marks a value that is not known yet
+    int m_capabilities[CAPABILITY_COUNT];
+    GLint m_depthFunc;
+    GLint m_depthMask;
+    GLint m_colorMask; // one bit per channel
+    GLint m_blendSource;
+    GLint m_blendDestination;
+    GLfloat m_clearColor[4];
+    bool m_clearColorKnown;
+    GLint m_drawFramebuffer;
+    GLint m_readFramebuffer;
+    GLint m_program;
+    GLint m_activeUnit;
+    GLint m_boundTextures[TEXTURE_UNIT_COUNT][TEXTURE_TARGET_COUNT];
+
+    // buffers cleared with nothing drawn into them yet
+    GLbitfield m_clearedBuffers;
+
+    GL_STATE_STATS m_frameStats;
+    GL_STATE_STATS m_lastFrameStats;
+};
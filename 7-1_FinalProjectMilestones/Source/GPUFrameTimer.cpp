@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+// gpuframetimer.cpp
+// ============
+// time every frame of a measured run on the GPU with a pair of timestamp
+// queries per frame, read back once the run is over
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "GPUFrameTimer.h"
+
+/***********************************************************
+ *  GPUFrameTimer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GPUFrameTimer::GPUFrameTimer()
+{
+}
+
+/***********************************************************
+ *  ~GPUFrameTimer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+GPUFrameTimer::~GPUFrameTimer()
+{
+    if (!m_queries.empty())
+        glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating a begin and an end query
+ *  for every frame up front, so no frame waits on a query of
+ *  an earlier one.  Timestamps are used since the dynamic
+ *  resolution times its frames with an elapsed time query,
+ *  and those cannot nest.
+ ***********************************************************/
+void GPUFrameTimer::Create(int frameCount)
+{
+    if (frameCount <= 0)
+        return;
+
+    m_queries.resize(frameCount * 2, 0);
+    m_timed.assign(frameCount, false);
+    glGenQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for placing the start timestamp of a
+ *  frame.
+ ***********************************************************/
+void GPUFrameTimer::BeginFrame(int frame)
+{
+    if (frame < 0 || frame >= static_cast<int>(m_timed.size()))
+        return;
+
+    glQueryCounter(m_queries[frame * 2], GL_TIMESTAMP);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for placing the end timestamp of a
+ *  frame.
+ ***********************************************************/
+void GPUFrameTimer::EndFrame(int frame)
+{
+    if (frame < 0 || frame >= static_cast<int>(m_timed.size()))
+        return;
+
+    glQueryCounter(m_queries[frame * 2 + 1], GL_TIMESTAMP);
+    m_timed[frame] = true;
+}
+
+/***********************************************************
+ *  ReadFrameTimes()
+ *
+ *  This method is used for reading the time between the two
+ *  timestamps of every frame.  Reading a result waits for
+ *  the GPU, which is fine once the measured run is over.
+ ***********************************************************/
+std::vector<float> GPUFrameTimer::ReadFrameTimes(int frameCount) const
+{
+    std::vector<float> milliseconds(frameCount > 0 ? frameCount : 0, 0.0f);
+    for (int frame = 0; frame < frameCount && frame < static_cast<int>(m_timed.size()); frame++)
+    {
+        if (!m_timed[frame])
+            continue;
+
+        GLuint64 beginTime = 0;
+        GLuint64 endTime = 0;
+        glGetQueryObjectui64v(m_queries[frame * 2], GL_QUERY_RESULT, &beginTime);
+        glGetQueryObjectui64v(m_queries[frame * 2 + 1], GL_QUERY_RESULT, &endTime);
+        milliseconds[frame] = static_cast<float>(endTime - beginTime) / 1000000.0f;
+    }
+    return milliseconds;
+}
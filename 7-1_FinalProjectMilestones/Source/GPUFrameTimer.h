@@ -0,0 +1,39 @@
+///////////////////////////////////////////////////////////////////////////////
+// gpuframetimer.h
+// ============
+// time every frame of a measured run on the GPU with a pair of timestamp
+// queries per frame, read back once the run is over
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+class GPUFrameTimer
+{
+public:
+    // constructor
+    GPUFrameTimer();
+    // destructor
+    ~GPUFrameTimer();
+
+    // create the queries of the passed in number of frames
+    void Create(int frameCount);
+
+    // place the timestamps around the GL work of a frame, frames
+    // past the created count are not timed
+    void BeginFrame(int frame);
+    void EndFrame(int frame);
+
+    // wait for the timed frames and return their GPU times in
+    // milliseconds, 0 for frames that were not timed
+    std::vector<float> ReadFrameTimes(int frameCount) const;
+
+private:
+    std::vector<GLuint> m_queries; // begin and end of every frame
+    std::vector<bool> m_timed;
+};
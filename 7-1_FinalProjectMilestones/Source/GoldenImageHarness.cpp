@@ -0,0 +1,439 @@
+///////////////////////////////////////////////////////////////////////////////
+// goldenimageharness.cpp
+// ============
+// render the scene offscreen from fixed camera poses, compare every image
+// to a stored golden image and time each pose
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "GoldenImageHarness.h"
+#include "GLStateCache.h"
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+    // poses spread over the scene, from the starting view, down among
+    // the trees, from the sides and above
+    const GOLDEN_POSE g_Poses[] = {
+        { "start",     glm::vec3(0.0f, 5.0f, 12.0f),   -90.0f,   0.0f },
+        { "trees",     glm::vec3(0.0f, 0.5f, 8.0f),    -90.0f,   0.0f },
+        { "side",      glm::vec3(24.0f, 6.0f, 0.0f),   180.0f, -15.0f },
+        { "overview",  glm::vec3(0.0f, 30.0f, 20.0f),  -90.0f, -55.0f },
+        { "mountains", glm::vec3(0.0f, 3.0f, -5.0f),   -90.0f,   5.0f },
+        { "back",      glm::vec3(0.0f, 4.0f, -20.0f),   90.0f, -10.0f }
+    };
+
+    // frames drawn before the image is kept, so the detail levels,
+    // the draw order and the cached shadow casters have settled
+    const int g_WarmupFrames = 3;
+    // frames timed for every pose
+    const int g_TimedFrames = 20;
+    // the animations are held at one time, so every run draws the same
+    const float g_AnimationTime = 0.0f;
+
+    // color difference, in CIE Lab units, that is plainly visible,
+    // a difference of about 2.3 is just noticeable
+    const float g_VisibleDelta = 5.0f;
+    const float g_DefaultTolerancePercent = 0.1f;
+}
+
+/***********************************************************
+ *  GoldenImageHarness()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GoldenImageHarness::GoldenImageHarness(SceneManager* pSceneManager, ViewManager* pViewManager)
+    : m_pSceneManager(pSceneManager), m_pViewManager(pViewManager), m_tolerancePercent(g_DefaultTolerancePercent),
+    m_framebuffer(0), m_colorRenderbuffer(0), m_depthRenderbuffer(0), m_width(0), m_height(0)
+{
+}
+
+/***********************************************************
+ *  ~GoldenImageHarness()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+GoldenImageHarness::~GoldenImageHarness()
+{
+    if (m_framebuffer != 0)
+    {
+        GLStateCache::Get()->BindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &m_framebuffer);
+    }
+    if (m_colorRenderbuffer != 0)
+        glDeleteRenderbuffers(1, &m_colorRenderbuffer);
+    if (m_depthRenderbuffer != 0)
+        glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+}
+
+/***********************************************************
+ *  CreateTarget()
+ *
+ *  This method is used for creating the offscreen framebuffer
+ *  the poses are drawn into and read back from.
+ ***********************************************************/
+bool GoldenImageHarness::CreateTarget(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+
+    glGenRenderbuffers(1, &m_colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &m_depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    GLStateCache::Get()->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Golden image framebuffer is incomplete at " << width << "x" << height << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for checking every pose with every
+ *  render path the scene offers.  A pose without a golden
+ *  image stores its image as the golden one.  A failing pose
+ *  leaves its image and a difference image next to the
+ *  golden one, with the differing pixels in red.
+ ***********************************************************/
+bool GoldenImageHarness::Run(const char* directory, bool updateGoldens)
+{
+    if (!CreateTarget(m_pViewManager->GetWindowWidth(), m_pViewManager->GetWindowHeight()))
+        return false;
+
+    RENDER_PATH startPath = m_pSceneManager->GetRenderPath();
+    const RENDER_PATH renderPaths[2] = { RENDER_PATH_FORWARD, RENDER_PATH_DEFERRED };
+    const char* pathNames[2] = { "forward", "deferred" };
+
+    std::vector<unsigned char> pixels;
+    std::vector<unsigned char> diffPixels;
+    bool allPassed = true;
+    m_results.clear();
+
+    for (int path = 0; path < 2; path++)
+    {
+        m_pSceneManager->SetRenderPath(renderPaths[path]);
+        if (m_pSceneManager->GetRenderPath() != renderPaths[path])
+            continue;
+
+        for (const GOLDEN_POSE& pose : g_Poses)
+        {
+            m_pViewManager->SetCameraPose(pose.position, pose.yaw, pose.pitch);
+            float meanMilliseconds = RenderPose(g_TimedFrames);
+            ReadImage(pixels);
+
+            std::string name = std::string(pose.name) + "_" + pathNames[path];
+            std::string goldenFile = std::string(directory) + "/" + name + ".ppm";
+
+            GOLDEN_RESULT result;
+            std::ifstream existing(goldenFile, std::ios::binary);
+            if (updateGoldens || !existing.good())
+            {
+                result.created = WritePPM(goldenFile, m_width, m_height, pixels);
+                result.passed = result.created;
+            }
+            else
+            {
+                existing.close();
+                result = CheckPose(goldenFile, pixels, diffPixels);
+                if (!result.passed)
+                {
+                    WritePPM(std::string(directory) + "/" + name + "_actual.ppm", m_width, m_height, pixels);
+                    WritePPM(std::string(directory) + "/" + name + "_diff.ppm", m_width, m_height, diffPixels);
+                }
+            }
+            result.name = name;
+            result.meanMilliseconds = meanMilliseconds;
+
+            std::cout << "Golden image " << name << ": "
+                << (result.created ? "stored" : (result.passed ? "passed" : "FAILED")) << ", "
+                << result.differentPercent << "% of the pixels differ, largest difference " << result.maxDelta
+                << ", " << meanMilliseconds << " ms per frame" << std::endl;
+            allPassed = allPassed && result.passed;
+            m_results.push_back(result);
+        }
+    }
+
+    m_pSceneManager->SetRenderPath(startPath);
+    GLStateCache::Get()->BindFramebuffer(GL_FRAMEBUFFER, 0);
+    WriteReport((std::string(directory) + "/report.json").c_str());
+    return allPassed;
+}
+
+/***********************************************************
+ *  RenderPose()
+ *
+ *  This method is used for drawing the current camera pose
+ *  a number of times and returning the mean frame time.  Each
+ *  frame waits for the GPU, so its time covers the CPU and
+ *  the GPU work.  The image of the last frame is left in the
+ *  framebuffer.
+ ***********************************************************/
+float GoldenImageHarness::RenderPose(int frameCount)
+{
+    GLStateCache* stateCache = GLStateCache::Get();
+    double totalMilliseconds = 0.0;
+
+    for (int frame = 0; frame < g_WarmupFrames + frameCount; frame++)
+    {
+        auto frameStart = std::chrono::steady_clock::now();
+
+        stateCache->BeginFrame();
+        FrameArena::Get()->Reset();
+        stateCache->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        glViewport(0, 0, m_width, m_height);
+        stateCache->Enable(GL_DEPTH_TEST);
+        stateCache->ClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        stateCache->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        m_pViewManager->PrepareSceneView();
+        m_pSceneManager->SetViewParameters(
+            m_pViewManager->GetCameraPosition(),
+            m_pViewManager->GetPixelsPerUnit(),
+            m_pViewManager->GetViewMatrix(),
+            m_pViewManager->GetProjectionMatrix());
+        m_pSceneManager->SetFrustumPlanes(m_pViewManager->GetFrustumPlanes());
+        m_pSceneManager->UpdateScene(g_AnimationTime);
+        m_pSceneManager->RenderScene();
+        glFinish();
+
+        std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - frameStart;
+        if (frame >= g_WarmupFrames)
+            totalMilliseconds += frameTime.count();
+    }
+
+    return (frameCount > 0) ? static_cast<float>(totalMilliseconds / frameCount) : 0.0f;
+}
+
+/***********************************************************
+ *  ReadImage()
+ *
+ *  This method is used for reading the framebuffer as RGB
+ *  rows from the top down, the order of the image files.
+ ***********************************************************/
+void GoldenImageHarness::ReadImage(std::vector<unsigned char>& pixels) const
+{
+    size_t rowSize = static_cast<size_t>(m_width) * 3;
+    std::vector<unsigned char> rows(rowSize * m_height);
+
+    GLStateCache::Get()->BindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, rows.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    pixels.resize(rows.size());
+    for (int y = 0; y < m_height; y++)
+    {
+        std::copy(rows.begin() + (m_height - 1 - y) * rowSize, rows.begin() + (m_height - y) * rowSize,
+            pixels.begin() + y * rowSize);
+    }
+}
+
+/***********************************************************
+ *  ToLab()
+ *
+ *  This method is used for converting an sRGB color to CIE
+ *  Lab, where distances follow how different colors look.
+ ***********************************************************/
+glm::vec3 GoldenImageHarness::ToLab(const unsigned char* rgb)
+{
+    float linear[3];
+    for (int i = 0; i < 3; i++)
+    {
+        float channel = rgb[i] / 255.0f;
+        linear[i] = (channel <= 0.04045f) ? channel / 12.92f : powf((channel + 0.055f) / 1.055f, 2.4f);
+    }
+
+    // D65 white point
+    float xyz[3] = {
+        (0.4124f * linear[0] + 0.3576f * linear[1] + 0.1805f * linear[2]) / 0.95047f,
+        (0.2126f * linear[0] + 0.7152f * linear[1] + 0.0722f * linear[2]),
+        (0.0193f * linear[0] + 0.1192f * linear[1] + 0.9505f * linear[2]) / 1.08883f
+    };
+    for (float& value : xyz)
+    {
+        value = (value > 0.008856f) ? cbrtf(value) : (7.787f * value + 16.0f / 116.0f);
+    }
+    return glm::vec3(116.0f * xyz[1] - 16.0f, 500.0f * (xyz[0] - xyz[1]), 200.0f * (xyz[1] - xyz[2]));
+}
+
+/***********************************************************
+ *  CheckPose()
+ *
+ *  This method is used for comparing an image to its golden
+ *  image.  A pixel differs when its Lab color is visibly
+ *  away from the golden pixel and from all of that pixel's
+ *  neighbors, so edges moved by a pixel are not counted.  The
+ *  pose passes while the differing pixels stay within the
+ *  tolerance.
+ ***********************************************************/
+GOLDEN_RESULT GoldenImageHarness::CheckPose(const std::string& path, const std::vector<unsigned char>& pixels, std::vector<unsigned char>& diffPixels) const
+{
+    GOLDEN_RESULT result;
+    int goldenWidth = 0;
+    int goldenHeight = 0;
+    std::vector<unsigned char> golden;
+    if (!ReadPPM(path, goldenWidth, goldenHeight, golden) || goldenWidth != m_width || goldenHeight != m_height)
+    {
+        std::cout << "Golden image " << path << " is unreadable or not " << m_width << "x" << m_height << std::endl;
+        result.differentPercent = 100.0f;
+        diffPixels = pixels;
+        return result;
+    }
+
+    size_t pixelCount = static_cast<size_t>(m_width) * m_height;
+    std::vector<glm::vec3> goldenLab(pixelCount);
+    for (size_t i = 0; i < pixelCount; i++)
+    {
+        goldenLab[i] = ToLab(&golden[i * 3]);
+    }
+
+    diffPixels.resize(pixels.size());
+    size_t differentPixels = 0;
+    for (int y = 0; y < m_height; y++)
+    {
+        for (int x = 0; x < m_width; x++)
+        {
+            size_t index = static_cast<size_t>(y) * m_width + x;
+            glm::vec3 lab = ToLab(&pixels[index * 3]);
+            float delta = glm::length(lab - goldenLab[index]);
+            result.maxDelta = std::max(result.maxDelta, delta);
+
+            bool different = delta > g_VisibleDelta;
+            for (int ny = std::max(y - 1, 0); different && ny <= std::min(y + 1, m_height - 1); ny++)
+            {
+                for (int nx = std::max(x - 1, 0); different && nx <= std::min(x + 1, m_width - 1); nx++)
+                {
+                    different = glm::length(lab - goldenLab[static_cast<size_t>(ny) * m_width + nx]) > g_VisibleDelta;
+                }
+            }
+
+            // the difference image is the golden one dimmed, with the
+            // differing pixels in red
+            unsigned char* diff = &diffPixels[index * 3];
+            if (different)
+            {
+                differentPixels++;
+                diff[0] = 255;
+                diff[1] = 0;
+                diff[2] = 0;
+            }
+            else
+            {
+                diff[0] = golden[index * 3] / 3;
+                diff[1] = golden[index * 3 + 1] / 3;
+                diff[2] = golden[index * 3 + 2] / 3;
+            }
+        }
+    }
+
+    result.differentPercent = 100.0f * differentPixels / pixelCount;
+    result.passed = result.differentPercent <= m_tolerancePercent;
+    return result;
+}
+
+/***********************************************************
+ *  ReadPPM()
+ *
+ *  This method is used for reading a binary PPM image with
+ *  8 bits per channel.
+ ***********************************************************/
+bool GoldenImageHarness::ReadPPM(const std::string& filename, int& width, int& height, std::vector<unsigned char>& pixels)
+{
+    std::ifstream file(filename, std::ios::binary);
+    std::string magic;
+    int maxValue = 0;
+    file >> magic;
+
+    // skip the comment lines between the header values
+    auto readValue = [&file](int& value) {
+        file >> std::ws;
+        while (file.peek() == '#')
+        {
+            std::string comment;
+            std::getline(file, comment);
+            file >> std::ws;
+        }
+        file >> value;
+    };
+    readValue(width);
+    readValue(height);
+    readValue(maxValue);
+    if (!file || magic != "P6" || maxValue != 255 || width <= 0 || height <= 0)
+        return false;
+
+    file.get();
+    pixels.resize(static_cast<size_t>(width) * height * 3);
+    file.read(reinterpret_cast<char*>(pixels.data()), pixels.size());
+    return file.good();
+}
+
+/***********************************************************
+ *  WritePPM()
+ *
+ *  This method is used for writing a binary PPM image.
+ ***********************************************************/
+bool GoldenImageHarness::WritePPM(const std::string& filename, int width, int height, const std::vector<unsigned char>& pixels)
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Could not write " << filename << ", does the directory exist?" << std::endl;
+        return false;
+    }
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+    return file.good();
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used for writing the result and the frame
+ *  time of every pose as JSON.
+ ***********************************************************/
+bool GoldenImageHarness::WriteReport(const char* filename) const
+{
+    std::ofstream file(filename);
+    if (!file)
+    {
+        std::cout << "Could not write the golden image report to " << filename << std::endl;
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(4);
+    file << "{\n  \"tolerance_percent\": " << m_tolerancePercent << ",\n  \"poses\": [\n";
+    for (size_t i = 0; i < m_results.size(); i++)
+    {
+        const GOLDEN_RESULT& result = m_results[i];
+        file << "    {\"name\": \"" << result.name << "\", \"result\": \""
+            << (result.created ? "stored" : (result.passed ? "passed" : "failed"))
+            << "\", \"different_percent\": " << result.differentPercent
+            << std::setprecision(2) << ", \"max_delta\": " << result.maxDelta
+            << std::setprecision(4) << ", \"mean_ms\": " << result.meanMilliseconds
+            << "}" << ((i + 1 < m_results.size()) ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    return file.good();
+}
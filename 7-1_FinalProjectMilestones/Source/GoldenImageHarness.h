@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////
+// goldenimageharness.h
+// ============
+// render the scene offscreen from fixed camera poses, compare every image
+// to a stored golden image and time each pose
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+
+// GOLDEN_POSE structure - a camera pose the scene is checked from
+struct GOLDEN_POSE
+{
+    const char* name;
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+// GOLDEN_RESULT structure - outcome of one pose with one render path
+struct GOLDEN_RESULT
+{
+    std::string name;
+    bool created;          // no golden image existed, the image became it
+    bool passed;
+    float differentPercent; // pixels that differ visibly
+    float maxDelta;         // largest color difference, in CIE Lab units
+    float meanMilliseconds;
+
+    GOLDEN_RESULT() : name(""), created(false), passed(false), differentPercent(0.0f), maxDelta(0.0f), meanMilliseconds(0.0f) {}
+};
+
+class GoldenImageHarness
+{
+public:
+    // constructor
+    GoldenImageHarness(SceneManager* pSceneManager, ViewManager* pViewManager);
+    // destructor
+    ~GoldenImageHarness();
+
+    // percent of the pixels allowed to differ visibly before a pose fails
+    void SetTolerance(float percent) { m_tolerancePercent = percent; }
+
+    // render every pose with every render path and compare it to the
+    // golden images in the passed in directory, or replace them when
+    // updating, returns true when no pose failed
+    bool Run(const char* directory, bool updateGoldens);
+
+private:
+    bool CreateTarget(int width, int height);
+    // render the current pose and return the mean frame time
+    float RenderPose(int frameCount);
+    void ReadImage(std::vector<unsigned char>& pixels) const;
+    GOLDEN_RESULT CheckPose(const std::string& path, const std::vector<unsigned char>& pixels, std::vector<unsigned char>& diffPixels) const;
+    bool WriteReport(const char* filename) const;
+
+    static bool ReadPPM(const std::string& filename, int& width, int& height, std::vector<unsigned char>& pixels);
+    static bool WritePPM(const std::string& filename, int width, int height, const std::vector<unsigned char>& pixels);
+    static glm::vec3 ToLab(const unsigned char* rgb);
+
+    SceneManager* m_pSceneManager;
+    ViewManager* m_pViewManager;
+    float m_tolerancePercent;
+    std::vector<GOLDEN_RESULT> m_results;
+
+    GLuint m_framebuffer;
+    GLuint m_colorRenderbuffer;
+    GLuint m_depthRenderbuffer;
+    int m_width;
+    int m_height;
+};
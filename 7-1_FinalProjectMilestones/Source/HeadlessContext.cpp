@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////////////
+// headlesscontext.cpp
+// ============
+// create an OpenGL context without a window or display through EGL on
+// Linux, or behind a hidden GLFW window elsewhere, and an offscreen
+// framebuffer for the frames to go to
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "HeadlessContext.h"
+#include "GLStateCache.h"
+
+#include <iostream>
+
+#ifdef __linux__
+// keep the X11 headers out, there is no display to talk to
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#else
+#include <GLFW/glfw3.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+    // context versions tried in order, the shaders need 4.4, newer
+    // versions are taken when the driver offers them
+    const int g_ContextVersions[][2] = { { 4, 6 }, { 4, 5 }, { 4, 4 } };
+}
+
+/***********************************************************
+ *  HeadlessContext()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+HeadlessContext::HeadlessContext()
+    : m_display(NULL), m_context(NULL), m_window(NULL), m_framebuffer(0), m_colorRenderbuffer(0), m_depthRenderbuffer(0),
+    m_width(0), m_height(0)
+{
+}
+
+/***********************************************************
+ *  ~HeadlessContext()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+HeadlessContext::~HeadlessContext()
+{
+    if (m_framebuffer != 0)
+    {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        glDeleteRenderbuffers(1, &m_colorRenderbuffer);
+        glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+    }
+
+#ifdef __linux__
+    if (m_display != NULL)
+    {
+        EGLDisplay display = static_cast<EGLDisplay>(m_display);
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_context != NULL)
+            eglDestroyContext(display, static_cast<EGLContext>(m_context));
+        eglTerminate(display);
+    }
+#else
+    if (m_window != NULL)
+        glfwDestroyWindow(m_window);
+#endif
+    m_display = NULL;
+    m_context = NULL;
+    m_window = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating a core profile context
+ *  that draws without any surface.  The Mesa surfaceless
+ *  platform is used when it exists, which needs neither a
+ *  display nor a GPU, llvmpipe renders on the CPU.  Other
+ *  systems have no EGL, so the context comes from a window
+ *  that is never shown, and only its context is used.
+ ***********************************************************/
+bool HeadlessContext::Create()
+{
+#ifdef __linux__
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay != NULL)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+#endif
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0;
+    EGLint minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        std::cout << "Failed to initialize an EGL display" << std::endl;
+        return false;
+    }
+    m_display = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cout << "EGL does not support desktop OpenGL" << std::endl;
+        return false;
+    }
+
+    // the context never draws to a surface, but a config is still
+    // needed on drivers without EGL_KHR_no_config_context
+    const EGLint configAttributes[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = NULL;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+    {
+        std::cout << "No EGL config supports desktop OpenGL" << std::endl;
+        return false;
+    }
+
+    EGLContext context = EGL_NO_CONTEXT;
+    for (const int* version : g_ContextVersions)
+    {
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, version[0],
+            EGL_CONTEXT_MINOR_VERSION, version[1],
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+        if (context != EGL_NO_CONTEXT)
+            break;
+    }
+    if (context == EGL_NO_CONTEXT)
+    {
+        std::cout << "Failed to create an OpenGL 4.4 core context through EGL" << std::endl;
+        return false;
+    }
+    m_context = context;
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        std::cout << "Failed to make the surfaceless EGL context current" << std::endl;
+        return false;
+    }
+
+    std::cout << "INFO: Headless EGL " << major << "." << minor << " context created" << std::endl;
+    return true;
+#else
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow* window = NULL;
+    for (const int* version : g_ContextVersions)
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+        // the window is never drawn to, so its size does not matter
+        window = glfwCreateWindow(1, 1, "Headless", NULL, NULL);
+        if (window != NULL)
+            break;
+    }
+    if (window == NULL)
+    {
+        std::cout << "Failed to create an OpenGL 4.4 core context behind a hidden window" << std::endl;
+        return false;
+    }
+    m_window = window;
+    glfwMakeContextCurrent(window);
+
+    std::cout << "INFO: Headless context created behind a hidden window" << std::endl;
+    return true;
+#endif
+}
+
+/***********************************************************
+ *  CreateTarget()
+ *
+ *  This method is used for creating the framebuffer the
+ *  frames are drawn into, which takes the place of the
+ *  window's default framebuffer.
+ ***********************************************************/
+bool HeadlessContext::CreateTarget(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+
+    glGenRenderbuffers(1, &m_colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &m_depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+    GLStateCache* stateCache = GLStateCache::Get();
+    glGenFramebuffers(1, &m_framebuffer);
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Headless framebuffer is incomplete at " << width << "x" << height << std::endl;
+        return false;
+    }
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for directing the frame into the
+ *  offscreen framebuffer.
+ ***********************************************************/
+void HeadlessContext::BeginFrame()
+{
+    GLStateCache::Get()->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_width, m_height);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for waiting until the frame has been
+ *  drawn.
+ ***********************************************************/
+void HeadlessContext::EndFrame()
+{
+    glFinish();
+}
@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////
+// headlesscontext.h
+// ============
+// create an OpenGL context without a window or display through EGL on
+// Linux, or behind a hidden GLFW window elsewhere, and an offscreen
+// framebuffer for the frames to go to
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+struct GLFWwindow;
+
+class HeadlessContext
+{
+public:
+    // constructor
+    HeadlessContext();
+    // destructor
+    ~HeadlessContext();
+
+    // create a surfaceless EGL context on Linux, or a hidden window's
+    // context on other systems, and make it current, returns false
+    // when no context could be made
+    bool Create();
+
+    // create the offscreen framebuffer, needs the OpenGL functions
+    // to be loaded
+    bool CreateTarget(int width, int height);
+    GLuint GetFramebuffer() const { return m_framebuffer; }
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+
+    // bind the offscreen framebuffer with a full viewport
+    void BeginFrame();
+    // wait for the frame to finish, there is no swap to do it, so the
+    // frame's time includes its GPU work
+    void EndFrame();
+
+private:
+    // EGL handles, kept as plain pointers so users of the class do
+    // not need the EGL headers
+    void* m_display;
+    void* m_context;
+    // the hidden window that owns the context where EGL is not used
+    GLFWwindow* m_window;
+
+    GLuint m_framebuffer;
+    GLuint m_colorRenderbuffer;
+    GLuint m_depthRenderbuffer;
+    int m_width;
+    int m_height;
+};
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputeventqueue.cpp
+// ============
+// pass timestamped input events from the window callbacks to the update
+// stage through a lock-free single producer, single consumer ring
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "InputEventQueue.h"
+
+// the positions wrap with a mask instead of a division
+static_assert((InputEventQueue::CAPACITY & (InputEventQueue::CAPACITY - 1)) == 0,
+    "the input event ring capacity must be a power of two");
+
+/***********************************************************
+ *  InputEventQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InputEventQueue::InputEventQueue()
+    : m_head(0), m_dropped(0), m_tail(0)
+{
+}
+
+/***********************************************************
+ *  Push()
+ *
+ *  This method is used for adding an event behind the ones
+ *  already waiting.  The event is written before the head is
+ *  moved past it with release ordering, so the consumer never
+ *  reads a slot that is still being written.
+ ***********************************************************/
+bool InputEventQueue::Push(const INPUT_EVENT& event)
+{
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    uint32_t tail = m_tail.load(std::memory_order_acquire);
+    if (head - tail == CAPACITY)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_events[head & (CAPACITY - 1)] = event;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+/***********************************************************
+ *  Drain()
+ *
+ *  This method is used for taking the oldest waiting events
+ *  out of the ring in one batch.  The slots are only handed
+ *  back to the producer, by moving the tail, after they have
+ *  been copied.
+ ***********************************************************/
+int InputEventQueue::Drain(INPUT_EVENT* events, int maxEvents)
+{
+    uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    uint32_t head = m_head.load(std::memory_order_acquire);
+
+    uint32_t count = head - tail;
+    if (count > static_cast<uint32_t>(maxEvents))
+        count = static_cast<uint32_t>(maxEvents);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        events[i] = m_events[(tail + i) & (CAPACITY - 1)];
+    }
+    m_tail.store(tail + count, std::memory_order_release);
+    return static_cast<int>(count);
+}
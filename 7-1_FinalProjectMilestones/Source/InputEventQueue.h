@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputeventqueue.h
+// ============
+// pass timestamped input events from the window callbacks to the update
+// stage through a lock-free single producer, single consumer ring
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// kinds of input event
+enum INPUT_EVENT_TYPE {
+    INPUT_MOUSE_MOVE,   // x and y hold the cursor position
+    INPUT_MOUSE_SCROLL, // x and y hold the scroll offsets
+    INPUT_KEY           // key and action hold the GLFW key and action
+};
+
+// INPUT_EVENT structure
+struct INPUT_EVENT
+{
+    INPUT_EVENT_TYPE type;
+    double time; // seconds, from glfwGetTime()
+    double x;
+    double y;
+    int key;
+    int action;
+
+    INPUT_EVENT()
+        : type(INPUT_MOUSE_MOVE), time(0.0), x(0.0), y(0.0), key(0), action(0) {}
+};
+
+class InputEventQueue
+{
+public:
+    // number of events the ring holds
+    static const uint32_t CAPACITY = 1024;
+
+    // constructor
+    InputEventQueue();
+
+    // add an event, returns false and drops it when the ring is full.
+    // Must only be called from the producing thread
+    bool Push(const INPUT_EVENT& event);
+
+    // copy up to maxEvents of the oldest events out of the ring and
+    // return how many.  Must only be called from the consuming thread
+    int Drain(INPUT_EVENT* events, int maxEvents);
+
+    // events dropped because the ring was full
+    uint32_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    // bytes in a cache line
+    static const size_t CACHE_LINE = 64;
+
+    INPUT_EVENT m_events[CAPACITY];
+    // the producer and consumer positions are padded a cache line
+    // apart, so the two threads do not keep stealing one line.  Padding
+    // is used over alignas, which would over-align the owning
+    // ViewManager, and new does not honor that before C++17
+    char m_eventsPadding[CACHE_LINE];
+    std::atomic<uint32_t> m_head; // next slot to write
+    std::atomic<uint32_t> m_dropped; // written by the producer too
+    char m_headPadding[CACHE_LINE - 2 * sizeof(std::atomic<uint32_t>)];
+    std::atomic<uint32_t> m_tail; // next slot to read
+    char m_tailPadding[CACHE_LINE - sizeof(std::atomic<uint32_t>)];
+};
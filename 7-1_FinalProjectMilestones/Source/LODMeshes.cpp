@@ -0,0 +1,611 @@
+///////////////////////////////////////////////////////////////////////////////
+// lodmeshes.cpp
+// ============
+// generate and draw level-of-detail chains for the basic 3D shapes
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "LODMeshes.h"
+#include "MeshOptimizer.h"
+#include "RenderCounters.h"
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+
+// declaration of global variables
+namespace
+{
+    // floats per vertex - position (3), normal (3), texture coordinate (2)
+    const int g_FloatsPerVertex = 8;
+
+    // tessellation used for each detail level, finest first
+    const int g_CylinderSlices[LOD_LEVEL_COUNT] = { 36, 20, 12, 6 };
+    const int g_ConeSlices[LOD_LEVEL_COUNT] = { 36, 20, 12, 6 };
+    const int g_SphereSlices[LOD_LEVEL_COUNT] = { 36, 20, 12, 8 };
+    const int g_SphereStacks[LOD_LEVEL_COUNT] = { 18, 10, 6, 4 };
+
+    // smallest projected diameter, in pixels, that keeps an object at
+    // each level - anything smaller than the last entry uses the
+    // coarsest level
+    const float g_LODSwitchSizes[LOD_LEVEL_COUNT - 1] = { 160.0f, 64.0f, 24.0f };
+    // fraction of a switch size an object has to move past before the
+    // level changes, so objects near a boundary do not pop back and forth
+    const float g_LODHysteresis = 0.15f;
+
+    // PACKED_VERTEX structure - the 16 byte packed vertex layout
+    struct PACKED_VERTEX
+    {
+        GLshort position[4]; // snorm16, the fourth value only pads
+        GLuint normal; // GL_INT_2_10_10_10_REV
+        GLushort texCoord[2]; // unorm16
+    };
+
+    const float g_TwoPi = 6.28318530718f;
+    const float g_Pi = 3.14159265359f;
+
+    void AddVertex(std::vector<GLfloat>& vertices, glm::vec3 position, glm::vec3 normal, float u, float v)
+    {
+        vertices.push_back(position.x);
+        vertices.push_back(position.y);
+        vertices.push_back(position.z);
+        vertices.push_back(normal.x);
+        vertices.push_back(normal.y);
+        vertices.push_back(normal.z);
+        vertices.push_back(u);
+        vertices.push_back(v);
+    }
+
+    GLshort QuantizeSnorm16(float value)
+    {
+        value = glm::clamp(value, -1.0f, 1.0f);
+        return static_cast<GLshort>(lround(value * 32767.0f));
+    }
+
+    GLushort QuantizeUnorm16(float value)
+    {
+        value = glm::clamp(value, 0.0f, 1.0f);
+        return static_cast<GLushort>(lround(value * 65535.0f));
+    }
+
+    // pack a unit normal into three signed 10 bit fields
+    GLuint PackNormal(float x, float y, float z)
+    {
+        GLuint packed = 0;
+        const float components[3] = { x, y, z };
+        for (int i = 0; i < 3; i++)
+        {
+            int value = static_cast<int>(lround(glm::clamp(components[i], -1.0f, 1.0f) * 511.0f));
+            packed |= (static_cast<GLuint>(value) & 0x3FF) << (10 * i);
+        }
+        return packed;
+    }
+
+    // add a flat circular cap at the given height, facing up or down
+    void AddCap(int slices, float height, bool facingUp, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices)
+    {
+        GLuint center = static_cast<GLuint>(vertices.size() / g_FloatsPerVertex);
+        glm::vec3 normal(0.0f, facingUp ? 1.0f : -1.0f, 0.0f);
+
+        AddVertex(vertices, glm::vec3(0.0f, height, 0.0f), normal, 0.5f, 0.5f);
+        for (int i = 0; i <= slices; i++)
+        {
+            float angle = g_TwoPi * i / slices;
+            float x = cos(angle);
+            float z = sin(angle);
+            AddVertex(vertices, glm::vec3(x, height, z), normal, 0.5f + 0.5f * x, 0.5f + 0.5f * z);
+        }
+
+        for (int i = 0; i < slices; i++)
+        {
+            GLuint ring = center + 1 + i;
+            indices.push_back(center);
+            if (facingUp)
+            {
+                indices.push_back(ring + 1);
+                indices.push_back(ring);
+            }
+            else
+            {
+                indices.push_back(ring);
+                indices.push_back(ring + 1);
+            }
+        }
+    }
+}
+
+/***********************************************************
+ *  LODMeshes()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LODMeshes::LODMeshes(LOD_VertexFormat vertexFormat)
+    : m_vertexFormat(vertexFormat)
+{
+}
+
+/***********************************************************
+ *  ~LODMeshes()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LODMeshes::~LODMeshes()
+{
+    for (int shape = 0; shape < LOD_SHAPE_COUNT; shape++)
+    {
+        for (int level = 0; level < LOD_LEVEL_COUNT; level++)
+        {
+            LOD_MESH& mesh = m_meshes[shape][level];
+            if (mesh.vao != 0)
+            {
+                glDeleteVertexArrays(1, &mesh.vao);
+                glDeleteBuffers(1, &mesh.vbo);
+                glDeleteBuffers(1, &mesh.ebo);
+            }
+        }
+    }
+}
+
+/***********************************************************
+ *  LoadCylinderLODs()
+ *
+ *  This method is used for generating every detail level of
+ *  a cylinder with a radius of 1 and a height of 1, sitting
+ *  on the XZ plane.
+ ***********************************************************/
+void LODMeshes::LoadCylinderLODs()
+{
+    for (int level = 0; level < LOD_LEVEL_COUNT; level++)
+    {
+        std::vector<GLfloat> vertices;
+        std::vector<GLuint> indices;
+        BuildCylinder(g_CylinderSlices[level], vertices, indices);
+        OptimizeMesh("cylinder", level, vertices, indices);
+        UploadMesh(vertices, indices, m_meshes[LOD_CYLINDER][level]);
+    }
+}
+
+/***********************************************************
+ *  LoadConeLODs()
+ *
+ *  This method is used for generating every detail level of
+ *  a cone with a base radius of 1 and a height of 1, sitting
+ *  on the XZ plane.
+ ***********************************************************/
+void LODMeshes::LoadConeLODs()
+{
+    for (int level = 0; level < LOD_LEVEL_COUNT; level++)
+    {
+        std::vector<GLfloat> vertices;
+        std::vector<GLuint> indices;
+        BuildCone(g_ConeSlices[level], vertices, indices);
+        OptimizeMesh("cone", level, vertices, indices);
+        UploadMesh(vertices, indices, m_meshes[LOD_CONE][level]);
+    }
+}
+
+/***********************************************************
+ *  LoadSphereLODs()
+ *
+ *  This method is used for generating every detail level of
+ *  a sphere with a radius of 1 centered on the origin.
+ ***********************************************************/
+void LODMeshes::LoadSphereLODs()
+{
+    for (int level = 0; level < LOD_LEVEL_COUNT; level++)
+    {
+        std::vector<GLfloat> vertices;
+        std::vector<GLuint> indices;
+        BuildSphere(g_SphereSlices[level], g_SphereStacks[level], vertices, indices);
+        OptimizeMesh("sphere", level, vertices, indices);
+        UploadMesh(vertices, indices, m_meshes[LOD_SPHERE][level]);
+    }
+}
+
+/***********************************************************
+ *  DrawLODMesh()
+ *
+ *  This method is used for drawing one detail level of a
+ *  previously loaded shape.
+ ***********************************************************/
+void LODMeshes::DrawLODMesh(LOD_Shape shape, int level) const
+{
+    const LOD_MESH& mesh = m_meshes[shape][level];
+    if (mesh.vao == 0)
+        return;
+
+    glBindVertexArray(mesh.vao);
+    glDrawElements(GL_TRIANGLES, mesh.nIndices, mesh.indexType, (void*)0);
+    glBindVertexArray(0);
+
+    RenderCounters* counters = RenderCounters::Get();
+    counters->Add(COUNTER_DRAW_CALLS, 1);
+    counters->Add(COUNTER_TRIANGLES, mesh.nIndices / 3);
+}
+
+/***********************************************************
+ *  GetTriangleCount()
+ *
+ *  This method returns the number of triangles drawn for one
+ *  detail level of a shape.
+ ***********************************************************/
+int LODMeshes::GetTriangleCount(LOD_Shape shape, int level) const
+{
+    return m_meshes[shape][level].nIndices / 3;
+}
+
+/***********************************************************
+ *  ApplyPositionDequantization()
+ *
+ *  This method is used for turning a model matrix into one
+ *  that also expands the packed positions of a mesh back to
+ *  their original size and place.  The scale is uniform so the
+ *  normal matrix built from the model stays correct.
+ ***********************************************************/
+void LODMeshes::ApplyPositionDequantization(LOD_Shape shape, int level, glm::mat4& model) const
+{
+    if (m_vertexFormat != LOD_FORMAT_PACKED)
+        return;
+
+    const LOD_MESH& mesh = m_meshes[shape][level];
+
+    // model * translate(center) * scale(boundsScale), written out
+    model[3] = model[0] * mesh.boundsCenter.x + model[1] * mesh.boundsCenter.y +
+        model[2] * mesh.boundsCenter.z + model[3];
+    model[0] = model[0] * mesh.boundsScale;
+    model[1] = model[1] * mesh.boundsScale;
+    model[2] = model[2] * mesh.boundsScale;
+}
+
+/***********************************************************
+ *  GetBufferBytes()
+ *
+ *  This method returns the GPU memory used by the vertex and
+ *  index buffers of every loaded mesh.
+ ***********************************************************/
+GLsizeiptr LODMeshes::GetBufferBytes() const
+{
+    GLsizeiptr total = 0;
+    for (int shape = 0; shape < LOD_SHAPE_COUNT; shape++)
+    {
+        for (int level = 0; level < LOD_LEVEL_COUNT; level++)
+        {
+            total += m_meshes[shape][level].bufferBytes;
+        }
+    }
+    return total;
+}
+
+/***********************************************************
+ *  GetFloatFormatBytes()
+ *
+ *  This method returns the GPU memory the loaded meshes would
+ *  use with float vertices and 32 bit indices.
+ ***********************************************************/
+GLsizeiptr LODMeshes::GetFloatFormatBytes() const
+{
+    GLsizeiptr total = 0;
+    for (int shape = 0; shape < LOD_SHAPE_COUNT; shape++)
+    {
+        for (int level = 0; level < LOD_LEVEL_COUNT; level++)
+        {
+            const LOD_MESH& mesh = m_meshes[shape][level];
+            total += mesh.nVertices * sizeof(GLfloat) * g_FloatsPerVertex;
+            total += mesh.nIndices * sizeof(GLuint);
+        }
+    }
+    return total;
+}
+
+/***********************************************************
+ *  ProjectedScreenSize()
+ *
+ *  This method estimates how many pixels tall a bounding
+ *  sphere appears on screen.  pixelsPerUnit is the number of
+ *  pixels covered by one world unit at a distance of one.
+ ***********************************************************/
+float LODMeshes::ProjectedScreenSize(float radius, float distance, float pixelsPerUnit)
+{
+    // inside the bounding sphere the object covers the whole view
+    if (distance <= radius)
+        return 1.0e6f;
+
+    return (2.0f * radius * pixelsPerUnit) / distance;
+}
+
+/***********************************************************
+ *  SelectLODLevel()
+ *
+ *  This method is used for choosing the detail level for an
+ *  object from its projected size.  The level only changes
+ *  once the size has moved clearly past a switch size, so an
+ *  object sitting on a boundary keeps its current level.
+ ***********************************************************/
+int LODMeshes::SelectLODLevel(int currentLevel, float projectedSize)
+{
+    int level = currentLevel;
+    if (level < 0)
+        level = 0;
+    if (level > LOD_LEVEL_COUNT - 1)
+        level = LOD_LEVEL_COUNT - 1;
+
+    // move to finer levels while clearly larger than the next switch size
+    while (level > 0 && projectedSize > g_LODSwitchSizes[level - 1] * (1.0f + g_LODHysteresis))
+        level--;
+
+    // move to coarser levels while clearly smaller than this level allows
+    while (level < LOD_LEVEL_COUNT - 1 && projectedSize < g_LODSwitchSizes[level] * (1.0f - g_LODHysteresis))
+        level++;
+
+    return level;
+}
+
+/***********************************************************
+ *  BuildCylinder()
+ *
+ *  This method is used for generating the side wall and both
+ *  caps of a cylinder with the given number of slices.
+ ***********************************************************/
+void LODMeshes::BuildCylinder(int slices, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices)
+{
+    // side wall - one bottom and one top vertex per slice edge
+    for (int i = 0; i <= slices; i++)
+    {
+        float angle = g_TwoPi * i / slices;
+        glm::vec3 normal(cos(angle), 0.0f, sin(angle));
+        float u = static_cast<float>(i) / slices;
+
+        AddVertex(vertices, glm::vec3(normal.x, 0.0f, normal.z), normal, u, 0.0f);
+        AddVertex(vertices, glm::vec3(normal.x, 1.0f, normal.z), normal, u, 1.0f);
+    }
+
+    for (int i = 0; i < slices; i++)
+    {
+        GLuint bottom0 = 2 * i;
+        GLuint top0 = bottom0 + 1;
+        GLuint bottom1 = bottom0 + 2;
+        GLuint top1 = bottom0 + 3;
+
+        indices.push_back(bottom0);
+        indices.push_back(top0);
+        indices.push_back(bottom1);
+        indices.push_back(bottom1);
+        indices.push_back(top0);
+        indices.push_back(top1);
+    }
+
+    AddCap(slices, 1.0f, true, vertices, indices);
+    AddCap(slices, 0.0f, false, vertices, indices);
+}
+
+/***********************************************************
+ *  BuildCone()
+ *
+ *  This method is used for generating the sloped side and the
+ *  bottom cap of a cone with the given number of slices.
+ ***********************************************************/
+void LODMeshes::BuildCone(int slices, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices)
+{
+    // sloped side - every slice gets its own apex vertex so the
+    // normals stay smooth around the cone
+    for (int i = 0; i <= slices; i++)
+    {
+        float angle = g_TwoPi * i / slices;
+        float apexAngle = g_TwoPi * (i + 0.5f) / slices;
+        float u = static_cast<float>(i) / slices;
+
+        glm::vec3 baseNormal = glm::normalize(glm::vec3(cos(angle), 1.0f, sin(angle)));
+        glm::vec3 apexNormal = glm::normalize(glm::vec3(cos(apexAngle), 1.0f, sin(apexAngle)));
+
+        AddVertex(vertices, glm::vec3(cos(angle), 0.0f, sin(angle)), baseNormal, u, 0.0f);
+        AddVertex(vertices, glm::vec3(0.0f, 1.0f, 0.0f), apexNormal, u, 1.0f);
+    }
+
+    for (int i = 0; i < slices; i++)
+    {
+        GLuint base0 = 2 * i;
+        GLuint apex = base0 + 1;
+        GLuint base1 = base0 + 2;
+
+        indices.push_back(base0);
+        indices.push_back(apex);
+        indices.push_back(base1);
+    }
+
+    AddCap(slices, 0.0f, false, vertices, indices);
+}
+
+/***********************************************************
+ *  BuildSphere()
+ *
+ *  This method is used for generating a UV sphere with the
+ *  given number of slices and stacks.
+ ***********************************************************/
+void LODMeshes::BuildSphere(int slices, int stacks, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices)
+{
+    for (int stack = 0; stack <= stacks; stack++)
+    {
+        float phi = g_Pi * stack / stacks;
+        float y = cos(phi);
+        float ringRadius = sin(phi);
+
+        for (int slice = 0; slice <= slices; slice++)
+        {
+            float theta = g_TwoPi * slice / slices;
+            glm::vec3 position(ringRadius * cos(theta), y, ringRadius * sin(theta));
+
+            AddVertex(vertices, position, position,
+                static_cast<float>(slice) / slices,
+                1.0f - static_cast<float>(stack) / stacks);
+        }
+    }
+
+    for (int stack = 0; stack < stacks; stack++)
+    {
+        for (int slice = 0; slice < slices; slice++)
+        {
+            GLuint upper = stack * (slices + 1) + slice;
+            GLuint lower = upper + slices + 1;
+
+            // the triangles touching the poles collapse to a point
+            if (stack != 0)
+            {
+                indices.push_back(upper);
+                indices.push_back(upper + 1);
+                indices.push_back(lower);
+            }
+            if (stack != stacks - 1)
+            {
+                indices.push_back(upper + 1);
+                indices.push_back(lower + 1);
+                indices.push_back(lower);
+            }
+        }
+    }
+}
+
+/***********************************************************
+ *  OptimizeMesh()
+ *
+ *  This method is used for reordering a generated mesh for the
+ *  vertex cache, overdraw and vertex fetch before it is
+ *  uploaded, and printing the simulated cache results.
+ ***********************************************************/
+void LODMeshes::OptimizeMesh(const char* shapeName, int level, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices)
+{
+    MESH_OPTIMIZE_REPORT report = MeshOptimizer::OptimizeMesh(vertices, g_FloatsPerVertex, indices);
+
+    std::cout << "LODMeshes: " << shapeName << " level " << level
+        << " ACMR " << report.before.acmr << " -> " << report.after.acmr
+        << ", ATVR " << report.before.atvr << " -> " << report.after.atvr << std::endl;
+}
+
+/***********************************************************
+ *  UploadMesh()
+ *
+ *  This method is used for creating the vertex array and
+ *  buffers for a generated mesh.  The attributes use the same
+ *  locations as ShapeMeshes so the same shaders can draw both.
+ *  Indices are stored as 16 bit values whenever the vertex
+ *  count allows it.
+ ***********************************************************/
+void LODMeshes::UploadMesh(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices, LOD_MESH& mesh) const
+{
+    mesh.nVertices = static_cast<GLsizei>(vertices.size() / g_FloatsPerVertex);
+    mesh.nIndices = static_cast<GLsizei>(indices.size());
+
+    glGenVertexArrays(1, &mesh.vao);
+    glBindVertexArray(mesh.vao);
+
+    if (m_vertexFormat == LOD_FORMAT_PACKED)
+        UploadPackedVertices(vertices, mesh);
+    else
+        UploadFloatVertices(vertices, mesh);
+
+    glGenBuffers(1, &mesh.ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+
+    if (m_vertexFormat == LOD_FORMAT_PACKED && mesh.nVertices <= std::numeric_limits<GLushort>::max())
+    {
+        std::vector<GLushort> shortIndices(indices.begin(), indices.end());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(GLushort), shortIndices.data(), GL_STATIC_DRAW);
+        mesh.indexType = GL_UNSIGNED_SHORT;
+        mesh.bufferBytes += shortIndices.size() * sizeof(GLushort);
+    }
+    else
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        mesh.indexType = GL_UNSIGNED_INT;
+        mesh.bufferBytes += indices.size() * sizeof(GLuint);
+    }
+
+    glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  UploadFloatVertices()
+ *
+ *  This method is used for uploading the vertices with full
+ *  32 bit float attributes.
+ ***********************************************************/
+void LODMeshes::UploadFloatVertices(const std::vector<GLfloat>& vertices, LOD_MESH& mesh)
+{
+    const GLsizei stride = sizeof(GLfloat) * g_FloatsPerVertex;
+
+    glGenBuffers(1, &mesh.vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
+    mesh.bufferBytes = vertices.size() * sizeof(GLfloat);
+
+    // position
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    // normal
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(GLfloat) * 3));
+    glEnableVertexAttribArray(1);
+    // texture coordinate
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(GLfloat) * 6));
+    glEnableVertexAttribArray(2);
+}
+
+/***********************************************************
+ *  UploadPackedVertices()
+ *
+ *  This method is used for quantizing the vertices into the
+ *  16 byte packed layout and uploading them.  Positions are
+ *  stored relative to the mesh bounds, which are kept in the
+ *  mesh so ApplyPositionDequantization() can undo it.
+ ***********************************************************/
+void LODMeshes::UploadPackedVertices(const std::vector<GLfloat>& vertices, LOD_MESH& mesh)
+{
+    // find the bounds of the positions
+    glm::vec3 minimum(std::numeric_limits<float>::max());
+    glm::vec3 maximum(-std::numeric_limits<float>::max());
+    for (size_t i = 0; i < vertices.size(); i += g_FloatsPerVertex)
+    {
+        glm::vec3 position(vertices[i], vertices[i + 1], vertices[i + 2]);
+        minimum = glm::min(minimum, position);
+        maximum = glm::max(maximum, position);
+    }
+
+    glm::vec3 halfExtent = 0.5f * (maximum - minimum);
+    mesh.boundsCenter = 0.5f * (minimum + maximum);
+    mesh.boundsScale = glm::max(halfExtent.x, glm::max(halfExtent.y, halfExtent.z));
+    if (mesh.boundsScale <= 0.0f)
+        mesh.boundsScale = 1.0f;
+
+    std::vector<PACKED_VERTEX> packed(mesh.nVertices);
+    for (GLsizei v = 0; v < mesh.nVertices; v++)
+    {
+        const GLfloat* source = &vertices[v * g_FloatsPerVertex];
+        PACKED_VERTEX& target = packed[v];
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            target.position[axis] = QuantizeSnorm16((source[axis] - mesh.boundsCenter[axis]) / mesh.boundsScale);
+        }
+        target.position[3] = 0;
+        target.normal = PackNormal(source[3], source[4], source[5]);
+        target.texCoord[0] = QuantizeUnorm16(source[6]);
+        target.texCoord[1] = QuantizeUnorm16(source[7]);
+    }
+
+    const GLsizei stride = sizeof(PACKED_VERTEX);
+
+    glGenBuffers(1, &mesh.vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(PACKED_VERTEX), packed.data(), GL_STATIC_DRAW);
+    mesh.bufferBytes = packed.size() * sizeof(PACKED_VERTEX);
+
+    // position - normalized to [-1, 1]
+    glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, stride, (void*)offsetof(PACKED_VERTEX, position));
+    glEnableVertexAttribArray(0);
+    // normal - the shader reads the first three components
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)offsetof(PACKED_VERTEX, normal));
+    glEnableVertexAttribArray(1);
+    // texture coordinate - normalized to [0, 1]
+    glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(PACKED_VERTEX, texCoord));
+    glEnableVertexAttribArray(2);
+}
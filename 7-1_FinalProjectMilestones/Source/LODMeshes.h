@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+// lodmeshes.h
+// ============
+// generate and draw level-of-detail chains for the basic 3D shapes
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+// number of detail levels generated for every shape, 0 is the finest
+const int LOD_LEVEL_COUNT = 4;
+
+// vertex layouts the meshes can be uploaded with
+enum LOD_VertexFormat {
+    // 32 bytes - float position, normal and texture coordinate
+    LOD_FORMAT_FLOAT,
+    // 16 bytes - snorm16 position scaled to the mesh bounds,
+    // 2_10_10_10 normal and unorm16 texture coordinate
+    LOD_FORMAT_PACKED
+};
+
+// shapes that have a generated level-of-detail chain
+enum LOD_Shape {
+    LOD_CYLINDER,
+    LOD_CONE,
+    LOD_SPHERE,
+    LOD_SHAPE_COUNT
+};
+
+// LOD_MESH structure - the GPU buffers for one detail level
+struct LOD_MESH
+{
+    GLuint vao;
+    GLuint vbo;
+    GLuint ebo;
+    GLsizei nVertices;
+    GLsizei nIndices;
+    GLenum indexType;
+    GLsizeiptr bufferBytes;
+    // packed positions are stored as (position - center) / scale
+    glm::vec3 boundsCenter;
+    float boundsScale;
+
+    LOD_MESH() : vao(0), vbo(0), ebo(0), nVertices(0), nIndices(0), indexType(GL_UNSIGNED_INT),
+        bufferBytes(0), boundsCenter(0.0f), boundsScale(1.0f) {}
+};
+
+class LODMeshes
+{
+public:
+    // constructor
+    LODMeshes(LOD_VertexFormat vertexFormat = LOD_FORMAT_PACKED);
+    // destructor
+    ~LODMeshes();
+
+    // generate every detail level for the matching shape, the
+    // shapes use the same unit dimensions as ShapeMeshes
+    void LoadCylinderLODs();
+    void LoadConeLODs();
+    void LoadSphereLODs();
+
+    // draw the requested detail level of a loaded shape
+    void DrawLODMesh(LOD_Shape shape, int level) const;
+
+    // number of triangles in the requested detail level
+    int GetTriangleCount(LOD_Shape shape, int level) const;
+
+    // fold the position dequantization of a packed mesh into its
+    // model matrix, does nothing for the float format
+    void ApplyPositionDequantization(LOD_Shape shape, int level, glm::mat4& model) const;
+
+    // GPU memory used by all loaded vertex and index buffers
+    GLsizeiptr GetBufferBytes() const;
+    // memory the same meshes would use with the float format
+    GLsizeiptr GetFloatFormatBytes() const;
+
+    // estimate the on-screen diameter in pixels of a bounding sphere
+    static float ProjectedScreenSize(float radius, float distance, float pixelsPerUnit);
+    // pick the detail level for an object, keeping the current level
+    // while the projected size stays inside the hysteresis band
+    static int SelectLODLevel(int currentLevel, float projectedSize);
+
+private:
+    // build the vertex and index lists for one tessellation
+    static void BuildCylinder(int slices, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices);
+    static void BuildCone(int slices, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices);
+    static void BuildSphere(int slices, int stacks, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices);
+
+    // reorder the generated data for the GPU before uploading it
+    static void OptimizeMesh(const char* shapeName, int level, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices);
+
+    // copy the generated data into new GPU buffers
+    void UploadMesh(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices, LOD_MESH& mesh) const;
+    static void UploadFloatVertices(const std::vector<GLfloat>& vertices, LOD_MESH& mesh);
+    static void UploadPackedVertices(const std::vector<GLfloat>& vertices, LOD_MESH& mesh);
+
+    LOD_VertexFormat m_vertexFormat;
+    LOD_MESH m_meshes[LOD_SHAPE_COUNT][LOD_LEVEL_COUNT];
+};
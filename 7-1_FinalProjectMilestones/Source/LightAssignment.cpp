@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightassignment.cpp
+// ============
+// sort the lights with a radius into a grid over the XZ plane and find
+// the few lights that reach each object
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "LightAssignment.h"
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+    // world size of one grid cell on X and Z
+    const float g_CellSize = 8.0f;
+    // lights covering more cells than this across are tested by
+    // every query instead of being listed in all of them
+    const int g_MaxCellSpan = 16;
+}
+
+/***********************************************************
+ *  LightAssignment()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightAssignment::LightAssignment()
+    : m_cellSize(g_CellSize)
+{
+}
+
+/***********************************************************
+ *  GetCell()
+ *
+ *  This method returns the grid cell of a world coordinate.
+ ***********************************************************/
+int LightAssignment::GetCell(float coordinate) const
+{
+    return static_cast<int>(floor(coordinate / m_cellSize));
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for listing every light with a radius
+ *  in the cells its sphere covers on the XZ plane.  The lists
+ *  keep their memory from frame to frame.
+ ***********************************************************/
+void LightAssignment::Build(const std::vector<LIGHT_SOURCE>& lights)
+{
+    m_lightSpheres.resize(lights.size());
+    m_entries.clear();
+    m_largeLights.clear();
+
+    for (size_t i = 0; i < lights.size(); i++)
+    {
+        const LIGHT_SOURCE& light = lights[i];
+        m_lightSpheres[i] = glm::vec4(light.position, std::max(light.radius, 0.0f));
+        if (light.radius <= 0.0f)
+            continue;
+
+        int minX = GetCell(light.position.x - light.radius);
+        int maxX = GetCell(light.position.x + light.radius);
+        int minZ = GetCell(light.position.z - light.radius);
+        int maxZ = GetCell(light.position.z + light.radius);
+        if (maxX - minX >= g_MaxCellSpan || maxZ - minZ >= g_MaxCellSpan)
+        {
+            m_largeLights.push_back(static_cast<int>(i));
+            continue;
+        }
+
+        for (int x = minX; x <= maxX; x++)
+        {
+            for (int z = minZ; z <= maxZ; z++)
+            {
+                CELL_ENTRY entry;
+                entry.cell = GetCellKey(x, z);
+                entry.light = static_cast<int>(i);
+                m_entries.push_back(entry);
+            }
+        }
+    }
+
+    std::sort(m_entries.begin(), m_entries.end());
+}
+
+/***********************************************************
+ *  Consider()
+ *
+ *  This method is used for adding a light to the best lights
+ *  found so far, which stay sorted by score.  A light that is
+ *  already listed, because it was found in another cell, is
+ *  not added twice.
+ ***********************************************************/
+void LightAssignment::Consider(int light, float score, int lightIndices[MAX_DRAW_LIGHTS], float scores[MAX_DRAW_LIGHTS], int& count, int& reaching)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (lightIndices[i] == light)
+            return;
+    }
+    reaching++;
+
+    if (count == MAX_DRAW_LIGHTS && score >= scores[count - 1])
+        return;
+
+    int slot = (count < MAX_DRAW_LIGHTS) ? count++ : count - 1;
+    while (slot > 0 && scores[slot - 1] > score)
+    {
+        lightIndices[slot] = lightIndices[slot - 1];
+        scores[slot] = scores[slot - 1];
+        slot--;
+    }
+    lightIndices[slot] = light;
+    scores[slot] = score;
+}
+
+/***********************************************************
+ *  Query()
+ *
+ *  This method is used for finding the lights whose sphere
+ *  overlaps the passed in bounding sphere.  When more than
+ *  MAX_DRAW_LIGHTS reach it, the ones with the object deepest
+ *  inside their radius are kept, since they are the brightest,
+ *  and the count returned is above MAX_DRAW_LIGHTS to tell
+ *  the caller the list is not complete.
+ ***********************************************************/
+int LightAssignment::Query(glm::vec3 center, float radius, int lightIndices[MAX_DRAW_LIGHTS]) const
+{
+    float scores[MAX_DRAW_LIGHTS];
+    int count = 0;
+    int reaching = 0;
+
+    int minX = GetCell(center.x - radius);
+    int maxX = GetCell(center.x + radius);
+    int minZ = GetCell(center.z - radius);
+    int maxZ = GetCell(center.z + radius);
+
+    for (int x = minX; x <= maxX; x++)
+    {
+        for (int z = minZ; z <= maxZ; z++)
+        {
+            CELL_ENTRY key;
+            key.cell = GetCellKey(x, z);
+            key.light = 0;
+            auto range = std::equal_range(m_entries.begin(), m_entries.end(), key);
+            for (auto entry = range.first; entry != range.second; ++entry)
+            {
+                const glm::vec4& sphere = m_lightSpheres[entry->light];
+                float distance = glm::length(glm::vec3(sphere) - center);
+                if (distance < sphere.w + radius)
+                    Consider(entry->light, distance / sphere.w, lightIndices, scores, count, reaching);
+            }
+        }
+    }
+
+    for (int light : m_largeLights)
+    {
+        const glm::vec4& sphere = m_lightSpheres[light];
+        float distance = glm::length(glm::vec3(sphere) - center);
+        if (distance < sphere.w + radius)
+            Consider(light, distance / sphere.w, lightIndices, scores, count, reaching);
+    }
+
+    return reaching;
+}
@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightassignment.h
+// ============
+// sort the lights with a radius into a grid over the XZ plane and find
+// the few lights that reach each object
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "ClusteredLighting.h"
+#include "PerDrawBuffer.h"
+
+class LightAssignment
+{
+public:
+    // constructor
+    LightAssignment();
+
+    // sort the lights with a radius into the grid cells they reach,
+    // the lights without one reach everything and are left out
+    void Build(const std::vector<LIGHT_SOURCE>& lights);
+
+    // find up to MAX_DRAW_LIGHTS lights that reach a bounding sphere,
+    // the closest for their radius first, and return how many were
+    // found, which is above MAX_DRAW_LIGHTS when they did not all fit
+    int Query(glm::vec3 center, float radius, int lightIndices[MAX_DRAW_LIGHTS]) const;
+
+private:
+    // CELL_ENTRY structure - one light in one grid cell
+    struct CELL_ENTRY
+    {
+        int64_t cell;
+        int light;
+
+        bool operator<(const CELL_ENTRY& other) const { return cell < other.cell; }
+    };
+
+    int64_t GetCellKey(int x, int z) const { return (static_cast<int64_t>(x) << 32) ^ static_cast<uint32_t>(z); }
+    int GetCell(float coordinate) const;
+    // keep a light in the sorted list of the best ones found so far,
+    // counting the lights that are not listed yet
+    static void Consider(int light, float score, int lightIndices[MAX_DRAW_LIGHTS], float scores[MAX_DRAW_LIGHTS], int& count, int& reaching);
+
+    float m_cellSize;
+    // position and radius of every scene light, 0 radius for skipped lights
+    std::vector<glm::vec4> m_lightSpheres;
+    // sorted by cell, so a cell's lights are found with a binary search
+    std::vector<CELL_ENTRY> m_entries;
+    // lights too large to list in every cell they cover
+    std::vector<int> m_largeLights;
+};
@@ -0,0 +1,544 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightmapbaker.cpp
+// ============
+// bake the direct and bounced lighting of the static surfaces into a
+// lightmap on all CPU cores, and cache the result in a file
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "LightmapBaker.h"
+#include "GLStateCache.h"
+#include "RenderCounters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+// declaration of global variables
+namespace
+{
+    // lightmap texels per world unit and largest lightmap side
+    const float g_TexelsPerUnit = 8.0f;
+    const int g_MaxLightmapSize = 2048;
+    // bounce rays traced from every texel
+    const int g_IndirectSamples = 64;
+    // offset of secondary rays off the surface they start on
+    const float g_RayOffset = 0.001f;
+
+    // the cache is rebuilt when the format changes
+    const char g_CacheMagic[4] = { 'L', 'M', 'A', 'P' };
+    const uint32_t g_CacheVersion = 1;
+
+    const char* g_LightmapName = "lightmap";
+    const char* g_LightmapBoundsName = "lightmapBounds";
+    const char* g_LightmapLightIndexName = "lightmapLightIndex";
+
+    const float g_Pi = 3.14159265358979f;
+
+    /***********************************************************
+     *  HashBytes()
+     *
+     *  This method is used for adding bytes to an FNV-1a hash.
+     ***********************************************************/
+    void HashBytes(uint64_t& hash, const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+
+    void HashVector(uint64_t& hash, glm::vec3 value)
+    {
+        HashBytes(hash, &value.x, sizeof(float));
+        HashBytes(hash, &value.y, sizeof(float));
+        HashBytes(hash, &value.z, sizeof(float));
+    }
+
+    /***********************************************************
+     *  NextRandom()
+     *
+     *  This method is used for stepping a xorshift generator and
+     *  returning a value in [0, 1).  Every texel seeds its own
+     *  generator, so a bake gives the same result on any number
+     *  of threads.
+     ***********************************************************/
+    float NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+/***********************************************************
+ *  LightmapBaker()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightmapBaker::LightmapBaker()
+    : m_materialDiffuse(1.0f), m_separateLightIndex(-1), m_boundsMin(0.0f), m_boundsSize(1.0f),
+    m_topHeight(0.0f), m_width(0), m_height(0), m_nextRow(0), m_texture(0)
+{
+}
+
+/***********************************************************
+ *  ~LightmapBaker()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LightmapBaker::~LightmapBaker()
+{
+    if (m_texture != 0)
+    {
+        GLStateCache::Get()->NotifyTextureDeleted(m_texture);
+        glDeleteTextures(1, &m_texture);
+        m_texture = 0;
+    }
+}
+
+/***********************************************************
+ *  AddSurface()
+ *
+ *  This method is used for adding a static surface to the
+ *  baked scene.
+ ***********************************************************/
+void LightmapBaker::AddSurface(const BAKE_SURFACE& surface)
+{
+    m_surfaces.push_back(surface);
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for getting the lightmap of the added
+ *  surfaces ready for rendering.  The static surfaces are all
+ *  seen from above, so one lightmap laid over the XZ plane
+ *  holds the lighting of the highest surface at every texel.
+ ***********************************************************/
+bool LightmapBaker::Build(const std::vector<LIGHT_SOURCE>& lights, glm::vec3 materialDiffuse, int separateLightIndex, const char* cacheFile)
+{
+    if (m_surfaces.empty())
+        return false;
+
+    m_lights = lights;
+    m_materialDiffuse = materialDiffuse;
+    m_separateLightIndex = separateLightIndex;
+
+    // the area covered by the surfaces
+    glm::vec2 boundsMin(1.0e30f);
+    glm::vec2 boundsMax(-1.0e30f);
+    m_topHeight = -1.0e30f;
+    for (const auto& surface : m_surfaces)
+    {
+        boundsMin.x = std::min(boundsMin.x, surface.position.x - surface.scale.x);
+        boundsMin.y = std::min(boundsMin.y, surface.position.z - surface.scale.z);
+        boundsMax.x = std::max(boundsMax.x, surface.position.x + surface.scale.x);
+        boundsMax.y = std::max(boundsMax.y, surface.position.z + surface.scale.z);
+        float top = surface.position.y + (surface.shape == BAKE_CONE ? surface.scale.y : 0.0f);
+        m_topHeight = std::max(m_topHeight, top + 1.0f);
+    }
+    m_width = std::min(static_cast<int>(ceil((boundsMax.x - boundsMin.x) * g_TexelsPerUnit)), g_MaxLightmapSize);
+    m_height = std::min(static_cast<int>(ceil((boundsMax.y - boundsMin.y) * g_TexelsPerUnit)), g_MaxLightmapSize);
+    m_boundsMin = boundsMin;
+    m_boundsSize = boundsMax - boundsMin;
+
+    uint64_t hash = HashInputs();
+    if (!LoadCache(cacheFile, hash))
+    {
+        m_texels.assign(static_cast<size_t>(m_width) * m_height * 4, 0.0f);
+
+        auto start = std::chrono::steady_clock::now();
+
+        // the rows are handed out one at a time, so threads that get
+        // cheap rows simply take more of them
+        unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+        m_nextRow = 0;
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < threadCount; i++)
+        {
+            threads.push_back(std::thread(&LightmapBaker::BakeRows, this));
+        }
+        BakeRows();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Baked " << m_width << "x" << m_height << " lightmap on " << threadCount
+            << " threads in " << milliseconds << " ms" << std::endl;
+
+        WriteCache(cacheFile, hash);
+    }
+    else
+    {
+        std::cout << "Loaded " << m_width << "x" << m_height << " lightmap from " << cacheFile << std::endl;
+    }
+
+    Upload();
+    // the texels are on the GPU now
+    std::vector<float>().swap(m_texels);
+    return true;
+}
+
+/***********************************************************
+ *  Trace()
+ *
+ *  This method is used for finding the closest surface hit
+ *  by a ray.  Planes are only hit from above, and cones only
+ *  on their sides, since their base rests on the ground.
+ ***********************************************************/
+bool LightmapBaker::Trace(glm::vec3 origin, glm::vec3 direction, float maxDistance, HIT& hit) const
+{
+    hit.distance = maxDistance;
+    hit.surface = -1;
+
+    for (size_t i = 0; i < m_surfaces.size(); i++)
+    {
+        const BAKE_SURFACE& surface = m_surfaces[i];
+
+        if (surface.shape == BAKE_PLANE)
+        {
+            if (direction.y >= 0.0f || origin.y <= surface.position.y)
+                continue;
+
+            float t = (surface.position.y - origin.y) / direction.y;
+            if (t <= 0.0f || t >= hit.distance)
+                continue;
+
+            glm::vec3 point = origin + direction * t;
+            if (fabs(point.x - surface.position.x) > surface.scale.x || fabs(point.z - surface.position.z) > surface.scale.z)
+                continue;
+
+            hit.distance = t;
+            hit.position = point;
+            hit.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            hit.surface = static_cast<int>(i);
+        }
+        else
+        {
+            // x^2 + z^2 = (k * (apex - y))^2 around the cone axis
+            float radius = std::max(surface.scale.x, surface.scale.z);
+            float k = radius / surface.scale.y;
+            float apex = surface.position.y + surface.scale.y;
+            float ox = origin.x - surface.position.x;
+            float oz = origin.z - surface.position.z;
+            float oy = apex - origin.y;
+            float k2 = k * k;
+
+            float a = direction.x * direction.x + direction.z * direction.z - k2 * direction.y * direction.y;
+            float b = 2.0f * (ox * direction.x + oz * direction.z + k2 * oy * direction.y);
+            float c = ox * ox + oz * oz - k2 * oy * oy;
+
+            float roots[2];
+            int rootCount = 0;
+            if (fabs(a) < 1.0e-8f)
+            {
+                if (fabs(b) < 1.0e-8f)
+                    continue;
+                roots[rootCount++] = -c / b;
+            }
+            else
+            {
+                float discriminant = b * b - 4.0f * a * c;
+                if (discriminant < 0.0f)
+                    continue;
+                float root = sqrt(discriminant);
+                roots[rootCount++] = (-b - root) / (2.0f * a);
+                roots[rootCount++] = (-b + root) / (2.0f * a);
+                if (roots[0] > roots[1])
+                    std::swap(roots[0], roots[1]);
+            }
+
+            for (int r = 0; r < rootCount; r++)
+            {
+                float t = roots[r];
+                if (t <= 0.0f || t >= hit.distance)
+                    continue;
+
+                // the equation also holds on the mirrored cone above the apex
+                glm::vec3 point = origin + direction * t;
+                if (point.y < surface.position.y || point.y > apex)
+                    continue;
+
+                glm::vec3 axisOffset = point - surface.position;
+                hit.distance = t;
+                hit.position = point;
+                hit.normal = glm::normalize(glm::vec3(axisOffset.x, k2 * (apex - point.y), axisOffset.z));
+                hit.surface = static_cast<int>(i);
+                break;
+            }
+        }
+    }
+
+    return hit.surface != -1;
+}
+
+/***********************************************************
+ *  DirectLight()
+ *
+ *  This method is used for finding the light that reaches a
+ *  surface point straight from the lights, with the same
+ *  ambient, diffuse and falloff terms as the scene shaders.
+ *  Specular light depends on the viewer and is not baked.
+ *  The ambient term and the separate light are only handled
+ *  for the texel itself, bounce points pass on their
+ *  shadowed diffuse light only.
+ ***********************************************************/
+glm::vec3 LightmapBaker::DirectLight(glm::vec3 position, glm::vec3 normal, bool texelPoint, float& separateImpact) const
+{
+    glm::vec3 result(0.0f);
+    separateImpact = 0.0f;
+    glm::vec3 rayOrigin = position + normal * g_RayOffset;
+
+    for (size_t i = 0; i < m_lights.size(); i++)
+    {
+        const LIGHT_SOURCE& light = m_lights[i];
+        glm::vec3 lightOffset = light.position - position;
+        float distanceSquared = glm::dot(lightOffset, lightOffset);
+
+        float attenuation = 1.0f;
+        if (light.radius > 0.0f)
+        {
+            float ratio = distanceSquared / (light.radius * light.radius);
+            float falloff = glm::clamp(1.0f - ratio * ratio, 0.0f, 1.0f);
+            attenuation = falloff * falloff / (1.0f + distanceSquared);
+        }
+        if (attenuation <= 0.0f)
+            continue;
+
+        if (texelPoint)
+            result += attenuation * light.ambientColor;
+
+        float lightDistance = sqrt(distanceSquared);
+        glm::vec3 lightDirection = lightOffset / lightDistance;
+        float impact = std::max(glm::dot(normal, lightDirection), 0.0f);
+        if (impact <= 0.0f)
+            continue;
+
+        // the separate light is shadowed at runtime, where the
+        // moving objects are known
+        if (static_cast<int>(i) == m_separateLightIndex && texelPoint)
+        {
+            separateImpact = attenuation * impact;
+            continue;
+        }
+
+        HIT blocker;
+        if (Trace(rayOrigin, lightDirection, lightDistance, blocker))
+            continue;
+
+        result += attenuation * impact * light.diffuseColor * m_materialDiffuse;
+    }
+
+    return result;
+}
+
+/***********************************************************
+ *  BakeRows()
+ *
+ *  This method runs on every baking thread and bakes whole
+ *  rows until none are left.
+ ***********************************************************/
+void LightmapBaker::BakeRows()
+{
+    while (true)
+    {
+        int y = m_nextRow.fetch_add(1);
+        if (y >= m_height)
+            return;
+
+        for (int x = 0; x < m_width; x++)
+        {
+            BakeTexel(x, y);
+        }
+    }
+}
+
+/***********************************************************
+ *  BakeTexel()
+ *
+ *  This method is used for baking one texel.  A ray straight
+ *  down finds the surface under the texel center, then the
+ *  direct light is added to one bounce of light gathered with
+ *  cosine weighted rays over the surface hemisphere.
+ ***********************************************************/
+void LightmapBaker::BakeTexel(int x, int y)
+{
+    glm::vec3 origin(
+        m_boundsMin.x + (x + 0.5f) / m_width * m_boundsSize.x,
+        m_topHeight,
+        m_boundsMin.y + (y + 0.5f) / m_height * m_boundsSize.y);
+
+    HIT surfaceHit;
+    if (!Trace(origin, glm::vec3(0.0f, -1.0f, 0.0f), 1.0e30f, surfaceHit))
+        return;
+
+    float separateImpact = 0.0f;
+    glm::vec3 lighting = DirectLight(surfaceHit.position, surfaceHit.normal, true, separateImpact);
+
+    // a frame around the normal for the bounce rays
+    glm::vec3 normal = surfaceHit.normal;
+    glm::vec3 tangent = (fabs(normal.y) < 0.99f) ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+    tangent = glm::normalize(glm::cross(tangent, normal));
+    glm::vec3 bitangent = glm::cross(normal, tangent);
+    glm::vec3 rayOrigin = surfaceHit.position + normal * g_RayOffset;
+
+    uint32_t randomState = static_cast<uint32_t>(y * m_width + x) * 2654435761u + 1u;
+    glm::vec3 bounced(0.0f);
+    for (int sample = 0; sample < g_IndirectSamples; sample++)
+    {
+        // cosine weighted, so the hits are simply averaged
+        float u = NextRandom(randomState);
+        float v = NextRandom(randomState);
+        float ringRadius = sqrt(u);
+        float angle = 2.0f * g_Pi * v;
+        glm::vec3 direction = tangent * (ringRadius * cos(angle)) + bitangent * (ringRadius * sin(angle)) + normal * sqrt(1.0f - u);
+
+        HIT bounceHit;
+        if (!Trace(rayOrigin, direction, 1.0e30f, bounceHit))
+            continue;
+
+        float unused = 0.0f;
+        glm::vec3 hitLight = DirectLight(bounceHit.position, bounceHit.normal, false, unused);
+        bounced += m_surfaces[bounceHit.surface].albedo * hitLight;
+    }
+    lighting += m_materialDiffuse * bounced / static_cast<float>(g_IndirectSamples);
+
+    float* texel = &m_texels[(static_cast<size_t>(y) * m_width + x) * 4];
+    texel[0] = lighting.x;
+    texel[1] = lighting.y;
+    texel[2] = lighting.z;
+    texel[3] = separateImpact;
+}
+
+/***********************************************************
+ *  HashInputs()
+ *
+ *  This method is used for hashing everything the baked
+ *  texels depend on, so a stale cache file is never used.
+ ***********************************************************/
+uint64_t LightmapBaker::HashInputs() const
+{
+    uint64_t hash = 14695981039346656037ull;
+    HashBytes(hash, &g_CacheVersion, sizeof(g_CacheVersion));
+    HashBytes(hash, &g_IndirectSamples, sizeof(g_IndirectSamples));
+    HashBytes(hash, &m_width, sizeof(m_width));
+    HashBytes(hash, &m_height, sizeof(m_height));
+    HashBytes(hash, &m_separateLightIndex, sizeof(m_separateLightIndex));
+    HashVector(hash, m_materialDiffuse);
+
+    for (const auto& surface : m_surfaces)
+    {
+        int shape = static_cast<int>(surface.shape);
+        HashBytes(hash, &shape, sizeof(shape));
+        HashVector(hash, surface.position);
+        HashVector(hash, surface.scale);
+        HashVector(hash, surface.albedo);
+    }
+    for (const auto& light : m_lights)
+    {
+        HashVector(hash, light.position);
+        HashVector(hash, light.ambientColor);
+        HashVector(hash, light.diffuseColor);
+        HashBytes(hash, &light.radius, sizeof(light.radius));
+    }
+    return hash;
+}
+
+/***********************************************************
+ *  LoadCache()
+ *
+ *  This method is used for reading the texels from the cache
+ *  file, if it holds a lightmap baked from the same inputs.
+ ***********************************************************/
+bool LightmapBaker::LoadCache(const char* cacheFile, uint64_t hash)
+{
+    std::ifstream file(cacheFile, std::ios::binary);
+    if (!file)
+        return false;
+
+    char magic[4] = { 0, 0, 0, 0 };
+    uint64_t fileHash = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&fileHash), sizeof(fileHash));
+    if (!file || memcmp(magic, g_CacheMagic, sizeof(magic)) != 0 || fileHash != hash)
+    {
+        std::cout << "Lightmap cache " << cacheFile << " is out of date, baking again" << std::endl;
+        return false;
+    }
+
+    m_texels.resize(static_cast<size_t>(m_width) * m_height * 4);
+    file.read(reinterpret_cast<char*>(m_texels.data()), m_texels.size() * sizeof(float));
+    if (!file)
+    {
+        std::cout << "Lightmap cache " << cacheFile << " is truncated, baking again" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ *  WriteCache()
+ *
+ *  This method is used for saving the baked texels, so the
+ *  next start can skip the bake.
+ ***********************************************************/
+void LightmapBaker::WriteCache(const char* cacheFile, uint64_t hash) const
+{
+    std::ofstream file(cacheFile, std::ios::binary);
+    file.write(g_CacheMagic, sizeof(g_CacheMagic));
+    file.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    file.write(reinterpret_cast<const char*>(m_texels.data()), m_texels.size() * sizeof(float));
+    if (!file)
+        std::cout << "Could not write lightmap cache " << cacheFile << std::endl;
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for creating the lightmap texture.
+ *  Half floats keep lighting brighter than one.
+ ***********************************************************/
+void LightmapBaker::Upload()
+{
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->ActiveTexture(GL_TEXTURE0 + LIGHTMAP_TEXTURE_UNIT);
+
+    glGenTextures(1, &m_texture);
+    stateCache->BindTexture(GL_TEXTURE_2D, m_texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, m_width, m_height);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, GL_RGBA, GL_FLOAT, m_texels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the lightmap and setting
+ *  the values that map a world position onto it.
+ ***********************************************************/
+void LightmapBaker::Bind(GLuint programID) const
+{
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->ActiveTexture(GL_TEXTURE0 + LIGHTMAP_TEXTURE_UNIT);
+    stateCache->BindTexture(GL_TEXTURE_2D, m_texture);
+
+    glUniform1i(glGetUniformLocation(programID, g_LightmapName), LIGHTMAP_TEXTURE_UNIT);
+    glUniform4f(glGetUniformLocation(programID, g_LightmapBoundsName),
+        m_boundsMin.x, m_boundsMin.y, 1.0f / m_boundsSize.x, 1.0f / m_boundsSize.y);
+    glUniform1i(glGetUniformLocation(programID, g_LightmapLightIndexName), m_separateLightIndex);
+    RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 3);
+}
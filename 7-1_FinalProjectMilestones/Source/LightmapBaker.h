@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightmapbaker.h
+// ============
+// bake the direct and bounced lighting of the static surfaces into a
+// lightmap on all CPU cores, and cache the result in a file
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "ClusteredLighting.h"
+
+// texture unit the lightmap is sampled from
+const GLint LIGHTMAP_TEXTURE_UNIT = 11;
+
+// shapes of the static surfaces the baker can trace
+enum BAKE_SHAPE {
+    BAKE_PLANE, // level plane spanning -1 to 1 on X and Z
+    BAKE_CONE   // upright cone standing on its position
+};
+
+// BAKE_SURFACE structure
+struct BAKE_SURFACE
+{
+    BAKE_SHAPE shape;
+    glm::vec3 position;
+    glm::vec3 scale;
+    glm::vec3 albedo; // average surface color, used for the bounced light
+
+    BAKE_SURFACE()
+        : shape(BAKE_PLANE), position(0.0f), scale(1.0f), albedo(1.0f) {}
+};
+
+class LightmapBaker
+{
+public:
+    // constructor
+    LightmapBaker();
+    // destructor
+    ~LightmapBaker();
+
+    // add a static surface to the baked scene
+    void AddSurface(const BAKE_SURFACE& surface);
+
+    // load the lightmap from the cache file when it was baked for the
+    // same surfaces, lights and material, otherwise bake and write it.
+    // The direct diffuse light of the separate light is left out of
+    // the colors and kept in alpha, so it can be shadowed at runtime,
+    // -1 bakes every light into the colors
+    bool Build(const std::vector<LIGHT_SOURCE>& lights, glm::vec3 materialDiffuse, int separateLightIndex, const char* cacheFile);
+
+    // bind the lightmap and set its lookup values into the passed in
+    // shader program, which must be the current program
+    void Bind(GLuint programID) const;
+
+    GLuint GetTexture() const { return m_texture; }
+
+private:
+    // HIT structure - closest surface found along a ray
+    struct HIT
+    {
+        float distance;
+        glm::vec3 position;
+        glm::vec3 normal;
+        int surface;
+    };
+
+    // find the closest surface along a ray, up to the passed in distance
+    bool Trace(glm::vec3 origin, glm::vec3 direction, float maxDistance, HIT& hit) const;
+    // light a surface point receives directly, split into the baked
+    // colors and the direct diffuse of the separate light for a texel
+    glm::vec3 DirectLight(glm::vec3 position, glm::vec3 normal, bool texelPoint, float& separateImpact) const;
+    // bake every texel of the rows handed out by m_nextRow
+    void BakeRows();
+    void BakeTexel(int x, int y);
+    uint64_t HashInputs() const;
+    bool LoadCache(const char* cacheFile, uint64_t hash);
+    void WriteCache(const char* cacheFile, uint64_t hash) const;
+    void Upload();
+
+    std::vector<BAKE_SURFACE> m_surfaces;
+    std::vector<LIGHT_SOURCE> m_lights;
+    glm::vec3 m_materialDiffuse;
+    int m_separateLightIndex;
+
+    // world XZ area the lightmap covers
+    glm::vec2 m_boundsMin;
+    glm::vec2 m_boundsSize;
+    float m_topHeight; // height the texel rays start from
+    int m_width;
+    int m_height;
+    std::vector<float> m_texels; // RGBA per texel
+    std::atomic<int> m_nextRow;
+
+    GLuint m_texture;
+};
@@ -1,5 +1,10 @@
 #include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
+#include <cstdlib>          // EXIT_FAILURE, strtoul
+#include <cstring>          // strcmp
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <cassert>
 
 #include <GL/glew.h>        // GLEW library
 #include "GLFW/glfw3.h"     // GLFW library
@@ -13,6 +18,20 @@
 #include "ViewManager.h"
 #include "ShapeMeshes.h"
 #include "ShaderManager.h"
+#include "GLStateCache.h"
+#include "SimulationClock.h"
+#include "DynamicResolution.h"
+#include "CameraPath.h"
+#include "FramePacer.h"
+#include "HeadlessContext.h"
+#include "FrameProfiler.h"
+#include "SceneBenchmark.h"
+#include "RenderCounters.h"
+#include "StatsOverlay.h"
+#include "GoldenImageHarness.h"
+#include "FrameArena.h"
+#include "AllocationTracker.h"
+#include "GPUFrameTimer.h"
 
 // Namespace for declaring global variables
 namespace
@@ -29,17 +48,93 @@ namespace
 	ShaderManager* g_ShaderManager = nullptr;
 	// view manager object for managing the 3D view setup and projection to 2D
 	ViewManager* g_ViewManager = nullptr;
+	// offscreen target whose resolution follows the frame time,
+	// NULL when the scene renders straight to the window
+	DynamicResolution* g_DynamicResolution = nullptr;
+
+	// length of one simulation step, the camera and the animations
+	// advance in steps of this size whatever the frame rate is
+	const double g_SimulationStep = 1.0 / 120.0;
+
+	// camera path recorded during the run or replayed instead of the
+	// input, NULL when neither is asked for on the command line
+	CameraPath* g_CameraPath = nullptr;
+	const char* g_RecordPathFile = nullptr;
+	const char* g_ReplayTimingsFile = "replay_timings.csv";
+
+	// paces the presented frames
+	FramePacer* g_FramePacer = nullptr;
+	double g_FrameCap = 60.0;
+
+	// context without a window for hosts without a display, NULL
+	// when rendering to a window
+	HeadlessContext* g_HeadlessContext = nullptr;
+	// frames drawn without a window when no count or camera path
+	// is passed in
+	const int g_DefaultHeadlessFrames = 600;
+
+	// Chrome trace written at the exit for the frames from first to
+	// last, NULL when no trace is asked for
+	const char* g_TraceFile = nullptr;
+	unsigned int g_TraceFirstFrame = 0;
+	unsigned int g_TraceLastFrame = 0xFFFFFFFF;
+	// frames F4 writes to a trace while running
+	const unsigned int g_TraceKeyFrames = 60;
+
+	// frame time and render counters drawn over the scene, NULL when
+	// the overlay shaders failed to load
+	StatsOverlay* g_StatsOverlay = nullptr;
+	bool g_ShowStats = false;
+
+	// frames timed for every scene size of the scene benchmark
+	const int g_SceneBenchmarkFrames = 100;
+
+	// frames after the start or the last key press in which caches,
+	// buffers and lists may still grow, later frames must not allocate
+	const int g_SteadyStateFrames = 240;
+	int g_FramesSinceChange = 0;
 }
 
 // Function declarations - all functions that are called manually
 // need to be pre-declared at the beginning of the source code.
-bool InitializeGLFW();
-bool InitializeGLEW();
+bool InitializeGLFW(bool headless);
+bool InitializeGLEW(bool headless);
+void WriteReplayTimings(const char* filename, const std::vector<float>& cpuTimes, const std::vector<float>& gpuTimes);
 
 // Function to handle key inputs
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-	if (action == GLFW_PRESS || action == GLFW_REPEAT) {
-		g_ViewManager->ProcessKeyboardEvents(window);
+	// queue the key for the camera, it is applied in the next simulation step
+	ViewManager::Key_Callback(window, key, scancode, action, mods);
+	// a key may switch what is rendered, which can allocate for a while
+	g_FramesSinceChange = 0;
+	// F1 switches the depth pre-pass on and off
+	if (action == GLFW_PRESS && key == GLFW_KEY_F1 && g_SceneManager) {
+		g_SceneManager->SetDepthPrepass(!g_SceneManager->IsDepthPrepassEnabled());
+	}
+	// F3 reports how evenly the frames were paced and moves on to
+	// the next pacing mode
+	if (action == GLFW_PRESS && key == GLFW_KEY_F3 && g_FramePacer) {
+		FRAME_PACING_STATS stats = g_FramePacer->GetStats();
+		std::cout << "INFO: " << FramePacer::GetModeName(g_FramePacer->GetMode()) << " pacing over "
+			<< stats.frameCount << " frames - mean " << stats.meanMilliseconds << " ms, jitter "
+			<< stats.jitterMilliseconds << " ms, worst " << stats.worstMilliseconds << " ms" << std::endl;
+		g_FramePacer->SetMode(static_cast<FRAME_PACING_MODE>((g_FramePacer->GetMode() + 1) % (FRAME_PACING_UNCAPPED + 1)), g_FrameCap);
+		std::cout << "INFO: Frame pacing is now " << FramePacer::GetModeName(g_FramePacer->GetMode()) << std::endl;
+	}
+	// F4 writes the last frames to a trace
+	if (action == GLFW_PRESS && key == GLFW_KEY_F4) {
+		unsigned int lastFrame = FrameProfiler::Get()->GetFrame();
+		unsigned int firstFrame = (lastFrame > g_TraceKeyFrames) ? lastFrame - g_TraceKeyFrames : 0;
+		FrameProfiler::Get()->WriteChromeTrace("frame_trace.json", firstFrame, lastFrame);
+	}
+	// F5 shows and hides the stats overlay
+	if (action == GLFW_PRESS && key == GLFW_KEY_F5) {
+		g_ShowStats = !g_ShowStats;
+	}
+	// F2 switches between the forward and deferred render paths
+	if (action == GLFW_PRESS && key == GLFW_KEY_F2 && g_SceneManager) {
+		g_SceneManager->SetRenderPath(g_SceneManager->GetRenderPath() == RENDER_PATH_FORWARD ?
+			RENDER_PATH_DEFERRED : RENDER_PATH_FORWARD);
 	}
 }
 
@@ -61,8 +156,21 @@ void scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
  ***********************************************************/
 int main(int argc, char* argv[])
 {
+	// --headless [frames] draws without a window or display
+	bool headless = false;
+	int headlessFrames = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--headless") == 0)
+		{
+			headless = true;
+			if (i + 1 < argc)
+				headlessFrames = atoi(argv[i + 1]);
+		}
+	}
+
 	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
+	if (InitializeGLFW(headless) == false)
 	{
 		return(EXIT_FAILURE);
 	}
@@ -72,56 +180,439 @@ int main(int argc, char* argv[])
 	// try to create a new view manager object
 	g_ViewManager = new ViewManager(g_ShaderManager);
 
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+	// try to create the main display window, or a context without one
+	if (headless)
+	{
+		g_HeadlessContext = new HeadlessContext();
+		if (!g_HeadlessContext->Create())
+		{
+			return(EXIT_FAILURE);
+		}
+	}
+	else
+	{
+		g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+	}
 
 	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
+	if (InitializeGLEW(headless) == false)
 	{
 		return(EXIT_FAILURE);
 	}
 
-	// Set callbacks
-	glfwSetKeyCallback(g_Window, keyCallback);
-	glfwSetCursorPosCallback(g_Window, mouseCallback);
-	glfwSetScrollCallback(g_Window, scrollCallback);
-	glfwSetWindowUserPointer(g_Window, g_ViewManager);
+	// time the frames on the GPU as well as the CPU
+	FrameProfiler::Get()->CreateQueries();
+
+	if (headless)
+	{
+		// the frames go to a framebuffer the size of the window
+		if (!g_HeadlessContext->CreateTarget(g_ViewManager->GetWindowWidth(), g_ViewManager->GetWindowHeight()))
+		{
+			return(EXIT_FAILURE);
+		}
+	}
+	else
+	{
+		// Set callbacks
+		glfwSetKeyCallback(g_Window, keyCallback);
+		glfwSetCursorPosCallback(g_Window, mouseCallback);
+		glfwSetScrollCallback(g_Window, scrollCallback);
+		glfwSetWindowUserPointer(g_Window, g_ViewManager);
+	}
 
 	// load the shader code from the external GLSL files
 	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
+		"shaders/vertexShader.glsl",
+		"shaders/fragmentShader.glsl");
+	GLStateCache::Get()->UseProgram(g_ShaderManager->m_programID);
 
 	// try to create a new scene manager object and prepare the 3D scene
 	g_SceneManager = new SceneManager(g_ShaderManager);
 	g_SceneManager->PrepareScene();
 
+	// compare the vertex formats at a high draw count and exit
+	bool quit = false;
+	bool goldenFailed = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--vertex-format-benchmark") == 0)
+		{
+			int drawCount = (i + 1 < argc) ? atoi(argv[i + 1]) : 20000;
+			g_ViewManager->PrepareSceneView();
+			g_SceneManager->SetViewParameters(
+				g_ViewManager->GetCameraPosition(),
+				g_ViewManager->GetPixelsPerUnit(),
+				g_ViewManager->GetViewMatrix(),
+				g_ViewManager->GetProjectionMatrix());
+			g_SceneManager->RunVertexFormatBenchmark(drawCount > 0 ? drawCount : 20000);
+			quit = true;
+		}
+		// time generated scenes of growing size offscreen and exit,
+		// --benchmark-output picks the JSON file
+		else if (strcmp(argv[i], "--scene-benchmark") == 0)
+		{
+			int frameCount = (i + 1 < argc) ? atoi(argv[i + 1]) : 0;
+			const char* outputFile = "scene_benchmark.json";
+			for (int j = 1; j + 1 < argc; j++)
+			{
+				if (strcmp(argv[j], "--benchmark-output") == 0)
+					outputFile = argv[j + 1];
+			}
+			SceneBenchmark sceneBenchmark(g_SceneManager, g_ViewManager);
+			sceneBenchmark.Run(frameCount > 0 ? frameCount : g_SceneBenchmarkFrames, outputFile);
+			quit = true;
+		}
+		// compare the scene from fixed poses to the golden images in
+		// a directory and exit, failing when a pose differs,
+		// --golden-update stores new golden images instead
+		else if (strcmp(argv[i], "--golden-test") == 0)
+		{
+			const char* directory = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[i + 1] : "goldens";
+			bool updateGoldens = false;
+			GoldenImageHarness goldenHarness(g_SceneManager, g_ViewManager);
+			for (int j = 1; j < argc; j++)
+			{
+				if (strcmp(argv[j], "--golden-update") == 0)
+					updateGoldens = true;
+				else if (strcmp(argv[j], "--golden-tolerance") == 0 && j + 1 < argc)
+					goldenHarness.SetTolerance(static_cast<float>(atof(argv[j + 1])));
+			}
+			goldenFailed = !goldenHarness.Run(directory, updateGoldens);
+			quit = true;
+		}
+	}
+
+	// render offscreen at a resolution that holds the target frame
+	// time, headless runs keep the full resolution so their timings
+	// compare
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+	if (!headless)
+	{
+		glfwGetFramebufferSize(g_Window, &framebufferWidth, &framebufferHeight);
+		g_DynamicResolution = new DynamicResolution();
+		if (g_DynamicResolution->Create(framebufferWidth, framebufferHeight))
+		{
+			for (int i = 1; i + 1 < argc; i++)
+			{
+				if (strcmp(argv[i], "--target-frame-time") == 0 && atof(argv[i + 1]) > 0.0)
+					g_DynamicResolution->SetTargetFrameTime(static_cast<float>(atof(argv[i + 1])));
+			}
+		}
+		else
+		{
+			delete g_DynamicResolution;
+			g_DynamicResolution = NULL;
+		}
+	}
+
+	// record the camera path of the run, or replay a recorded one
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (strcmp(argv[i], "--record-path") == 0)
+		{
+			g_CameraPath = new CameraPath(g_SimulationStep);
+			g_RecordPathFile = argv[i + 1];
+			g_ViewManager->SetRecordingPath(g_CameraPath);
+		}
+		else if (strcmp(argv[i], "--replay-path") == 0)
+		{
+			g_CameraPath = new CameraPath(g_SimulationStep);
+			if (!g_CameraPath->Load(argv[i + 1]))
+			{
+				return(EXIT_FAILURE);
+			}
+			if (g_CameraPath->GetStep() != g_SimulationStep)
+			{
+				std::cout << "Camera path was recorded with a " << g_CameraPath->GetStep()
+					<< " s step, replaying it at " << g_SimulationStep << " s" << std::endl;
+			}
+			g_ViewManager->StartReplay(g_CameraPath);
+		}
+		else if (strcmp(argv[i], "--replay-timings") == 0)
+		{
+			g_ReplayTimingsFile = argv[i + 1];
+		}
+	}
+	bool replaying = g_ViewManager->IsReplaying();
+	int frameLimit = -1;
+	if (headless)
+	{
+		// a replay runs to the end of the path unless a count is given
+		frameLimit = (headlessFrames > 0) ? headlessFrames : (replaying ? -1 : g_DefaultHeadlessFrames);
+	}
+
+	// pace the frames with vsync, except for replays, which measure
+	// how fast the frames can be drawn
+	FRAME_PACING_MODE pacingMode = replaying ? FRAME_PACING_UNCAPPED : FRAME_PACING_VSYNC;
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (strcmp(argv[i], "--frame-cap") == 0 && atof(argv[i + 1]) > 0.0)
+		{
+			g_FrameCap = atof(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "--frame-pacing") == 0)
+		{
+			for (int mode = FRAME_PACING_VSYNC; mode <= FRAME_PACING_UNCAPPED; mode++)
+			{
+				if (strcmp(argv[i + 1], FramePacer::GetModeName(static_cast<FRAME_PACING_MODE>(mode))) == 0)
+					pacingMode = static_cast<FRAME_PACING_MODE>(mode);
+			}
+		}
+	}
+	g_FramePacer = new FramePacer();
+
+	// write the profiled frames to a trace when the run ends,
+	// --trace-frames narrows them to a range like 100-200
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (strcmp(argv[i], "--trace") == 0)
+		{
+			g_TraceFile = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "--trace-frames") == 0)
+		{
+			char* rangeEnd = NULL;
+			unsigned long firstFrame = strtoul(argv[i + 1], &rangeEnd, 10);
+			if (rangeEnd != argv[i + 1] && *rangeEnd == '-')
+			{
+				const char* lastStart = rangeEnd + 1;
+				unsigned long lastFrame = strtoul(lastStart, &rangeEnd, 10);
+				if (rangeEnd != lastStart && *rangeEnd == '\0')
+				{
+					g_TraceFirstFrame = static_cast<unsigned int>(firstFrame);
+					g_TraceLastFrame = static_cast<unsigned int>(lastFrame);
+					continue;
+				}
+			}
+			std::cout << "Expected a frame range like 100-200 after --trace-frames" << std::endl;
+		}
+	}
+	if (!headless)
+	{
+		g_FramePacer->SetMode(pacingMode, g_FrameCap);
+	}
+	// the stats overlay starts hidden unless --stats is passed
+	g_StatsOverlay = new StatsOverlay();
+	if (!g_StatsOverlay->Create())
+	{
+		delete g_StatsOverlay;
+		g_StatsOverlay = NULL;
+	}
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--stats") == 0)
+			g_ShowStats = true;
+	}
+
+	// a replay renders every frame at the full resolution, so runs of
+	// different builds draw the same pixels, and times each frame on
+	// the GPU with its own queries on both the window and headless paths
+	std::vector<float> replayCpuTimes;
+	GPUFrameTimer* replayGpuTimer = NULL;
+	int replayFrames = 0;
+	if (replaying)
+	{
+		replayCpuTimes.reserve(g_CameraPath->GetFrameCount());
+		replayGpuTimer = new GPUFrameTimer();
+		replayGpuTimer->Create(g_CameraPath->GetFrameCount() + 1);
+		if (NULL != g_DynamicResolution)
+		{
+			g_DynamicResolution->SetFixedScale(1.0f);
+		}
+	}
+
+	// split the real time of every frame into fixed simulation steps
+	SimulationClock simulationClock(g_SimulationStep);
+	double lastFrameTime = glfwGetTime();
+
 	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
+	// or until an error has occurred, headless until the frames are done
+	int frameCount = 0;
+	while (!quit && (headless ? (frameLimit < 0 || frameCount < frameLimit) : !glfwWindowShouldClose(g_Window)))
 	{
+		FrameProfiler::Get()->BeginFrame();
+		PROFILE_SCOPE("Frame");
+		AllocationTracker::BeginFrame();
+
+		// run the simulation steps that came due since the last frame,
+		// a replay runs exactly one step per frame whatever it costs
+		double frameTime = glfwGetTime();
+		double frameSeconds = frameTime - lastFrameTime;
+		int steps = simulationClock.Advance(replaying ? g_SimulationStep : frameSeconds);
+		lastFrameTime = frameTime;
+
+		// time the replayed frames, the first one has no frame before it
+		if (replaying)
+		{
+			if (g_ViewManager->GetReplayFrame() > 0)
+			{
+				replayCpuTimes.push_back(static_cast<float>(frameSeconds * 1000.0));
+			}
+			if (!g_ViewManager->IsReplaying())
+			{
+				break;
+			}
+		}
+		for (int step = 0; step < steps; step++)
+		{
+			g_ViewManager->UpdateSimulation(static_cast<float>(g_SimulationStep));
+		}
+
+		// start counting the state changes and the render work of this
+		// frame, and release the transient data of the last one
+		GLStateCache::Get()->BeginFrame();
+		RenderCounters::Get()->BeginFrame();
+		FrameArena::Get()->Reset();
+		if (replaying)
+		{
+			replayGpuTimer->BeginFrame(replayFrames);
+		}
+
+		// draw into the offscreen target at the current resolution
+		float resolutionScale = 1.0f;
+		if (headless)
+		{
+			g_HeadlessContext->BeginFrame();
+		}
+		else if (NULL != g_DynamicResolution)
+		{
+			glfwGetFramebufferSize(g_Window, &framebufferWidth, &framebufferHeight);
+			g_DynamicResolution->BeginFrame(framebufferWidth, framebufferHeight);
+			resolutionScale = g_DynamicResolution->GetScale();
+		}
+
 		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
+		GLStateCache::Get()->Enable(GL_DEPTH_TEST);
 
 		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
+		GLStateCache::Get()->ClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		GLStateCache::Get()->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// convert from 3D object space to 2D view, with the camera
+		// placed between the last two simulation steps
+		g_ViewManager->PrepareSceneView(simulationClock.GetInterpolation());
+
+		// pass the camera details used for sorting, picking detail
+		// levels and the depth pre-pass
+		g_SceneManager->SetViewParameters(
+			g_ViewManager->GetCameraPosition(),
+			g_ViewManager->GetPixelsPerUnit() * resolutionScale,
+			g_ViewManager->GetViewMatrix(),
+			g_ViewManager->GetProjectionMatrix());
+		g_SceneManager->SetFrustumPlanes(g_ViewManager->GetFrustumPlanes());
+
+		// sample the animations at the simulation time of the frame,
+		// which lies between the same two steps as the camera
+		g_SceneManager->UpdateScene(static_cast<float>(simulationClock.GetInterpolatedTime()));
 
 		// refresh the 3D scene
 		g_SceneManager->RenderScene();
 
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
+		// stretch the rendered image over the window
+		if (NULL != g_DynamicResolution)
+		{
+			PROFILE_GPU_SCOPE("ResolutionBlit");
+			g_DynamicResolution->EndFrame(0);
+		}
+
+		// show the counts of the last finished frame over the image
+		if (g_ShowStats && NULL != g_StatsOverlay)
+		{
+			if (headless)
+				g_StatsOverlay->Draw(g_HeadlessContext->GetWidth(), g_HeadlessContext->GetHeight(), static_cast<float>(frameSeconds * 1000.0));
+			else
+				g_StatsOverlay->Draw(framebufferWidth, framebufferHeight, static_cast<float>(frameSeconds * 1000.0));
+		}
+
+		if (replaying)
+		{
+			replayGpuTimer->EndFrame(replayFrames);
+			replayFrames++;
+		}
+
+		// once nothing changed for a while a frame must not touch the
+		// heap, presenting and the window events are left out since
+		// the driver and the key handlers may allocate
+		g_FramesSinceChange++;
+#ifdef _DEBUG
+		if (g_FramesSinceChange > g_SteadyStateFrames && NULL == g_RecordPathFile && AllocationTracker::GetFrameBytes() != 0)
+		{
+			std::cout << "Steady-state frame allocated " << AllocationTracker::GetFrameBytes() << " bytes in "
+				<< AllocationTracker::GetFrameAllocations() << " allocations" << std::endl;
+			assert(!"steady-state frames must not allocate");
+		}
+#endif
+
+		// Flips the the back buffer with the front buffer every frame,
+		// when the frame is due
+		if (headless)
+		{
+			g_HeadlessContext->EndFrame();
+			g_FramePacer->FramePresented();
+			frameCount++;
+			continue;
+		}
+		{
+			PROFILE_SCOPE("Present");
+			g_FramePacer->WaitForPresent();
+			glfwSwapBuffers(g_Window);
+			g_FramePacer->FramePresented();
+		}
 
 		// query the latest GLFW events
 		glfwPollEvents();
 	}
 
+	// report the frame times of a headless run
+	if (headless)
+	{
+		FRAME_PACING_STATS stats = g_FramePacer->GetStats();
+		std::cout << "INFO: Rendered " << frameCount << " headless frames - mean " << stats.meanMilliseconds
+			<< " ms, jitter " << stats.jitterMilliseconds << " ms, worst " << stats.worstMilliseconds
+			<< " ms over the last " << stats.frameCount << std::endl;
+	}
+
+	// keep the profiled frames
+	if (NULL != g_TraceFile)
+	{
+		FrameProfiler::Get()->WriteChromeTrace(g_TraceFile, g_TraceFirstFrame, g_TraceLastFrame);
+	}
+
+	// report the replay timings, or keep the recorded path
+	if (replaying)
+	{
+		std::vector<float> replayGpuTimes = replayGpuTimer->ReadFrameTimes(static_cast<int>(replayCpuTimes.size()));
+		WriteReplayTimings(g_ReplayTimingsFile, replayCpuTimes, replayGpuTimes);
+		delete replayGpuTimer;
+		replayGpuTimer = NULL;
+	}
+	else if (NULL != g_RecordPathFile)
+	{
+		g_CameraPath->Save(g_RecordPathFile);
+	}
+
 	// clear the allocated manager objects from memory
+	if (NULL != g_StatsOverlay)
+	{
+		delete g_StatsOverlay;
+		g_StatsOverlay = NULL;
+	}
+	if (NULL != g_FramePacer)
+	{
+		delete g_FramePacer;
+		g_FramePacer = NULL;
+	}
+	if (NULL != g_CameraPath)
+	{
+		delete g_CameraPath;
+		g_CameraPath = NULL;
+	}
+	if (NULL != g_DynamicResolution)
+	{
+		delete g_DynamicResolution;
+		g_DynamicResolution = NULL;
+	}
 	if (NULL != g_SceneManager)
 	{
 		delete g_SceneManager;
@@ -137,20 +628,41 @@ int main(int argc, char* argv[])
 		delete g_ShaderManager;
 		g_ShaderManager = NULL;
 	}
+	if (NULL != g_HeadlessContext)
+	{
+		delete g_HeadlessContext;
+		g_HeadlessContext = NULL;
+	}
 
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS);
+	// Terminates the program, unsuccessfully when a golden image differed
+	exit(goldenFailed ? EXIT_FAILURE : EXIT_SUCCESS);
 }
 
 /***********************************************************
  *	InitializeGLFW()
  *
  *  This function is used to initialize the GLFW library.
+ *  Headless runs on Linux only use its timer and input
+ *  constants, so its null platform is picked, which needs no
+ *  display.  Elsewhere the headless context comes from a
+ *  hidden window, which needs the native platform.
  ***********************************************************/
-bool InitializeGLFW()
+bool InitializeGLFW(bool headless)
 {
 	// GLFW: initialize and configure library
 	// --------------------------------------
+	if (headless)
+	{
+#if defined(__linux__) && defined(GLFW_PLATFORM_NULL)
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+		if (!glfwInit())
+		{
+			std::cout << "Failed to initialize GLFW without a display" << std::endl;
+			return false;
+		}
+		return(true);
+	}
 	glfwInit();
 
 #ifdef __APPLE__
@@ -173,15 +685,28 @@ bool InitializeGLFW()
  *	InitializeGLEW()
  *
  *  This function is used to initialize the GLEW library.
+ *  A GLX build of GLEW loads the OpenGL functions of an EGL
+ *  context, and then fails for the missing X display, which
+ *  a headless run does not need.
  ***********************************************************/
-bool InitializeGLEW()
+bool InitializeGLEW(bool headless)
 {
 	// GLEW: initialize
 	// -----------------------------------------
 	GLenum GLEWInitResult = GLEW_OK;
 
 	// try to initialize the GLEW library
+	if (headless)
+	{
+		glewExperimental = GL_TRUE;
+	}
 	GLEWInitResult = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	if (headless && GLEW_ERROR_NO_GLX_DISPLAY == GLEWInitResult)
+	{
+		GLEWInitResult = GLEW_OK;
+	}
+#endif
 	if (GLEW_OK != GLEWInitResult)
 	{
 		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
@@ -195,3 +720,41 @@ bool InitializeGLEW()
 
 	return(true);
 }
+
+/***********************************************************
+ *	WriteReplayTimings()
+ *
+ *  This function is used to write the time of every replayed
+ *  frame to a CSV file and print a summary of them.  The GPU
+ *  time of a row is measured over the same frame as its
+ *  frame time.
+ ***********************************************************/
+void WriteReplayTimings(const char* filename, const std::vector<float>& cpuTimes, const std::vector<float>& gpuTimes)
+{
+	if (cpuTimes.empty())
+	{
+		return;
+	}
+
+	std::ofstream file(filename);
+	file << "frame,frame_ms,gpu_ms\n";
+	for (size_t i = 0; i < cpuTimes.size(); i++)
+	{
+		file << i << "," << cpuTimes[i] << "," << gpuTimes[i] << "\n";
+	}
+	if (!file)
+	{
+		std::cout << "Could not write replay timings to " << filename << std::endl;
+	}
+
+	std::vector<float> sorted = cpuTimes;
+	std::sort(sorted.begin(), sorted.end());
+	double total = 0.0;
+	for (float time : sorted)
+	{
+		total += time;
+	}
+	std::cout << "INFO: Replayed " << cpuTimes.size() << " frames, mean " << total / sorted.size()
+		<< " ms, median " << sorted[sorted.size() / 2] << " ms, worst " << sorted.back()
+		<< " ms - written to " << filename << std::endl;
+}
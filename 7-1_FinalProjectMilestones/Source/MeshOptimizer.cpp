@@ -0,0 +1,411 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshoptimizer.cpp
+// ============
+// reorder mesh indices and vertices for the GPU vertex cache, overdraw
+// and vertex fetch
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "MeshOptimizer.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+    // LRU cache size modeled by the vertex cache ordering
+    const int g_ForsythCacheSize = 32;
+    // scoring constants from Forsyth's linear-speed vertex cache optimization
+    const float g_CacheDecayPower = 1.5f;
+    const float g_LastTriangleScore = 0.75f;
+    const float g_ValenceBoostScale = 2.0f;
+    const float g_ValenceBoostPower = 0.5f;
+    // the overdraw order may cost at most this much vertex cache efficiency
+    const float g_OverdrawThreshold = 1.05f;
+
+    /***********************************************************
+     *  ForsythVertexScore()
+     *
+     *  This method returns how much emitting a triangle that
+     *  uses a vertex is worth, favoring vertices that are in
+     *  the cache and vertices with few triangles left.
+     ***********************************************************/
+    float ForsythVertexScore(int cachePosition, int remainingTriangles)
+    {
+        if (remainingTriangles == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+            {
+                // the vertices of the last triangle get a fixed score so
+                // the order does not just fan around one vertex
+                score = g_LastTriangleScore;
+            }
+            else
+            {
+                float scaler = 1.0f / (g_ForsythCacheSize - 3);
+                score = 1.0f - (cachePosition - 3) * scaler;
+                score = powf(score, g_CacheDecayPower);
+            }
+        }
+
+        // finish off vertices with few triangles left
+        score += g_ValenceBoostScale * powf(static_cast<float>(remainingTriangles), -g_ValenceBoostPower);
+        return score;
+    }
+
+    /***********************************************************
+     *  GetPosition()
+     *
+     *  This method returns the position stored at the start of
+     *  a vertex.
+     ***********************************************************/
+    glm::vec3 GetPosition(const std::vector<GLfloat>& vertices, int floatsPerVertex, GLuint index)
+    {
+        const GLfloat* vertex = &vertices[static_cast<size_t>(index) * floatsPerVertex];
+        return glm::vec3(vertex[0], vertex[1], vertex[2]);
+    }
+}
+
+/***********************************************************
+ *  OptimizeMesh()
+ *
+ *  This method is used for running the vertex cache, overdraw
+ *  and vertex fetch optimizations in that order, since each
+ *  one keeps the work of the one before it.
+ ***********************************************************/
+MESH_OPTIMIZE_REPORT MeshOptimizer::OptimizeMesh(std::vector<GLfloat>& vertices, int floatsPerVertex, std::vector<GLuint>& indices)
+{
+    MESH_OPTIMIZE_REPORT report;
+
+    size_t vertexCount = vertices.size() / floatsPerVertex;
+    report.before = AnalyzeVertexCache(indices, vertexCount, REPORT_CACHE_SIZE);
+
+    OptimizeVertexCache(indices, vertexCount);
+    OptimizeOverdraw(indices, vertices, floatsPerVertex, g_OverdrawThreshold);
+    OptimizeVertexFetch(vertices, floatsPerVertex, indices);
+
+    vertexCount = vertices.size() / floatsPerVertex;
+    report.after = AnalyzeVertexCache(indices, vertexCount, REPORT_CACHE_SIZE);
+
+    return report;
+}
+
+/***********************************************************
+ *  AnalyzeVertexCache()
+ *
+ *  This method is used for counting the vertex shader runs a
+ *  FIFO post-transform cache of the passed in size would need
+ *  for the index order.
+ ***********************************************************/
+VERTEX_CACHE_STATS MeshOptimizer::AnalyzeVertexCache(const std::vector<GLuint>& indices, size_t vertexCount, int cacheSize)
+{
+    VERTEX_CACHE_STATS stats;
+
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0)
+        return stats;
+
+    // a vertex is still cached while fewer than cacheSize misses
+    // have happened since it was loaded
+    std::vector<unsigned int> loadedAt(vertexCount, 0);
+    std::vector<bool> used(vertexCount, false);
+    unsigned int time = cacheSize + 1;
+    unsigned int misses = 0;
+    unsigned int usedVertices = 0;
+
+    for (size_t i = 0; i < triangleCount * 3; i++)
+    {
+        GLuint index = indices[i];
+        if (time - loadedAt[index] > static_cast<unsigned int>(cacheSize))
+        {
+            loadedAt[index] = time++;
+            misses++;
+        }
+        if (!used[index])
+        {
+            used[index] = true;
+            usedVertices++;
+        }
+    }
+
+    stats.acmr = static_cast<float>(misses) / triangleCount;
+    stats.atvr = static_cast<float>(misses) / usedVertices;
+    return stats;
+}
+
+/***********************************************************
+ *  OptimizeVertexCache()
+ *
+ *  This method is used for ordering the triangles so their
+ *  vertices are reused while still in the post-transform
+ *  cache.  Every step emits the best scoring triangle that
+ *  touches the modeled LRU cache.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount)
+{
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    // triangles left to emit for every vertex
+    std::vector<int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+    {
+        remaining[indices[i]]++;
+    }
+
+    // the triangles using every vertex, in one flat list
+    std::vector<size_t> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + remaining[v];
+    }
+    std::vector<size_t> adjacency(triangleCount * 3);
+    std::vector<size_t> adjacencyFill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            adjacency[adjacencyFill[indices[t * 3 + k]]++] = t;
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        vertexScore[v] = ForsythVertexScore(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    int bestTriangle = 0;
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        triangleScore[t] = vertexScore[indices[t * 3]] +
+            vertexScore[indices[t * 3 + 1]] +
+            vertexScore[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[bestTriangle])
+            bestTriangle = static_cast<int>(t);
+    }
+
+    std::vector<GLuint> output;
+    output.reserve(triangleCount * 3);
+    std::vector<GLuint> cache;
+    std::vector<GLuint> newCache;
+    size_t scanCursor = 0;
+
+    while (bestTriangle != -1)
+    {
+        emitted[bestTriangle] = true;
+
+        // the emitted vertices move to the front of the cache
+        newCache.clear();
+        for (int k = 0; k < 3; k++)
+        {
+            GLuint vertex = indices[bestTriangle * 3 + k];
+            output.push_back(vertex);
+            remaining[vertex]--;
+            if (std::find(newCache.begin(), newCache.end(), vertex) == newCache.end())
+                newCache.push_back(vertex);
+        }
+        size_t emittedCount = newCache.size();
+        for (size_t i = 0; i < cache.size(); i++)
+        {
+            if (std::find(newCache.begin(), newCache.begin() + emittedCount, cache[i]) == newCache.begin() + emittedCount)
+                newCache.push_back(cache[i]);
+        }
+
+        // rescore the cached vertices, including the ones that just
+        // fell out of the cache
+        for (size_t i = 0; i < newCache.size(); i++)
+        {
+            GLuint vertex = newCache[i];
+            int position = (i < static_cast<size_t>(g_ForsythCacheSize)) ? static_cast<int>(i) : -1;
+            cachePosition[vertex] = position;
+            vertexScore[vertex] = ForsythVertexScore(position, remaining[vertex]);
+        }
+
+        // rescore their triangles and pick the best one to emit next
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < newCache.size(); i++)
+        {
+            GLuint vertex = newCache[i];
+            for (size_t a = adjacencyOffset[vertex]; a < adjacencyOffset[vertex + 1]; a++)
+            {
+                size_t t = adjacency[a];
+                if (emitted[t])
+                    continue;
+
+                triangleScore[t] = vertexScore[indices[t * 3]] +
+                    vertexScore[indices[t * 3 + 1]] +
+                    vertexScore[indices[t * 3 + 2]];
+                if (triangleScore[t] > bestScore)
+                {
+                    bestScore = triangleScore[t];
+                    bestTriangle = static_cast<int>(t);
+                }
+            }
+        }
+
+        if (newCache.size() > static_cast<size_t>(g_ForsythCacheSize))
+            newCache.resize(g_ForsythCacheSize);
+        cache.swap(newCache);
+
+        // nothing left near the cache, continue with the next
+        // triangle in the original order
+        if (bestTriangle == -1)
+        {
+            while (scanCursor < triangleCount && emitted[scanCursor])
+            {
+                scanCursor++;
+            }
+            if (scanCursor < triangleCount)
+                bestTriangle = static_cast<int>(scanCursor);
+        }
+    }
+
+    indices.swap(output);
+}
+
+/***********************************************************
+ *  OptimizeOverdraw()
+ *
+ *  This method is used for splitting the cache ordered
+ *  triangles into clusters where the cache starts over, and
+ *  sorting the clusters so the ones facing away from the mesh
+ *  center are drawn first and hide the ones behind them.  The
+ *  new order is only kept while its cache result stays within
+ *  the threshold of the cache ordered result.
+ ***********************************************************/
+void MeshOptimizer::OptimizeOverdraw(std::vector<GLuint>& indices, const std::vector<GLfloat>& vertices, int floatsPerVertex, float threshold)
+{
+    size_t triangleCount = indices.size() / 3;
+    size_t vertexCount = vertices.size() / floatsPerVertex;
+    if (triangleCount < 2)
+        return;
+
+    // a triangle whose vertices all miss the cache starts a cluster
+    std::vector<size_t> clusterStart;
+    std::vector<unsigned int> loadedAt(vertexCount, 0);
+    unsigned int time = REPORT_CACHE_SIZE + 1;
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        int misses = 0;
+        for (int k = 0; k < 3; k++)
+        {
+            GLuint index = indices[t * 3 + k];
+            if (time - loadedAt[index] > static_cast<unsigned int>(REPORT_CACHE_SIZE))
+            {
+                loadedAt[index] = time++;
+                misses++;
+            }
+        }
+        if (t == 0 || misses == 3)
+            clusterStart.push_back(t);
+    }
+    if (clusterStart.size() < 2)
+        return;
+    clusterStart.push_back(triangleCount);
+
+    // mesh center from the referenced vertices
+    glm::vec3 meshCenter(0.0f);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+    {
+        meshCenter += GetPosition(vertices, floatsPerVertex, indices[i]);
+    }
+    meshCenter /= static_cast<float>(triangleCount * 3);
+
+    // sort key for every cluster - how far its area weighted center
+    // lies out along its average facing
+    size_t clusterCount = clusterStart.size() - 1;
+    std::vector<float> clusterKey(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        glm::vec3 center(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = clusterStart[c]; t < clusterStart[c + 1]; t++)
+        {
+            glm::vec3 p0 = GetPosition(vertices, floatsPerVertex, indices[t * 3]);
+            glm::vec3 p1 = GetPosition(vertices, floatsPerVertex, indices[t * 3 + 1]);
+            glm::vec3 p2 = GetPosition(vertices, floatsPerVertex, indices[t * 3 + 2]);
+
+            // the cross product length is twice the triangle area
+            glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+            float faceArea = glm::length(faceNormal);
+
+            center += (p0 + p1 + p2) * (faceArea / 3.0f);
+            normal += faceNormal;
+            area += faceArea;
+        }
+
+        float normalLength = glm::length(normal);
+        if (area > 0.0f && normalLength > 0.0f)
+            clusterKey[c] = glm::dot(center / area - meshCenter, normal / normalLength);
+        else
+            clusterKey[c] = 0.0f;
+    }
+
+    std::vector<size_t> clusterOrder(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        clusterOrder[c] = c;
+    }
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+        [&clusterKey](size_t a, size_t b) { return clusterKey[a] > clusterKey[b]; });
+
+    std::vector<GLuint> sorted;
+    sorted.reserve(triangleCount * 3);
+    for (size_t i = 0; i < clusterCount; i++)
+    {
+        size_t c = clusterOrder[i];
+        sorted.insert(sorted.end(),
+            indices.begin() + clusterStart[c] * 3,
+            indices.begin() + clusterStart[c + 1] * 3);
+    }
+
+    VERTEX_CACHE_STATS cacheOrdered = AnalyzeVertexCache(indices, vertexCount, REPORT_CACHE_SIZE);
+    VERTEX_CACHE_STATS overdrawOrdered = AnalyzeVertexCache(sorted, vertexCount, REPORT_CACHE_SIZE);
+    if (overdrawOrdered.acmr <= cacheOrdered.acmr * threshold)
+        indices.swap(sorted);
+}
+
+/***********************************************************
+ *  OptimizeVertexFetch()
+ *
+ *  This method is used for storing the vertices in the order
+ *  the indices first use them, so vertex fetches walk through
+ *  memory.  Vertices that no index uses are dropped.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexFetch(std::vector<GLfloat>& vertices, int floatsPerVertex, std::vector<GLuint>& indices)
+{
+    size_t vertexCount = vertices.size() / floatsPerVertex;
+    std::vector<GLint> remap(vertexCount, -1);
+    std::vector<GLfloat> output;
+    output.reserve(vertices.size());
+
+    GLint nextVertex = 0;
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        GLuint index = indices[i];
+        if (remap[index] == -1)
+        {
+            remap[index] = nextVertex++;
+            output.insert(output.end(),
+                vertices.begin() + static_cast<size_t>(index) * floatsPerVertex,
+                vertices.begin() + static_cast<size_t>(index + 1) * floatsPerVertex);
+        }
+        indices[i] = remap[index];
+    }
+
+    vertices.swap(output);
+}
@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshoptimizer.h
+// ============
+// reorder mesh indices and vertices for the GPU vertex cache, overdraw
+// and vertex fetch
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+
+// VERTEX_CACHE_STATS structure - simulated post-transform cache results
+struct VERTEX_CACHE_STATS
+{
+    // average cache misses per triangle, 0.5 is the best possible
+    float acmr;
+    // average transformed vertices per vertex, 1.0 is the best possible
+    float atvr;
+
+    VERTEX_CACHE_STATS() : acmr(0.0f), atvr(0.0f) {}
+};
+
+// MESH_OPTIMIZE_REPORT structure - cache results before and after optimizing
+struct MESH_OPTIMIZE_REPORT
+{
+    VERTEX_CACHE_STATS before;
+    VERTEX_CACHE_STATS after;
+};
+
+class MeshOptimizer
+{
+public:
+    // size of the simulated FIFO cache used for the reported numbers
+    static const int REPORT_CACHE_SIZE = 16;
+
+    // run every optimization on an indexed triangle mesh whose
+    // vertices start with a float position, and report the vertex
+    // cache results before and after
+    static MESH_OPTIMIZE_REPORT OptimizeMesh(std::vector<GLfloat>& vertices, int floatsPerVertex, std::vector<GLuint>& indices);
+
+    // simulate a FIFO post-transform cache over the index order
+    static VERTEX_CACHE_STATS AnalyzeVertexCache(const std::vector<GLuint>& indices, size_t vertexCount, int cacheSize);
+
+    // reorder the triangles for the post-transform vertex cache
+    static void OptimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount);
+
+    // reorder clusters of cache ordered triangles so outward facing
+    // parts are drawn first, as long as the cache result stays within
+    // the passed in threshold of the cache ordered result
+    static void OptimizeOverdraw(std::vector<GLuint>& indices, const std::vector<GLfloat>& vertices, int floatsPerVertex, float threshold);
+
+    // reorder the vertices into the order the indices first use them
+    static void OptimizeVertexFetch(std::vector<GLfloat>& vertices, int floatsPerVertex, std::vector<GLuint>& indices);
+};
@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////
+// overdrawmeter.cpp
+// ============
+// measure how many fragments pass the depth test with occlusion queries
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "OverdrawMeter.h"
+
+/***********************************************************
+ *  OverdrawMeter()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+OverdrawMeter::OverdrawMeter()
+    : m_nextQuery(0), m_activeQuery(-1), m_hasResult(false), m_resultSamples(0), m_resultTag(0)
+{
+    for (int i = 0; i < QUERY_COUNT; i++)
+    {
+        m_queries[i] = 0;
+        m_pending[i] = false;
+        m_tags[i] = 0;
+    }
+}
+
+/***********************************************************
+ *  ~OverdrawMeter()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+OverdrawMeter::~OverdrawMeter()
+{
+    if (m_queries[0] != 0)
+    {
+        glDeleteQueries(QUERY_COUNT, m_queries);
+    }
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the query objects.
+ ***********************************************************/
+void OverdrawMeter::Create()
+{
+    if (m_queries[0] == 0)
+    {
+        glGenQueries(QUERY_COUNT, m_queries);
+    }
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used for collecting the result of the
+ *  query about to be reused and starting it again for the
+ *  next pass.  The queries alternate, so a result is read a
+ *  frame after it was issued when the GPU is already done.
+ ***********************************************************/
+void OverdrawMeter::Begin(int tag)
+{
+    m_activeQuery = -1;
+    if (m_queries[0] == 0)
+        return;
+
+    int query = m_nextQuery;
+    if (m_pending[query])
+    {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(m_queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return;
+
+        glGetQueryObjectui64v(m_queries[query], GL_QUERY_RESULT, &m_resultSamples);
+        m_resultTag = m_tags[query];
+        m_hasResult = true;
+        m_pending[query] = false;
+    }
+
+    glBeginQuery(GL_SAMPLES_PASSED, m_queries[query]);
+    m_tags[query] = tag;
+    m_activeQuery = query;
+}
+
+/***********************************************************
+ *  End()
+ *
+ *  This method is used for ending the measured pass.
+ ***********************************************************/
+void OverdrawMeter::End()
+{
+    if (m_activeQuery == -1)
+        return;
+
+    glEndQuery(GL_SAMPLES_PASSED);
+    m_pending[m_activeQuery] = true;
+    m_nextQuery = (m_activeQuery + 1) % QUERY_COUNT;
+    m_activeQuery = -1;
+}
+
+/***********************************************************
+ *  TakeResult()
+ *
+ *  This method is used for handing out the latest finished
+ *  measurement a single time.
+ ***********************************************************/
+bool OverdrawMeter::TakeResult(GLuint64& samplesPassed, int& tag)
+{
+    if (!m_hasResult)
+        return false;
+
+    samplesPassed = m_resultSamples;
+    tag = m_resultTag;
+    m_hasResult = false;
+    return true;
+}
@@ -0,0 +1,47 @@
+///////////////////////////////////////////////////////////////////////////////
+// overdrawmeter.h
+// ============
+// measure how many fragments pass the depth test with occlusion queries
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+class OverdrawMeter
+{
+public:
+    // constructor
+    OverdrawMeter();
+    // destructor
+    ~OverdrawMeter();
+
+    // create the query objects
+    void Create();
+
+    // start counting the samples of a pass, the tag is handed back
+    // with the result so it can be matched to the settings it was
+    // measured with - a pass is skipped while its query is still
+    // waiting on the GPU, so measuring never stalls the frame
+    void Begin(int tag);
+    void End();
+
+    // returns true once for every newly finished measurement
+    bool TakeResult(GLuint64& samplesPassed, int& tag);
+
+private:
+    static const int QUERY_COUNT = 2;
+
+    GLuint m_queries[QUERY_COUNT];
+    bool m_pending[QUERY_COUNT];
+    int m_tags[QUERY_COUNT];
+    int m_nextQuery;
+    int m_activeQuery; // -1 when the current pass is not measured
+
+    bool m_hasResult;
+    GLuint64 m_resultSamples;
+    int m_resultTag;
+};
@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////
+// perdrawbuffer.cpp
+// ============
+// stream the per-draw shader data through a persistently mapped ring buffer
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "PerDrawBuffer.h"
+#include "RenderCounters.h"
+
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+    // longest single wait on a frame section fence, in nanoseconds,
+    // the wait is repeated until the fence passes or fails
+    const GLuint64 g_FenceTimeout = 1000000000;
+}
+
+/***********************************************************
+ *  PerDrawRingBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+PerDrawRingBuffer::PerDrawRingBuffer()
+    : m_buffer(0), m_mappedData(NULL), m_maxDraws(0), m_sectionSize(0),
+    m_frameSection(0), m_drawCount(0), m_stallCount(0), m_overflowCount(0)
+{
+    for (int i = 0; i < PER_DRAW_FRAME_COUNT; i++)
+    {
+        m_fences[i] = NULL;
+    }
+}
+
+/***********************************************************
+ *  ~PerDrawRingBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+PerDrawRingBuffer::~PerDrawRingBuffer()
+{
+    Release();
+}
+
+/***********************************************************
+ *  Release()
+ *
+ *  This method is used for deleting the fences and unmapping
+ *  and deleting the buffer.
+ ***********************************************************/
+void PerDrawRingBuffer::Release()
+{
+    for (int i = 0; i < PER_DRAW_FRAME_COUNT; i++)
+    {
+        if (m_fences[i] != NULL)
+        {
+            glDeleteSync(m_fences[i]);
+            m_fences[i] = NULL;
+        }
+    }
+
+    if (m_buffer != 0)
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+        glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_mappedData = NULL;
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for replacing the buffer with one that
+ *  holds a different number of draws per frame.  The GPU may
+ *  still read the old sections, so it is waited on first,
+ *  which makes this only fit for setup, never a frame.
+ ***********************************************************/
+bool PerDrawRingBuffer::Resize(GLuint maxDrawsPerFrame)
+{
+    glFinish();
+    Release();
+    m_frameSection = 0;
+    m_drawCount = 0;
+    return Create(maxDrawsPerFrame);
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the immutable buffer
+ *  that holds PER_DRAW_FRAME_COUNT frame sections and mapping
+ *  it once for the lifetime of the application.
+ ***********************************************************/
+bool PerDrawRingBuffer::Create(GLuint maxDrawsPerFrame)
+{
+    // persistent mapping needs buffer storage and the shaders
+    // read the data through a shader storage block
+    if (!(GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) || !GLEW_VERSION_4_3)
+    {
+        std::cout << "Persistent mapped buffers are not supported, using per-draw uniforms" << std::endl;
+        return false;
+    }
+
+    // every frame section has to start on a valid binding offset
+    GLint offsetAlignment = 1;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+
+    m_maxDraws = maxDrawsPerFrame;
+    m_sectionSize = static_cast<GLsizeiptr>(m_maxDraws) * sizeof(PER_DRAW_DATA);
+    m_sectionSize = ((m_sectionSize + offsetAlignment - 1) / offsetAlignment) * offsetAlignment;
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, m_sectionSize * PER_DRAW_FRAME_COUNT, NULL, flags);
+    m_mappedData = static_cast<PER_DRAW_DATA*>(
+        glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, m_sectionSize * PER_DRAW_FRAME_COUNT, flags));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (m_mappedData == NULL)
+    {
+        std::cout << "Could not map the per-draw ring buffer, using per-draw uniforms" << std::endl;
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+        return false;
+    }
+
+    return true;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for moving to the next frame section.
+ *  The fence placed when the section was last used is only
+ *  waited on when the GPU has fallen a full ring behind, and
+ *  the section is not written before the fence has passed.
+ *  When the wait fails the section is left alone for this
+ *  frame, and the draws fall back to uniforms.
+ ***********************************************************/
+void PerDrawRingBuffer::BeginFrame()
+{
+    m_frameSection = (m_frameSection + 1) % PER_DRAW_FRAME_COUNT;
+    m_drawCount = 0;
+
+    GLsync fence = m_fences[m_frameSection];
+    if (fence == NULL)
+        return;
+
+    // poll first so the common case never blocks
+    GLenum waitResult = glClientWaitSync(fence, 0, 0);
+    if (waitResult == GL_TIMEOUT_EXPIRED)
+    {
+        m_stallCount++;
+        do
+        {
+            waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, g_FenceTimeout);
+        } while (waitResult == GL_TIMEOUT_EXPIRED);
+    }
+
+    glDeleteSync(fence);
+    m_fences[m_frameSection] = NULL;
+
+    if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+    {
+        std::cout << "Waiting for a per-draw frame section failed, drawing this frame with uniforms" << std::endl;
+        m_drawCount = m_maxDraws;
+    }
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for fencing the current frame section
+ *  after the last draw that reads from it.
+ ***********************************************************/
+void PerDrawRingBuffer::EndFrame()
+{
+    m_fences[m_frameSection] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/***********************************************************
+ *  BindFrameSection()
+ *
+ *  This method is used for binding the current frame section
+ *  so the shaders can index it by draw ID.
+ ***********************************************************/
+void PerDrawRingBuffer::BindFrameSection(GLuint bindingPoint) const
+{
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bindingPoint, m_buffer,
+        m_sectionSize * m_frameSection, m_sectionSize);
+}
+
+/***********************************************************
+ *  PushDraw()
+ *
+ *  This method is used for writing the data of the next draw
+ *  straight into the mapped frame section.
+ ***********************************************************/
+GLint PerDrawRingBuffer::PushDraw(const PER_DRAW_DATA& drawData)
+{
+    if (m_mappedData == NULL)
+        return -1;
+    if (m_drawCount >= m_maxDraws)
+    {
+        m_overflowCount++;
+        return -1;
+    }
+
+    PER_DRAW_DATA* section = reinterpret_cast<PER_DRAW_DATA*>(
+        reinterpret_cast<char*>(m_mappedData) + m_sectionSize * m_frameSection);
+    section[m_drawCount] = drawData;
+    RenderCounters::Get()->Add(COUNTER_BUFFER_BYTES, sizeof(PER_DRAW_DATA));
+
+    return static_cast<GLint>(m_drawCount++);
+}
@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// perdrawbuffer.h
+// ============
+// stream the per-draw shader data through a persistently mapped ring buffer
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// number of frames the ring buffer can have in flight at once
+const int PER_DRAW_FRAME_COUNT = 3;
+
+// most lights with a radius that can be listed for one draw
+const int MAX_DRAW_LIGHTS = 8;
+
+// PER_DRAW_DATA structure - matches the std430 PerDrawData
+// struct declared in the vertex and fragment shaders
+struct PER_DRAW_DATA
+{
+    glm::mat4 model;
+    glm::vec4 color;
+    glm::vec2 uvScale;
+    GLint useTexture;
+    GLint textureSlot;
+    GLint useLightmap;
+    GLint lightCount; // -1 when more lights reach the object than fit, the shader then uses the clusters
+    GLint lightIndices[MAX_DRAW_LIGHTS]; // light buffer entries of the lights that reach the object
+    GLint padding[2]; // std430 rounds the struct size up to 16 bytes
+
+    PER_DRAW_DATA()
+        : model(1.0f), color(1.0f), uvScale(1.0f), useTexture(0), textureSlot(0), useLightmap(0), lightCount(0), lightIndices(), padding() {}
+};
+
+class PerDrawRingBuffer
+{
+public:
+    // constructor
+    PerDrawRingBuffer();
+    // destructor
+    ~PerDrawRingBuffer();
+
+    // create the mapped buffer, returns false when the OpenGL
+    // context does not support persistent buffer mapping
+    bool Create(GLuint maxDrawsPerFrame);
+    bool IsCreated() const { return m_mappedData != NULL; }
+    // replace the buffer with one of a different size, waits for the
+    // GPU to finish the sections still in flight
+    bool Resize(GLuint maxDrawsPerFrame);
+    GLuint GetMaxDraws() const { return m_maxDraws; }
+
+    // claim the next frame section, waiting only if the GPU is
+    // still reading it from PER_DRAW_FRAME_COUNT frames ago
+    void BeginFrame();
+    // fence the current frame section once all its draws are issued
+    void EndFrame();
+
+    // bind the current frame section to a shader storage binding point
+    void BindFrameSection(GLuint bindingPoint) const;
+
+    // copy the draw data into the current frame section and return
+    // the draw ID to index it with, or -1 if the section is full
+    GLint PushDraw(const PER_DRAW_DATA& drawData);
+
+    // number of frames that had to wait on a fence
+    GLuint GetStallCount() const { return m_stallCount; }
+    // number of draws that found no room in their frame section and
+    // were drawn with uniforms instead
+    GLuint GetOverflowCount() const { return m_overflowCount; }
+
+private:
+    void Release();
+
+    GLuint m_buffer;
+    PER_DRAW_DATA* m_mappedData;
+    GLsync m_fences[PER_DRAW_FRAME_COUNT];
+    GLuint m_maxDraws;
+    GLsizeiptr m_sectionSize;
+    int m_frameSection;
+    GLuint m_drawCount;
+    GLuint m_stallCount;
+    GLuint m_overflowCount;
+};
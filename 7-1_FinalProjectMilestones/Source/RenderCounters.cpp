@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendercounters.cpp
+// ============
+// count the draws, triangles, uniform uploads, binds, uploaded buffer
+// bytes and culled objects of every frame
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "RenderCounters.h"
+
+// declaration of global variables
+namespace
+{
+    const char* const g_CounterNames[RENDER_COUNTER_COUNT] = {
+        "DRAWS",
+        "TRIANGLES",
+        "UNIFORMS",
+        "TEXTURE BINDS",
+        "PROGRAMS",
+        "BUFFER BYTES",
+        "CULLED"
+    };
+}
+
+/***********************************************************
+ *  Get()
+ *
+ *  This method returns the counters shared by the renderer.
+ ***********************************************************/
+RenderCounters* RenderCounters::Get()
+{
+    static RenderCounters counters;
+    return &counters;
+}
+
+/***********************************************************
+ *  RenderCounters()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderCounters::RenderCounters()
+{
+    for (int i = 0; i < RENDER_COUNTER_COUNT; i++)
+    {
+        m_frameCounts[i] = 0;
+        m_lastFrameCounts[i] = 0;
+    }
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for keeping the counts of the frame
+ *  that just finished and starting the next one from zero.
+ ***********************************************************/
+void RenderCounters::BeginFrame()
+{
+    for (int i = 0; i < RENDER_COUNTER_COUNT; i++)
+    {
+        m_lastFrameCounts[i] = m_frameCounts[i];
+        m_frameCounts[i] = 0;
+    }
+}
+
+/***********************************************************
+ *  GetName()
+ *
+ *  This method returns the display name of a counter.
+ ***********************************************************/
+const char* RenderCounters::GetName(RENDER_COUNTER counter)
+{
+    if (counter < 0 || counter >= RENDER_COUNTER_COUNT)
+        return "";
+    return g_CounterNames[counter];
+}
@@ -0,0 +1,50 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendercounters.h
+// ============
+// count the draws, triangles, uniform uploads, binds, uploaded buffer
+// bytes and culled objects of every frame
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+// things counted every frame
+enum RENDER_COUNTER {
+    COUNTER_DRAW_CALLS,
+    COUNTER_TRIANGLES,
+    COUNTER_UNIFORM_UPLOADS,
+    COUNTER_TEXTURE_BINDS,
+    COUNTER_PROGRAM_SWITCHES,
+    COUNTER_BUFFER_BYTES,   // bytes written into buffers for the GPU
+    COUNTER_CULLED_OBJECTS,
+    RENDER_COUNTER_COUNT
+};
+
+class RenderCounters
+{
+public:
+    // the counters of the thread that owns the OpenGL context
+    static RenderCounters* Get();
+
+    // start counting a new frame, the counts of the finished frame
+    // stay available through GetLastFrame()
+    void BeginFrame();
+
+    void Add(RENDER_COUNTER counter, uint64_t amount) { m_frameCounts[counter] += amount; }
+    // counts of the last finished frame, and of the frame so far
+    uint64_t GetLastFrame(RENDER_COUNTER counter) const { return m_lastFrameCounts[counter]; }
+    uint64_t GetCurrentFrame(RENDER_COUNTER counter) const { return m_frameCounts[counter]; }
+
+    // short name of a counter, for reports and the stats display
+    static const char* GetName(RENDER_COUNTER counter);
+
+private:
+    RenderCounters();
+
+    uint64_t m_frameCounts[RENDER_COUNTER_COUNT];
+    uint64_t m_lastFrameCounts[RENDER_COUNTER_COUNT];
+};
@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebenchmark.cpp
+// ============
+// render generated forests from a few trees up to a million, under one to
+// ten thousand lights, offscreen and write their frame times as JSON
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "SceneBenchmark.h"
+#include "GLStateCache.h"
+#include "RenderCounters.h"
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+    // scene sizes of the sweep, every tree count runs with every light count
+    const int g_TreeCounts[] = { 10, 1000, 100000, 1000000 };
+    const int g_LightCounts[] = { 1, 10, 100, 1000, 10000 };
+
+    // frames drawn before the timing starts, so the detail levels,
+    // the draw order and the driver have settled
+    const int g_WarmupFrames = 5;
+    // animation time between two frames
+    const float g_FrameStep = 1.0f / 60.0f;
+
+    // camera at the near edge of the forest looking across it
+    const float g_CameraHeight = 6.0f;
+    const float g_CameraPitch = -15.0f;
+    const float g_CameraYaw = -90.0f;
+}
+
+/***********************************************************
+ *  SceneBenchmark()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneBenchmark::SceneBenchmark(SceneManager* pSceneManager, ViewManager* pViewManager)
+    : m_pSceneManager(pSceneManager), m_pViewManager(pViewManager), m_framebuffer(0), m_colorRenderbuffer(0),
+    m_depthRenderbuffer(0), m_width(0), m_height(0)
+{
+}
+
+/***********************************************************
+ *  ~SceneBenchmark()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneBenchmark::~SceneBenchmark()
+{
+    if (m_framebuffer != 0)
+    {
+        GLStateCache::Get()->BindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &m_framebuffer);
+    }
+    if (m_colorRenderbuffer != 0)
+        glDeleteRenderbuffers(1, &m_colorRenderbuffer);
+    if (m_depthRenderbuffer != 0)
+        glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+}
+
+/***********************************************************
+ *  CreateTarget()
+ *
+ *  This method is used for creating the offscreen framebuffer
+ *  the benchmark frames are drawn into, so nothing reaches
+ *  the window and no swap paces the frames.
+ ***********************************************************/
+bool SceneBenchmark::CreateTarget(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+
+    glGenRenderbuffers(1, &m_colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &m_depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    GLStateCache::Get()->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Benchmark framebuffer is incomplete at " << width << "x" << height << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for running the whole sweep of scene
+ *  sizes and writing the results.
+ ***********************************************************/
+bool SceneBenchmark::Run(int frameCount, const char* filename)
+{
+    if (!CreateTarget(m_pViewManager->GetWindowWidth(), m_pViewManager->GetWindowHeight()))
+        return false;
+
+    m_results.clear();
+    for (int treeCount : g_TreeCounts)
+    {
+        for (int lightCount : g_LightCounts)
+        {
+            BENCHMARK_RESULT result = RunScene(treeCount, lightCount, frameCount);
+            std::cout << "Scene benchmark " << treeCount << " trees, " << lightCount << " lights: mean "
+                << result.meanMilliseconds << " ms, p99 " << result.p99Milliseconds << " ms, "
+                << result.drawCalls << " draws, " << result.triangles << " triangles" << std::endl;
+            if (result.perDrawOverflows > 0.0)
+            {
+                std::cout << "  " << result.perDrawOverflows << " draws a frame fell back to uniforms, "
+                    << "the per-draw ring was full" << std::endl;
+            }
+            m_results.push_back(result);
+        }
+    }
+
+    GLStateCache::Get()->BindFramebuffer(GL_FRAMEBUFFER, 0);
+    return WriteResults(filename, frameCount);
+}
+
+/***********************************************************
+ *  RunScene()
+ *
+ *  This method is used for building one scene size and timing
+ *  its frames.  Every frame waits for the GPU before it ends,
+ *  so its time covers the CPU and the GPU work.
+ ***********************************************************/
+BENCHMARK_RESULT SceneBenchmark::RunScene(int treeCount, int lightCount, int frameCount)
+{
+    float halfExtent = m_pSceneManager->BuildBenchmarkScene(treeCount, lightCount);
+    m_pViewManager->SetCameraPose(glm::vec3(0.0f, g_CameraHeight, halfExtent + 5.0f), g_CameraYaw, g_CameraPitch);
+
+    BENCHMARK_RESULT result;
+    result.treeCount = treeCount;
+    result.lightCount = lightCount;
+    result.objectCount = m_pSceneManager->GetSceneObjectCount();
+
+    std::vector<float> frameTimes;
+    frameTimes.reserve(frameCount);
+    GLStateCache* stateCache = GLStateCache::Get();
+    GLuint overflowsBefore = 0;
+
+    for (int frame = 0; frame < g_WarmupFrames + frameCount; frame++)
+    {
+        auto frameStart = std::chrono::steady_clock::now();
+
+        stateCache->BeginFrame();
+        RenderCounters::Get()->BeginFrame();
+        FrameArena::Get()->Reset();
+        stateCache->BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        glViewport(0, 0, m_width, m_height);
+        stateCache->Enable(GL_DEPTH_TEST);
+        stateCache->ClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        stateCache->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        m_pViewManager->PrepareSceneView();
+        m_pSceneManager->SetViewParameters(
+            m_pViewManager->GetCameraPosition(),
+            m_pViewManager->GetPixelsPerUnit(),
+            m_pViewManager->GetViewMatrix(),
+            m_pViewManager->GetProjectionMatrix());
+        m_pSceneManager->SetFrustumPlanes(m_pViewManager->GetFrustumPlanes());
+        m_pSceneManager->UpdateScene(frame * g_FrameStep);
+        m_pSceneManager->RenderScene();
+        glFinish();
+
+        if (frame < g_WarmupFrames)
+        {
+            overflowsBefore = m_pSceneManager->GetPerDrawOverflowCount();
+            continue;
+        }
+
+        std::chrono::duration<float, std::milli> frameTime = std::chrono::steady_clock::now() - frameStart;
+        frameTimes.push_back(frameTime.count());
+
+        RenderCounters* counters = RenderCounters::Get();
+        result.drawCalls += counters->GetCurrentFrame(COUNTER_DRAW_CALLS);
+        result.triangles += counters->GetCurrentFrame(COUNTER_TRIANGLES);
+        result.culledObjects += counters->GetCurrentFrame(COUNTER_CULLED_OBJECTS);
+    }
+
+    if (frameTimes.empty())
+        return result;
+
+    double count = static_cast<double>(frameTimes.size());
+    double total = 0.0;
+    for (float frameTime : frameTimes)
+    {
+        total += frameTime;
+    }
+    result.meanMilliseconds = static_cast<float>(total / count);
+    result.drawCalls /= count;
+    result.triangles /= count;
+    result.culledObjects /= count;
+    result.perDrawOverflows = (m_pSceneManager->GetPerDrawOverflowCount() - overflowsBefore) / count;
+
+    // nearest rank percentiles
+    std::sort(frameTimes.begin(), frameTimes.end());
+    auto percentile = [&frameTimes](float fraction) {
+        size_t rank = static_cast<size_t>(ceil(fraction * frameTimes.size()));
+        return frameTimes[std::min(std::max(rank, static_cast<size_t>(1)), frameTimes.size()) - 1];
+    };
+    result.p50Milliseconds = percentile(0.50f);
+    result.p95Milliseconds = percentile(0.95f);
+    result.p99Milliseconds = percentile(0.99f);
+    return result;
+}
+
+/***********************************************************
+ *  WriteResults()
+ *
+ *  This method is used for writing the results of the sweep
+ *  as one JSON document.
+ ***********************************************************/
+bool SceneBenchmark::WriteResults(const char* filename, int frameCount) const
+{
+    std::ofstream file(filename);
+    if (!file)
+    {
+        std::cout << "Could not write the benchmark results to " << filename << std::endl;
+        return false;
+    }
+
+    file << std::fixed;
+    file << "{\n  \"frames\": " << frameCount << ",\n  \"width\": " << m_width << ",\n  \"height\": " << m_height
+        << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < m_results.size(); i++)
+    {
+        const BENCHMARK_RESULT& result = m_results[i];
+        file << "    {\"trees\": " << result.treeCount << ", \"lights\": " << result.lightCount
+            << ", \"objects\": " << result.objectCount << std::setprecision(4)
+            << ", \"mean_ms\": " << result.meanMilliseconds << ", \"p50_ms\": " << result.p50Milliseconds
+            << ", \"p95_ms\": " << result.p95Milliseconds << ", \"p99_ms\": " << result.p99Milliseconds
+            << std::setprecision(1) << ", \"draw_calls\": " << result.drawCalls << ", \"triangles\": " << result.triangles
+            << ", \"culled_objects\": " << result.culledObjects << ", \"per_draw_overflows\": " << result.perDrawOverflows
+            << ", \"uniform_fallback\": " << ((result.perDrawOverflows > 0.0) ? "true" : "false")
+            << "}" << ((i + 1 < m_results.size()) ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    if (!file)
+    {
+        std::cout << "Could not write the benchmark results to " << filename << std::endl;
+        return false;
+    }
+
+    std::cout << "Wrote the scene benchmark results to " << filename << std::endl;
+    return true;
+}
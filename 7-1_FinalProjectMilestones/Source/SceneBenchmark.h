@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebenchmark.h
+// ============
+// render generated forests from a few trees up to a million, under one to
+// ten thousand lights, offscreen and write their frame times as JSON
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+
+// BENCHMARK_RESULT structure - frame times of one scene size
+struct BENCHMARK_RESULT
+{
+    int treeCount;
+    int lightCount;
+    int objectCount;
+    float meanMilliseconds;
+    float p50Milliseconds;
+    float p95Milliseconds;
+    float p99Milliseconds;
+    double drawCalls; // per frame, averaged over the measured frames
+    double triangles;
+    double culledObjects;
+    double perDrawOverflows; // draws drawn with uniforms because the per-draw ring was full
+
+    BENCHMARK_RESULT()
+        : treeCount(0), lightCount(0), objectCount(0), meanMilliseconds(0.0f), p50Milliseconds(0.0f), p95Milliseconds(0.0f),
+        p99Milliseconds(0.0f), drawCalls(0.0), triangles(0.0), culledObjects(0.0), perDrawOverflows(0.0) {}
+};
+
+class SceneBenchmark
+{
+public:
+    // constructor
+    SceneBenchmark(SceneManager* pSceneManager, ViewManager* pViewManager);
+    // destructor
+    ~SceneBenchmark();
+
+    // render every scene size for the passed in number of frames and
+    // write the results to a JSON file, the scene is replaced
+    bool Run(int frameCount, const char* filename);
+
+private:
+    bool CreateTarget(int width, int height);
+    BENCHMARK_RESULT RunScene(int treeCount, int lightCount, int frameCount);
+    bool WriteResults(const char* filename, int frameCount) const;
+
+    SceneManager* m_pSceneManager;
+    ViewManager* m_pViewManager;
+    std::vector<BENCHMARK_RESULT> m_results;
+
+    GLuint m_framebuffer;
+    GLuint m_colorRenderbuffer;
+    GLuint m_depthRenderbuffer;
+    int m_width;
+    int m_height;
+};
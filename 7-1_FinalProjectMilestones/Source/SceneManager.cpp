@@ -7,6 +7,10 @@
 //  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
 ///////////////////////////////////////////////////////////////////////////////
 #include "SceneManager.h"
+#include "GLStateCache.h"
+#include "FrameProfiler.h"
+#include "RenderCounters.h"
+#include "FrameArena.h"
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -19,21 +23,109 @@
 
 #include <glm/gtx/transform.hpp>
 
+#include <algorithm>
+#include <random>
+
 // declaration of global variables
 namespace
 {
-    const char* g_ModelName = "model";
-    const char* g_ColorValueName = "objectColor";
-    const char* g_TextureValueName = "objectTexture";
-    const char* g_UseTextureName = "bUseTexture";
-    const char* g_UseLightingName = "bUseLighting";
-    const char* g_LightColorName = "lightColor"; // Added this line
-    const char* g_MaterialAmbientColor = "material.ambientColor";
-    const char* g_MaterialDiffuseColor = "material.diffuseColor";
-    const char* g_MaterialSpecularColor = "material.specularColor";
-    const char* g_MaterialShininess = "material.shininess";
-    const char* g_LightPosition = "light.position";
-    const char* g_ViewPosition = "viewPos";
+    // uniform names are built once, so setting a uniform in a frame
+    // does not build a string from a literal every time
+    const std::string g_ModelName = "model";
+    const std::string g_ColorValueName = "objectColor";
+    const std::string g_TextureValueName = "objectTexture";
+    const std::string g_UseTextureName = "bUseTexture";
+    const std::string g_UseLightingName = "bUseLighting";
+    const std::string g_LightColorName = "lightColor"; // Added this line
+    const std::string g_MaterialAmbientColor = "material.ambientColor";
+    const std::string g_MaterialDiffuseColor = "material.diffuseColor";
+    const std::string g_MaterialSpecularColor = "material.specularColor";
+    const std::string g_MaterialShininess = "material.shininess";
+    const std::string g_LightPosition = "light.position";
+    const std::string g_ViewName = "view";
+    const std::string g_ProjectionName = "projection";
+    const std::string g_UseLightmapName = "bUseLightmap";
+    const std::string g_UVScaleName = "UVscale";
+    const std::string g_InverseViewProjectionName = "inverseViewProjection";
+    const std::string g_ViewPositionName = "viewPosition";
+    const char* g_DrawIDName = "drawID";
+
+    // draws that fit in one frame section of the per-draw ring buffer
+    const GLuint g_MaxDrawsPerFrame = 4096;
+    // most draws a frame section grows to for a benchmark scene,
+    // about 36 MB a section, larger scenes overflow into uniforms
+    const size_t g_MaxBenchmarkDrawsPerFrame = 262144;
+    // shader storage binding point of the per-draw data
+    const GLuint g_PerDrawBinding = 0;
+
+    // overdraw measurement tags for the two pass setups
+    const int g_OverdrawTagForward = 0;
+    const int g_OverdrawTagDepthPrepass = 1;
+
+    // size of every shadow cascade, a multiple of 16
+    const int g_ShadowMapSize = 2048;
+    // point the sun lights shine toward
+    const glm::vec3 g_ShadowFocus(0.0f, 0.0f, 0.0f);
+
+    // diffuse color of the scene material, also used by the lightmap bake
+    const glm::vec3 g_SceneDiffuseColor(0.8f, 0.8f, 0.8f);
+    // baked lighting of the static surfaces, rebuilt when the scene changes
+    const char* g_LightmapCacheFile = "lightmap.cache";
+
+    // moves per object the insertion sort of the draw order may make
+    // before the order is sorted from scratch
+    const size_t g_MaxSortMovesPerObject = 8;
+
+    // triangles of the plane mesh
+    const unsigned int g_PlaneTriangleCount = 2;
+    // distance between the trees of a generated forest, and the
+    // reach of its point lights
+    const float g_BenchmarkTreeSpacing = 3.0f;
+    const float g_BenchmarkLightRadius = 6.0f;
+
+    // set a uniform of the bound program and count the upload, so
+    // the counter follows the calls that are actually made
+    void SetUniform(ShaderManager* pShader, const std::string& name, const glm::mat4& value)
+    {
+        pShader->setMat4Value(name, value);
+        RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 1);
+    }
+
+    void SetUniform(ShaderManager* pShader, const std::string& name, const glm::vec4& value)
+    {
+        pShader->setVec4Value(name, value);
+        RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 1);
+    }
+
+    void SetUniform(ShaderManager* pShader, const std::string& name, const glm::vec3& value)
+    {
+        pShader->setVec3Value(name, value);
+        RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 1);
+    }
+
+    void SetUniform(ShaderManager* pShader, const std::string& name, const glm::vec2& value)
+    {
+        pShader->setVec2Value(name, value);
+        RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 1);
+    }
+
+    void SetUniform(ShaderManager* pShader, const std::string& name, float value)
+    {
+        pShader->setFloatValue(name, value);
+        RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 1);
+    }
+
+    void SetUniform(ShaderManager* pShader, const std::string& name, int value)
+    {
+        pShader->setIntValue(name, value);
+        RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 1);
+    }
+
+    void SetSamplerUniform(ShaderManager* pShader, const std::string& name, int unit)
+    {
+        pShader->setSampler2DValue(name, unit);
+        RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 1);
+    }
 }
 
 /***********************************************************
@@ -43,7 +135,14 @@ namespace
  ***********************************************************/
 
 SceneManager::SceneManager(ShaderManager* pShaderManager)
-    : m_pShaderManager(pShaderManager), m_basicMeshes(new ShapeMeshes()), m_loadedTextures(0)
+    : m_pShaderManager(pShaderManager), m_basicMeshes(new ShapeMeshes()), m_lodMeshes(new LODMeshes()),
+    m_perDrawBuffer(new PerDrawRingBuffer()), m_animationSystem(new AnimationSystem()), m_drawIDLocation(-1), m_usePerDrawBuffer(false), m_clusterListsBuilt(false),
+    m_depthShaderManager(NULL), m_depthDrawIDLocation(-1), m_pActiveShader(pShaderManager), m_activeDrawIDLocation(-1),
+    m_depthPrepass(true), m_overdrawMeter(new OverdrawMeter()), m_overdrawReportTag(-1), m_shadedOverdraw(0.0f), m_loadedTextures(0),
+    m_clusteredLighting(new ClusteredLighting()), m_lightAssignment(new LightAssignment()), m_deferredRenderer(NULL), m_geometryDrawIDLocation(-1),
+    m_renderPath(RENDER_PATH_FORWARD), m_shadowMaps(NULL), m_shadowLightIndex(-1), m_lightmapBaker(NULL),
+    m_drawOrder(NULL), m_drawCount(0), m_cameraPosition(0.0f, 0.0f, 3.0f), m_viewMatrix(1.0f), m_projectionMatrix(1.0f), m_pixelsPerUnit(1000.0f),
+    m_frustumCulling(false), m_culledObjects(0)
 {
 }
 
@@ -57,6 +156,26 @@ SceneManager::~SceneManager()
     m_pShaderManager = NULL;
     delete m_basicMeshes;
     m_basicMeshes = NULL;
+    delete m_lodMeshes;
+    m_lodMeshes = NULL;
+    delete m_perDrawBuffer;
+    m_perDrawBuffer = NULL;
+    delete m_animationSystem;
+    m_animationSystem = NULL;
+    delete m_depthShaderManager;
+    m_depthShaderManager = NULL;
+    delete m_overdrawMeter;
+    m_overdrawMeter = NULL;
+    delete m_clusteredLighting;
+    m_clusteredLighting = NULL;
+    delete m_lightAssignment;
+    m_lightAssignment = NULL;
+    delete m_deferredRenderer;
+    m_deferredRenderer = NULL;
+    delete m_shadowMaps;
+    m_shadowMaps = NULL;
+    delete m_lightmapBaker;
+    m_lightmapBaker = NULL;
 }
 
 /***********************************************************
@@ -67,7 +186,7 @@ SceneManager::~SceneManager()
  *  generating the mipmaps, and loading the read texture into
  *  the next available texture slot in memory.
  ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
+bool SceneManager::CreateGLTexture(const char* filename, const std::string& tag)
 {
     int width = 0;
     int height = 0;
@@ -91,7 +210,7 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
         std::cout << "Successfully loaded image: " << filename << ", width: " << width << ", height: " << height << ", channels: " << colorChannels << std::endl;
 
         glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        GLStateCache::Get()->BindTexture(GL_TEXTURE_2D, textureID);
 
         // set the texture wrapping parameters
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -115,13 +234,23 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
         // generate the texture mipmaps for mapping textures to lower resolutions
         glGenerateMipmap(GL_TEXTURE_2D);
 
+        // the lightmap bake bounces light off the average color
+        glm::vec3 colorSum(0.0f);
+        int pixelCount = width * height;
+        for (int i = 0; i < pixelCount; i++)
+        {
+            const unsigned char* pixel = image + i * colorChannels;
+            colorSum += glm::vec3(pixel[0], pixel[1], pixel[2]);
+        }
+
         // free the image data from local memory
         stbi_image_free(image);
-        glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+        GLStateCache::Get()->BindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
 
         // register the loaded texture and associate it with the special tag string
         m_textureIDs[m_loadedTextures].ID = textureID;
         m_textureIDs[m_loadedTextures].tag = tag;
+        m_textureIDs[m_loadedTextures].averageColor = colorSum / (255.0f * pixelCount);
         m_loadedTextures++;
 
         return true;
@@ -144,8 +273,8 @@ void SceneManager::BindGLTextures()
     for (int i = 0; i < m_loadedTextures; i++)
     {
         // bind textures on corresponding texture units
-        glActiveTexture(GL_TEXTURE0 + i);
-        glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
+        GLStateCache::Get()->ActiveTexture(GL_TEXTURE0 + i);
+        GLStateCache::Get()->BindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
     }
 }
 
@@ -160,6 +289,7 @@ void SceneManager::DestroyGLTextures()
     for (int i = 0; i < m_loadedTextures; i++)
     {
         glDeleteTextures(1, &m_textureIDs[i].ID);
+        GLStateCache::Get()->NotifyTextureDeleted(m_textureIDs[i].ID);
     }
 }
 
@@ -169,7 +299,7 @@ void SceneManager::DestroyGLTextures()
  *  This method is used for getting an ID for the previously
  *  loaded texture bitmap associated with the passed in tag.
  ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
+int SceneManager::FindTextureID(const std::string& tag)
 {
     for (const auto& texture : m_textureIDs)
     {
@@ -185,7 +315,7 @@ int SceneManager::FindTextureID(std::string tag)
  *  This method is used for getting a slot index for the previously
  *  loaded texture bitmap associated with the passed in tag.
  ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
+int SceneManager::FindTextureSlot(const std::string& tag)
 {
     for (int i = 0; i < m_loadedTextures; i++)
     {
@@ -199,7 +329,8 @@ int SceneManager::FindTextureSlot(std::string tag)
  *  SetTransformations()
  *
  *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
+ *  using the passed in transformation values.  The matrix
+ *  is staged and uploaded with the next draw.
  ***********************************************************/
 void SceneManager::SetTransformations(
     glm::vec3 scaleXYZ,
@@ -214,10 +345,19 @@ void SceneManager::SetTransformations(
         glm::rotate(glm::mat4(1.0f), glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f)) *
         glm::scale(glm::mat4(1.0f), scaleXYZ);
 
-    if (m_pShaderManager)
-    {
-        m_pShaderManager->setMat4Value(g_ModelName, model);
-    }
+    m_drawData.model = model;
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer from
+ *  a transform component.  The cached world matrix is reused
+ *  unless the component was changed since the last frame.
+ ***********************************************************/
+void SceneManager::SetTransformations(TransformComponent& transform)
+{
+    m_drawData.model = transform.GetWorldMatrix();
 }
 
 /***********************************************************
@@ -232,13 +372,8 @@ void SceneManager::SetShaderColor(
     float blueColorValue,
     float alphaValue)
 {
-    glm::vec4 currentColor(redColorValue, greenColorValue, blueColorValue, alphaValue);
-
-    if (m_pShaderManager)
-    {
-        m_pShaderManager->setIntValue(g_UseTextureName, false);
-        m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-    }
+    m_drawData.color = glm::vec4(redColorValue, greenColorValue, blueColorValue, alphaValue);
+    m_drawData.useTexture = false;
 }
 
 /***********************************************************
@@ -247,18 +382,15 @@ void SceneManager::SetShaderColor(
  *  This method is used for setting the texture data
  *  associated with the passed in ID into the shader.
  ***********************************************************/
-void SceneManager::SetShaderTexture(std::string textureTag)
+void SceneManager::SetShaderTexture(const std::string& textureTag)
 {
-    if (m_pShaderManager)
+    // every loaded texture stays bound to its own slot, so only
+    // the slot index has to reach the shader
+    int textureSlot = FindTextureSlot(textureTag);
+    if (textureSlot != -1)
     {
-        m_pShaderManager->setIntValue(g_UseTextureName, true);
-        int textureSlot = FindTextureSlot(textureTag);
-        if (textureSlot != -1)
-        {
-            glActiveTexture(GL_TEXTURE0 + textureSlot);
-            glBindTexture(GL_TEXTURE_2D, m_textureIDs[textureSlot].ID);
-            m_pShaderManager->setSampler2DValue(g_TextureValueName, textureSlot);
-        }
+        m_drawData.useTexture = true;
+        m_drawData.textureSlot = textureSlot;
     }
 }
 
@@ -270,9 +402,78 @@ void SceneManager::SetShaderTexture(std::string textureTag)
  ***********************************************************/
 void SceneManager::SetTextureUVScale(float u, float v)
 {
-    if (m_pShaderManager)
+    m_drawData.uvScale = glm::vec2(u, v);
+}
+
+/***********************************************************
+ *  SubmitDrawData()
+ *
+ *  This method is used for handing the staged per-draw values
+ *  to the shader right before a draw.  They are written into
+ *  the mapped ring buffer and only the draw ID is set, or
+ *  uploaded as individual uniforms when the ring buffer is
+ *  unavailable or the frame section is full.
+ ***********************************************************/
+void SceneManager::SubmitDrawData()
+{
+    GLStateCache::Get()->NotifyDraw();
+
+    GLint drawID = -1;
+    if (m_usePerDrawBuffer)
+    {
+        drawID = m_perDrawBuffer->PushDraw(m_drawData);
+        glUniform1i(m_activeDrawIDLocation, drawID);
+        RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 1);
+    }
+
+    // the forward shader reads the cluster lists for draws without
+    // a complete light list of their own
+    if (m_pActiveShader == m_pShaderManager && !m_drawData.useLightmap && (drawID < 0 || m_drawData.lightCount < 0))
+        EnsureClusterLists();
+
+    if (drawID < 0)
+        UploadDrawUniforms();
+}
+
+/***********************************************************
+ *  EnsureClusterLists()
+ *
+ *  This method is used for building the cluster light lists
+ *  the first time a pass or draw of the frame needs them.
+ *  The lists stay bound under the same buffer names, so a
+ *  program bound before the build reads the new lists.
+ ***********************************************************/
+void SceneManager::EnsureClusterLists()
+{
+    if (m_clusterListsBuilt)
+        return;
+
+    m_clusteredLighting->BuildClusters();
+    m_clusterListsBuilt = true;
+}
+
+/***********************************************************
+ *  UploadDrawUniforms()
+ *
+ *  This method is used for setting the staged per-draw values
+ *  into the active shader through individual uniforms.
+ ***********************************************************/
+void SceneManager::UploadDrawUniforms()
+{
+    if (m_pActiveShader)
     {
-        m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
+        SetUniform(m_pActiveShader, g_ModelName, m_drawData.model);
+        SetUniform(m_pActiveShader, g_UseTextureName, m_drawData.useTexture);
+        SetUniform(m_pActiveShader, g_UseLightmapName, m_drawData.useLightmap);
+        if (m_drawData.useTexture)
+        {
+            SetSamplerUniform(m_pActiveShader, g_TextureValueName, m_drawData.textureSlot);
+            SetUniform(m_pActiveShader, g_UVScaleName, m_drawData.uvScale);
+        }
+        else
+        {
+            SetUniform(m_pActiveShader, g_ColorValueName, m_drawData.color);
+        }
     }
 }
 
@@ -293,22 +494,470 @@ void SceneManager::SetLightColor(float red, float green, float blue, float alpha
 /***********************************************************
  *  SetLightSource()
  *
- *  This method is used for setting the light source parameters
+ *  This method is used for setting the light source parameters.
+ *  The lights reach the shader through the cluster light lists
+ *  that are rebuilt every frame.
  ***********************************************************/
 void SceneManager::SetLightSource(int index, const LIGHT_SOURCE& light)
 {
-    if (index < 0 || index >= 4)
+    if (index < 0)
         return;
 
+    if (index >= static_cast<int>(m_lightSources.size()))
+        m_lightSources.resize(index + 1);
     m_lightSources[index] = light;
+}
+
+/***********************************************************
+ *  AddLight()
+ *
+ *  This method is used for adding a light after the existing
+ *  ones and returns its index.
+ ***********************************************************/
+int SceneManager::AddLight(const LIGHT_SOURCE& light)
+{
+    m_lightSources.push_back(light);
+    return static_cast<int>(m_lightSources.size()) - 1;
+}
+
+/***********************************************************
+ *  SetViewParameters()
+ *
+ *  This method is used for passing the camera position and
+ *  projection scale used to sort the objects and choose the
+ *  detail levels, and the matrices for the depth pre-pass.
+ ***********************************************************/
+void SceneManager::SetViewParameters(glm::vec3 cameraPosition, float pixelsPerUnit, const glm::mat4& view, const glm::mat4& projection)
+{
+    m_cameraPosition = cameraPosition;
+    m_pixelsPerUnit = pixelsPerUnit;
+    m_viewMatrix = view;
+    m_projectionMatrix = projection;
+}
+
+/***********************************************************
+ *  SetFrustumPlanes()
+ *
+ *  This method is used for passing the world space planes of
+ *  the view frustum, which turns on culling the objects that
+ *  lie outside of it.
+ ***********************************************************/
+void SceneManager::SetFrustumPlanes(const glm::vec4 planes[FRUSTUM_PLANE_COUNT])
+{
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++)
+    {
+        m_frustumPlanes[i] = planes[i];
+    }
+    m_frustumCulling = true;
+}
+
+/***********************************************************
+ *  SetDepthPrepass()
+ *
+ *  This method is used for turning the depth pre-pass on or
+ *  off.  The overdraw of the new setup is printed once it has
+ *  been measured.
+ ***********************************************************/
+void SceneManager::SetDepthPrepass(bool enabled)
+{
+    m_depthPrepass = enabled;
+    m_overdrawReportTag = enabled ? g_OverdrawTagDepthPrepass : g_OverdrawTagForward;
+    std::cout << "Depth pre-pass " << (enabled ? "on" : "off") << std::endl;
+}
+
+/***********************************************************
+ *  AddSceneObject()
+ *
+ *  This method is used for adding an object to the list of
+ *  objects drawn every frame.  The returned object can be
+ *  given its texture or color before the next object is added.
+ ***********************************************************/
+SCENE_OBJECT& SceneManager::AddSceneObject(
+    SCENE_SHAPE shape,
+    glm::vec3 scaleXYZ,
+    glm::vec3 rotationDegrees,
+    glm::vec3 positionXYZ)
+{
+    SCENE_OBJECT object;
+    object.shape = shape;
+    // the planes only receive shadows
+    object.castsShadow = (shape != SHAPE_PLANE);
+    object.transform = TransformComponent(scaleXYZ, rotationDegrees, positionXYZ);
+
+    m_sceneObjects.push_back(object);
+    return m_sceneObjects.back();
+}
+
+/***********************************************************
+ *  GetBoundingSphere()
+ *
+ *  This method is used for finding a sphere around a scene
+ *  object in world space.
+ ***********************************************************/
+void SceneManager::GetBoundingSphere(const SCENE_OBJECT& object, glm::vec3& center, float& radius) const
+{
+    glm::vec3 scaleXYZ = object.transform.GetScale();
+    center = object.transform.GetPosition();
+
+    if (object.shape == SHAPE_PLANE)
+    {
+        // the plane mesh spans -1 to 1 on X and Z
+        radius = sqrt(scaleXYZ.x * scaleXYZ.x + scaleXYZ.z * scaleXYZ.z);
+    }
+    else if (object.shape == SHAPE_SPHERE)
+    {
+        radius = glm::max(scaleXYZ.x, glm::max(scaleXYZ.y, scaleXYZ.z));
+    }
+    else
+    {
+        // cylinders and cones sit on the XZ plane of their position
+        float halfHeight = 0.5f * scaleXYZ.y;
+        float baseRadius = glm::max(scaleXYZ.x, scaleXYZ.z);
+        center.y += halfHeight;
+        radius = sqrt(baseRadius * baseRadius + halfHeight * halfHeight);
+    }
+}
+
+/***********************************************************
+ *  UpdateDrawOrder()
+ *
+ *  This method is used for choosing the detail level and the
+ *  lights of every object for this frame and sorting them from
+ *  the nearest to the farthest, so the depth test rejects as
+ *  many hidden fragments as possible.  The levels are picked
+ *  once here so every pass draws the same meshes.  Objects
+ *  outside the view frustum are left out of the draw order,
+ *  the shadow passes still reach them through their cascades.
+ ***********************************************************/
+void SceneManager::UpdateDrawOrder()
+{
+    PROFILE_SCOPE("UpdateDrawOrder");
+
+    for (auto& object : m_sceneObjects)
+    {
+        glm::vec3 center;
+        float radius = 0.0f;
+        GetBoundingSphere(object, center, radius);
+        object.viewDistance = glm::length(center - m_cameraPosition);
+
+        // a sphere entirely behind any plane is out of view
+        object.visible = true;
+        for (int i = 0; m_frustumCulling && i < FRUSTUM_PLANE_COUNT; i++)
+        {
+            if (glm::dot(glm::vec3(m_frustumPlanes[i]), center) + m_frustumPlanes[i].w < -radius)
+            {
+                object.visible = false;
+                break;
+            }
+        }
+
+        if (object.shape != SHAPE_PLANE)
+        {
+            float projectedSize = LODMeshes::ProjectedScreenSize(radius, object.viewDistance, m_pixelsPerUnit);
+            object.lodLevel = LODMeshes::SelectLODLevel(object.lodLevel, projectedSize);
+        }
+
+        // baked and culled surfaces take no lights at runtime, and an
+        // object reached by more lights than its list holds is lit
+        // from the cluster lists, so no light is ever left out
+        object.lightCount = 0;
+        if (!object.useLightmap && object.visible)
+        {
+            int sceneLights[MAX_DRAW_LIGHTS];
+            int lightCount = m_lightAssignment->Query(center, radius, sceneLights);
+            if (lightCount > MAX_DRAW_LIGHTS)
+            {
+                object.lightCount = -1;
+                continue;
+            }
+            for (int i = 0; i < lightCount; i++)
+            {
+                GLint bufferIndex = m_clusteredLighting->GetBufferIndex(sceneLights[i]);
+                if (bufferIndex != -1)
+                    object.lightIndices[object.lightCount++] = bufferIndex;
+            }
+        }
+    }
+
+    if (m_sortOrder.size() != m_sceneObjects.size())
+    {
+        m_sortOrder.resize(m_sceneObjects.size());
+        for (size_t i = 0; i < m_sortOrder.size(); i++)
+        {
+            m_sortOrder[i] = i;
+        }
+    }
+
+    // last frame's order is nearly sorted already, which an insertion
+    // sort finishes in close to linear time - a camera jump that moves
+    // too many objects hands the rest of the work to std::sort
+    const std::vector<SCENE_OBJECT>& objects = m_sceneObjects;
+    size_t movesLeft = m_sortOrder.size() * g_MaxSortMovesPerObject;
+    for (size_t i = 1; i < m_sortOrder.size() && movesLeft > 0; i++)
+    {
+        size_t index = m_sortOrder[i];
+        float distance = objects[index].viewDistance;
+        size_t slot = i;
+        while (slot > 0 && objects[m_sortOrder[slot - 1]].viewDistance > distance && movesLeft > 0)
+        {
+            m_sortOrder[slot] = m_sortOrder[slot - 1];
+            slot--;
+            movesLeft--;
+        }
+        m_sortOrder[slot] = index;
+    }
+    if (movesLeft == 0)
+    {
+        std::sort(m_sortOrder.begin(), m_sortOrder.end(),
+            [&objects](size_t a, size_t b) { return objects[a].viewDistance < objects[b].viewDistance; });
+    }
+
+    // only the objects in view are drawn, the list lives until
+    // the frame arena is reset for the next frame
+    m_drawOrder = FrameArena::Get()->AllocateArray<size_t>(m_sortOrder.size());
+    m_drawCount = 0;
+    for (size_t index : m_sortOrder)
+    {
+        if (objects[index].visible)
+            m_drawOrder[m_drawCount++] = index;
+    }
+    m_culledObjects = static_cast<int>(m_sortOrder.size() - m_drawCount);
+    RenderCounters::Get()->Add(COUNTER_CULLED_OBJECTS, m_culledObjects);
+}
+
+/***********************************************************
+ *  DrawSceneObject()
+ *
+ *  This method is used for drawing one scene object with the
+ *  active shader.  The round shapes use the detail level
+ *  picked by UpdateDrawOrder() for this frame.
+ ***********************************************************/
+void SceneManager::DrawSceneObject(SCENE_OBJECT& object)
+{
+    // animated objects take the matrix from the last animation update
+    if (object.animationIndex != -1)
+        m_drawData.model = m_animationSystem->GetInstanceMatrix(object.animationIndex);
+    else
+        SetTransformations(object.transform);
+    if (object.textureSlot != -1)
+    {
+        m_drawData.useTexture = true;
+        m_drawData.textureSlot = object.textureSlot;
+        SetTextureUVScale(1.0f, 1.0f);
+    }
+    else
+    {
+        m_drawData.color = object.color;
+        m_drawData.useTexture = false;
+    }
+    m_drawData.useLightmap = object.useLightmap;
+    m_drawData.lightCount = object.lightCount;
+    std::copy(object.lightIndices, object.lightIndices + std::max(object.lightCount, 0), m_drawData.lightIndices);
+
+    if (object.shape == SHAPE_PLANE)
+    {
+        SubmitDrawData();
+        m_basicMeshes->DrawPlaneMesh();
+        RenderCounters::Get()->Add(COUNTER_DRAW_CALLS, 1);
+        RenderCounters::Get()->Add(COUNTER_TRIANGLES, g_PlaneTriangleCount);
+        return;
+    }
+
+    LOD_Shape lodShape = LOD_SPHERE;
+    if (object.shape == SHAPE_CYLINDER)
+        lodShape = LOD_CYLINDER;
+    else if (object.shape == SHAPE_CONE)
+        lodShape = LOD_CONE;
+
+    m_lodMeshes->ApplyPositionDequantization(lodShape, object.lodLevel, m_drawData.model);
+
+    SubmitDrawData();
+    m_lodMeshes->DrawLODMesh(lodShape, object.lodLevel);
+}
+
+/***********************************************************
+ *  ReportOverdraw()
+ *
+ *  This method is used for collecting the latest overdraw
+ *  measurement, printing it when it is the first one taken
+ *  with the current pass setup.
+ ***********************************************************/
+void SceneManager::ReportOverdraw()
+{
+    GLuint64 samplesPassed = 0;
+    int tag = 0;
+    if (!m_overdrawMeter->TakeResult(samplesPassed, tag))
+        return;
+
+    GLint viewport[4] = { 0, 0, 0, 0 };
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLint pixels = viewport[2] * viewport[3];
+    if (pixels <= 0)
+        return;
+
+    m_shadedOverdraw = static_cast<float>(samplesPassed) / pixels;
+
+    if (tag == m_overdrawReportTag)
+    {
+        std::cout << "Overdraw " << (tag == g_OverdrawTagDepthPrepass ? "with" : "without")
+            << " depth pre-pass: " << m_shadedOverdraw << " shaded fragments per pixel" << std::endl;
+        m_overdrawReportTag = -1;
+    }
+}
+
+/***********************************************************
+ *  RunVertexFormatBenchmark()
+ *
+ *  This method is used for comparing the float and packed
+ *  vertex formats.  The finest sphere is drawn the passed in
+ *  number of times with each format, small enough on screen
+ *  that the vertex work dominates, and the GPU time and the
+ *  buffer memory of both formats are printed.
+ ***********************************************************/
+void SceneManager::RunVertexFormatBenchmark(int drawCount)
+{
+    LODMeshes floatMeshes(LOD_FORMAT_FLOAT);
+    floatMeshes.LoadSphereLODs();
+
+    const LODMeshes* formatMeshes[2] = { &floatMeshes, m_lodMeshes };
+    const char* formatNames[2] = { "float", "packed" };
+
+    GLStateCache::Get()->UseProgram(m_pShaderManager->m_programID);
+    GLStateCache::Get()->Enable(GL_DEPTH_TEST);
+    GLStateCache::Get()->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    GLuint timerQuery = 0;
+    glGenQueries(1, &timerQuery);
+
+    int vertexCount = floatMeshes.GetTriangleCount(LOD_SPHERE, 0) * 3;
+
+    for (int format = 0; format < 2; format++)
+    {
+        if (m_usePerDrawBuffer)
+        {
+            m_perDrawBuffer->BeginFrame();
+            m_perDrawBuffer->BindFrameSection(g_PerDrawBinding);
+        }
+
+        // every draw reuses the same per-draw data
+        SetShaderColor(1.0f, 1.0f, 1.0f, 1.0f);
+        SetTransformations(glm::vec3(0.01f), 0.0f, 0.0f, 0.0f, m_cameraPosition + glm::vec3(0.0f, 0.0f, -2.0f));
+        formatMeshes[format]->ApplyPositionDequantization(LOD_SPHERE, 0, m_drawData.model);
+        SubmitDrawData();
+
+        glFinish();
+        glBeginQuery(GL_TIME_ELAPSED, timerQuery);
+        for (int i = 0; i < drawCount; i++)
+        {
+            formatMeshes[format]->DrawLODMesh(LOD_SPHERE, 0);
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+
+        if (m_usePerDrawBuffer)
+        {
+            m_perDrawBuffer->EndFrame();
+        }
+
+        GLuint64 elapsedNanoseconds = 0;
+        glGetQueryObjectui64v(timerQuery, GL_QUERY_RESULT, &elapsedNanoseconds);
+
+        double milliseconds = elapsedNanoseconds / 1.0e6;
+        double verticesPerSecond = (static_cast<double>(vertexCount) * drawCount) / (elapsedNanoseconds / 1.0e9);
+
+        std::cout << "Vertex format " << formatNames[format] << ": "
+            << drawCount << " draws in " << milliseconds << " ms, "
+            << verticesPerSecond / 1.0e6 << " M vertices/s, "
+            << formatMeshes[format]->GetBufferBytes() << " bytes of buffer memory" << std::endl;
+    }
+
+    glDeleteQueries(1, &timerQuery);
+}
+
+/***********************************************************
+ *  BuildBenchmarkScene()
+ *
+ *  This method is used for replacing the scene with a forest
+ *  of spinning trees on a square grid over a ground plane,
+ *  lit by a sun and point lights scattered over the forest.
+ *  The layout comes from a fixed seed, so every run of the
+ *  same size draws the same scene.  Nothing is baked, every
+ *  surface is lit at runtime.
+ ***********************************************************/
+float SceneManager::BuildBenchmarkScene(int treeCount, int lightCount)
+{
+    m_sceneObjects.clear();
+    m_sortOrder.clear();
+    m_drawOrder = NULL;
+    m_drawCount = 0;
+    m_animationSystem->Clear();
+    m_lightSources.clear();
+    if (m_shadowMaps != NULL)
+        m_shadowMaps->InvalidateStaticCache();
+
+    std::mt19937 random(330);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    int side = static_cast<int>(ceil(sqrt(static_cast<double>(std::max(treeCount, 1)))));
+    float halfExtent = 0.5f * side * g_BenchmarkTreeSpacing;
+    m_sceneObjects.reserve(2 * static_cast<size_t>(treeCount) + 1);
+
+    SCENE_OBJECT* object = &AddSceneObject(SHAPE_PLANE, glm::vec3(halfExtent + g_BenchmarkTreeSpacing, 1.0f, halfExtent + g_BenchmarkTreeSpacing),
+        glm::vec3(0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+    object->textureSlot = FindTextureSlot("grass");
+
+    for (int i = 0; i < treeCount; i++)
+    {
+        // a small jitter keeps the rows from lining up perfectly
+        glm::vec3 treePos(
+            -halfExtent + ((i % side) + 0.25f + 0.5f * unit(random)) * g_BenchmarkTreeSpacing,
+            -1.0f,
+            -halfExtent + ((i / side) + 0.25f + 0.5f * unit(random)) * g_BenchmarkTreeSpacing);
+
+        object = &AddSceneObject(SHAPE_CYLINDER, glm::vec3(0.5f, 3.0f, 0.5f), glm::vec3(0.0f), treePos);
+        object->textureSlot = FindTextureSlot("bark");
+        object->animationIndex = m_animationSystem->AddSpinningInstance(
+            object->transform.GetScale(), object->transform.GetPosition(), 1.0f);
+
+        object = &AddSceneObject(SHAPE_CONE, glm::vec3(2.0f, 3.0f, 2.0f), glm::vec3(0.0f), treePos + glm::vec3(0.0f, 1.5f, 0.0f));
+        object->textureSlot = FindTextureSlot("leaves");
+        object->animationIndex = m_animationSystem->AddSpinningInstance(
+            object->transform.GetScale(), object->transform.GetPosition(), 1.0f);
+    }
+
+    LIGHT_SOURCE sun;
+    sun.position = glm::vec3(-10.0f, 50.0f, -20.0f);
+    sun.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
+    sun.diffuseColor = glm::vec3(0.8f, 0.8f, 0.7f);
+    sun.specularColor = glm::vec3(0.8f, 0.8f, 0.7f);
+    sun.focalStrength = 0.2f;
+    sun.specularIntensity = 0.2f;
+    AddLight(sun);
+
+    for (int i = 1; i < lightCount; i++)
+    {
+        LIGHT_SOURCE light;
+        light.position = glm::vec3(
+            -halfExtent + 2.0f * halfExtent * unit(random),
+            1.0f + 2.0f * unit(random),
+            -halfExtent + 2.0f * halfExtent * unit(random));
+        light.diffuseColor = glm::vec3(unit(random), unit(random), unit(random));
+        light.specularColor = light.diffuseColor;
+        light.focalStrength = 0.2f;
+        light.specularIntensity = 0.2f;
+        light.radius = g_BenchmarkLightRadius;
+        AddLight(light);
+    }
 
-    std::string lightIndex = "lightSources[" + std::to_string(index) + "].";
-    m_pShaderManager->setVec3Value(lightIndex + "position", light.position);
-    m_pShaderManager->setVec3Value(lightIndex + "ambientColor", light.ambientColor);
-    m_pShaderManager->setVec3Value(lightIndex + "diffuseColor", light.diffuseColor);
-    m_pShaderManager->setVec3Value(lightIndex + "specularColor", light.specularColor);
-    m_pShaderManager->setFloatValue(lightIndex + "focalStrength", light.focalStrength);
-    m_pShaderManager->setFloatValue(lightIndex + "specularIntensity", light.specularIntensity);
+    // every object can be drawn once for each shadow cascade, the
+    // depth pre-pass and the lit pass, so the ring is grown to hold
+    // that many draws a frame instead of falling back to uniforms
+    if (m_usePerDrawBuffer)
+    {
+        size_t drawsPerFrame = std::min(m_sceneObjects.size() * (SHADOW_CASCADE_COUNT + 2), g_MaxBenchmarkDrawsPerFrame);
+        if (drawsPerFrame > m_perDrawBuffer->GetMaxDraws())
+            m_usePerDrawBuffer = m_perDrawBuffer->Resize(static_cast<GLuint>(drawsPerFrame));
+    }
+    return halfExtent;
 }
 
 /***********************************************************
@@ -325,9 +974,13 @@ void SceneManager::PrepareScene()
     // in the rendered 3D scene
 
     m_basicMeshes->LoadPlaneMesh();
-    m_basicMeshes->LoadCylinderMesh();
-    m_basicMeshes->LoadConeMesh();
-    m_basicMeshes->LoadSphereMesh(); // Ensure you have this method to load a sphere mesh
+
+    // the round shapes are drawn from detail level chains
+    m_lodMeshes->LoadCylinderLODs();
+    m_lodMeshes->LoadConeLODs();
+    m_lodMeshes->LoadSphereLODs();
+    std::cout << "Detail level meshes use " << m_lodMeshes->GetBufferBytes() << " bytes of buffer memory ("
+        << m_lodMeshes->GetFloatFormatBytes() << " with float vertices)" << std::endl;
 
     // Load textures
     CreateGLTexture("textures/bark.jpg", "bark");
@@ -336,6 +989,159 @@ void SceneManager::PrepareScene()
     CreateGLTexture("textures/leaves.jpg", "leaves");
     CreateGLTexture("textures/sky.jpg", "sky"); // Load sky texture
 
+    // bind every texture to its own slot once, draws only pick a slot
+    BindGLTextures();
+    for (int i = 0; i < m_loadedTextures; i++)
+    {
+        m_pShaderManager->setSampler2DValue("objectTextures[" + std::to_string(i) + "]", i);
+    }
+
+    // per-draw values go through the mapped ring buffer when both the
+    // context and the active shader support it
+    m_drawIDLocation = glGetUniformLocation(m_pShaderManager->m_programID, g_DrawIDName);
+    m_usePerDrawBuffer = (m_drawIDLocation != -1) && m_perDrawBuffer->Create(g_MaxDrawsPerFrame);
+    m_pActiveShader = m_pShaderManager;
+    m_activeDrawIDLocation = m_drawIDLocation;
+
+    // the depth pre-pass lays down the final depth with a program
+    // that does no shading, so the lit pass only shades visible
+    // fragments
+    m_depthShaderManager = new ShaderManager();
+    m_depthShaderManager->LoadShaders(
+        "shaders/depthVertexShader.glsl",
+        "shaders/depthFragmentShader.glsl");
+    if (m_depthShaderManager->m_programID == 0)
+    {
+        std::cout << "Depth pre-pass shaders failed to load, the pre-pass is disabled" << std::endl;
+        delete m_depthShaderManager;
+        m_depthShaderManager = NULL;
+        m_depthPrepass = false;
+    }
+    else
+    {
+        m_depthDrawIDLocation = glGetUniformLocation(m_depthShaderManager->m_programID, g_DrawIDName);
+    }
+    m_overdrawMeter->Create();
+    m_clusteredLighting->Create();
+
+    // the deferred path draws with its own programs, which need the
+    // same texture slots as the forward shader
+    m_deferredRenderer = new DeferredRenderer();
+    if (m_deferredRenderer->Create())
+    {
+        ShaderManager* pGeometryShader = m_deferredRenderer->GetGeometryShader();
+        GLStateCache::Get()->UseProgram(pGeometryShader->m_programID);
+        for (int i = 0; i < m_loadedTextures; i++)
+        {
+            pGeometryShader->setSampler2DValue("objectTextures[" + std::to_string(i) + "]", i);
+        }
+        m_geometryDrawIDLocation = glGetUniformLocation(pGeometryShader->m_programID, g_DrawIDName);
+    }
+    else
+    {
+        delete m_deferredRenderer;
+        m_deferredRenderer = NULL;
+        m_renderPath = RENDER_PATH_FORWARD;
+    }
+
+    // the shadow casters are drawn with the depth program
+    if (m_depthShaderManager != NULL)
+    {
+        m_shadowMaps = new CascadedShadowMaps();
+        if (!m_shadowMaps->Create(g_ShadowMapSize))
+        {
+            delete m_shadowMaps;
+            m_shadowMaps = NULL;
+        }
+    }
+    GLStateCache::Get()->UseProgram(m_pShaderManager->m_programID);
+    m_overdrawReportTag = m_depthPrepass ? g_OverdrawTagDepthPrepass : g_OverdrawTagForward;
+
+    // the static objects keep the world matrix built here for as
+    // long as they are not moved
+    SCENE_OBJECT* object = NULL;
+
+    // Grass Floor Plane
+    object = &AddSceneObject(SHAPE_PLANE, glm::vec3(25.0f, 5.0f, 36.0f), glm::vec3(0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+    object->textureSlot = FindTextureSlot("grass");
+    object->useLightmap = true;
+
+    // Water Plane - aligned with the grass plane
+    object = &AddSceneObject(SHAPE_PLANE, glm::vec3(25.0f, 1.0f, 2.0f), glm::vec3(0.0f), glm::vec3(0.0f, -0.5f, 0.0f));
+    object->textureSlot = FindTextureSlot("water");
+    object->useLightmap = true;
+
+    // Suns - orange color, they are light sources and cast no shadow
+    object = &AddSceneObject(SHAPE_SPHERE, glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f), glm::vec3(-10.0f, 10.0f, -20.0f));
+    object->color = glm::vec4(1.0f, 0.5f, 0.0f, 1.0f);
+    object->castsShadow = false;
+    object = &AddSceneObject(SHAPE_SPHERE, glm::vec3(1.5f, 1.5f, 1.5f), glm::vec3(0.0f), glm::vec3(-8.0f, 8.0f, -22.0f));
+    object->color = glm::vec4(1.0f, 0.5f, 0.0f, 1.0f);
+    object->castsShadow = false;
+    object = &AddSceneObject(SHAPE_SPHERE, glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(0.0f), glm::vec3(10.0f, 9.0f, -18.0f));
+    object->color = glm::vec4(1.0f, 0.5f, 0.0f, 1.0f);
+    object->castsShadow = false;
+
+    // Mountains - shades of brown
+    object = &AddSceneObject(SHAPE_CONE, glm::vec3(10.0f, 5.0f, 10.0f), glm::vec3(0.0f), glm::vec3(-10.0f, 0.0f, -20.0f));
+    object->color = glm::vec4(0.5f, 0.35f, 0.05f, 1.0f);
+    object->useLightmap = true;
+    object = &AddSceneObject(SHAPE_CONE, glm::vec3(8.0f, 4.0f, 8.0f), glm::vec3(0.0f), glm::vec3(10.0f, 0.0f, -15.0f));
+    object->color = glm::vec4(0.55f, 0.4f, 0.1f, 1.0f);
+    object->useLightmap = true;
+    object = &AddSceneObject(SHAPE_CONE, glm::vec3(12.0f, 6.0f, 12.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -25.0f));
+    object->color = glm::vec4(0.6f, 0.45f, 0.15f, 1.0f);
+    object->useLightmap = true;
+
+    // Trees
+    const glm::vec3 treePositions[] = {
+        glm::vec3(10.0f, -1.0f, 5.0f),
+        glm::vec3(15.0f, -1.0f, 8.0f),
+        glm::vec3(18.0f, -1.0f, 3.0f),
+        glm::vec3(-10.0f, -1.0f, 5.0f),
+        glm::vec3(-15.0f, -1.0f, 8.0f),
+        glm::vec3(-18.0f, -1.0f, 3.0f),
+        glm::vec3(10.0f, -1.0f, -5.0f),
+        glm::vec3(15.0f, -1.0f, -8.0f),
+        glm::vec3(18.0f, -1.0f, -3.0f),
+        glm::vec3(-10.0f, -1.0f, -5.0f),
+        glm::vec3(-15.0f, -1.0f, -8.0f),
+        glm::vec3(-18.0f, -1.0f, -3.0f),
+        // Additional trees for more variety
+        glm::vec3(-3.0f, -1.0f, 2.0f),
+        glm::vec3(3.0f, -1.0f, -2.0f),
+        glm::vec3(-7.0f, -1.0f, 3.0f),
+        glm::vec3(7.0f, -1.0f, -3.0f),
+        glm::vec3(-2.0f, -1.0f, -4.0f),
+        glm::vec3(2.0f, -1.0f, 4.0f),
+        glm::vec3(-6.0f, -1.0f, -3.0f),
+        glm::vec3(6.0f, -1.0f, 3.0f),
+        glm::vec3(15.0f, -1.0f, 10.0f),
+        glm::vec3(-15.0f, -1.0f, -10.0f),
+        glm::vec3(20.0f, -1.0f, 12.0f),
+        glm::vec3(-20.0f, -1.0f, -12.0f)
+    };
+
+    // the trees spin around their trunks at one radian per second
+    for (const auto& treePos : treePositions)
+    {
+        // Tree Trunk
+        object = &AddSceneObject(SHAPE_CYLINDER, glm::vec3(0.5f, 3.0f, 0.5f), glm::vec3(0.0f), treePos);
+        object->textureSlot = FindTextureSlot("bark");
+        object->animationIndex = m_animationSystem->AddSpinningInstance(
+            object->transform.GetScale(), object->transform.GetPosition(), 1.0f);
+
+        // Tree Cone
+        object = &AddSceneObject(SHAPE_CONE, glm::vec3(2.0f, 3.0f, 2.0f), glm::vec3(0.0f), treePos + glm::vec3(0.0f, 1.5f, 0.0f));
+        object->textureSlot = FindTextureSlot("leaves");
+        object->animationIndex = m_animationSystem->AddSpinningInstance(
+            object->transform.GetScale(), object->transform.GetPosition(), 1.0f);
+    }
+
+    // Plane aligned with Grass Plane - rotated to face up as a background
+    object = &AddSceneObject(SHAPE_PLANE, glm::vec3(25.0f, 5.0f, 10.0f), glm::vec3(90.0f, 0.0f, 0.0f), glm::vec3(0.0f, 9.0f, -36.0f));
+    object->textureSlot = FindTextureSlot("sky");
+
     // Set up light sources
     LIGHT_SOURCE light1;
     light1.position = glm::vec3(-10.0f, 50.0f, -20.0f);
@@ -363,206 +1169,349 @@ void SceneManager::PrepareScene()
     light3.focalStrength = 0.2f;
     light3.specularIntensity = 0.2f;
     SetLightSource(2, light3);
+
+    BakeLightmap();
 }
 
 /***********************************************************
- *  RenderScene()
+ *  BakeLightmap()
  *
- *  This method is used for rendering the 3D scene by
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for lighting the static surfaces ahead
+ *  of time.  The lightmap is loaded from the cache file when
+ *  the surfaces and lights match the last bake, so only the
+ *  first start after a change pays for the bake.  Lights
+ *  changed after this are not seen by the static surfaces.
  ***********************************************************/
-void SceneManager::RenderScene()
+void SceneManager::BakeLightmap()
 {
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
+    m_lightmapBaker = new LightmapBaker();
+    for (const auto& object : m_sceneObjects)
+    {
+        if (!object.useLightmap)
+            continue;
 
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        BAKE_SURFACE surface;
+        surface.shape = (object.shape == SHAPE_PLANE) ? BAKE_PLANE : BAKE_CONE;
+        surface.position = object.transform.GetPosition();
+        surface.scale = object.transform.GetScale();
+        surface.albedo = (object.textureSlot != -1) ? m_textureIDs[object.textureSlot].averageColor : glm::vec3(object.color);
+        m_lightmapBaker->AddSurface(surface);
+    }
 
-    glm::vec3 scaleXYZ;
-    float XrotationDegrees = 0.0f;
-    float YrotationDegrees = 0.0f;
-    float ZrotationDegrees = 0.0f;
-    glm::vec3 positionXYZ;
+    // the shadowed light adds its direct light at runtime, so the
+    // moving objects still cast onto the static surfaces
+    int separateLightIndex = -1;
+    if (m_shadowMaps != NULL && !m_lightSources.empty() && m_lightSources[0].radius <= 0.0f)
+        separateLightIndex = 0;
 
-    m_pShaderManager->use();
+    if (!m_lightmapBaker->Build(m_lightSources, g_SceneDiffuseColor, separateLightIndex, g_LightmapCacheFile))
+    {
+        delete m_lightmapBaker;
+        m_lightmapBaker = NULL;
+        for (auto& object : m_sceneObjects)
+        {
+            object.useLightmap = false;
+        }
+    }
+}
 
-    // Set the light and view positions
-    glm::vec3 viewPos = glm::vec3(0.0f, 0.0f, 3.0f); // Example view position
-    m_pShaderManager->setVec3Value(g_ViewPosition, viewPos);
+/***********************************************************
+ *  UpdateScene()
+ *
+ *  This method is used for advancing the animated objects to
+ *  the passed in time.  It runs once per frame before
+ *  RenderScene(), so every object is drawn for the same time.
+ ***********************************************************/
+void SceneManager::UpdateScene(float animationTime)
+{
+    PROFILE_SCOPE("UpdateScene");
 
-    // Set light properties
-    for (int i = 0; i < 3; ++i) {
-        std::string lightIndex = "lightSources[" + std::to_string(i) + "].";
-        m_pShaderManager->setVec3Value(lightIndex + "position", m_lightSources[i].position);
-        m_pShaderManager->setVec3Value(lightIndex + "ambientColor", m_lightSources[i].ambientColor);
-        m_pShaderManager->setVec3Value(lightIndex + "diffuseColor", m_lightSources[i].diffuseColor);
-        m_pShaderManager->setVec3Value(lightIndex + "specularColor", m_lightSources[i].specularColor);
-    }
+    m_animationSystem->Update(animationTime);
+}
 
+/***********************************************************
+ *  SetMaterialUniforms()
+ *
+ *  This method is used for setting the lighting switch and
+ *  the scene material into the passed in shader, which must
+ *  be the current program.
+ ***********************************************************/
+void SceneManager::SetMaterialUniforms(ShaderManager* pShader)
+{
     // Enable lighting
-    m_pShaderManager->setIntValue(g_UseLightingName, true);
+    SetUniform(pShader, g_UseLightingName, true);
 
     // Set material properties for the plane
     glm::vec3 ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
-    glm::vec3 diffuseColor = glm::vec3(0.8f, 0.8f, 0.8f);
+    glm::vec3 diffuseColor = g_SceneDiffuseColor;
     glm::vec3 specularColor = glm::vec3(1.0f, 1.0f, 1.0f);
     float shininess = 32.0f;
 
-    m_pShaderManager->setVec3Value(g_MaterialAmbientColor, ambientColor);
-    m_pShaderManager->setVec3Value(g_MaterialDiffuseColor, diffuseColor);
-    m_pShaderManager->setVec3Value(g_MaterialSpecularColor, specularColor);
-    m_pShaderManager->setFloatValue(g_MaterialShininess, shininess);
+    SetUniform(pShader, g_MaterialAmbientColor, ambientColor);
+    SetUniform(pShader, g_MaterialDiffuseColor, diffuseColor);
+    SetUniform(pShader, g_MaterialSpecularColor, specularColor);
+    SetUniform(pShader, g_MaterialShininess, shininess);
+}
 
-    // Grass Floor Plane
-    scaleXYZ = glm::vec3(25.0f, 5.0f, 36.0f);
-    XrotationDegrees = 0.0f;
-    positionXYZ = glm::vec3(0.0f, -1.0f, 0.0f);
-    SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-    SetShaderTexture("grass");
-    SetTextureUVScale(1.0f, 1.0f);
-    m_basicMeshes->DrawPlaneMesh();
-
-    // Water Plane
-    scaleXYZ = glm::vec3(25.0f, 1.0f, 2.0f);
-    XrotationDegrees = 0.0f;
-    positionXYZ = glm::vec3(0.0f, -0.5f, 0.0f); // Aligning the water plane with the grass plane
-    SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-    SetShaderTexture("water");
-    SetTextureUVScale(1.0f, 1.0f);
-    m_basicMeshes->DrawPlaneMesh();
-
-    // Sun 1
-    scaleXYZ = glm::vec3(2.0f, 2.0f, 2.0f);
-    positionXYZ = glm::vec3(-10.0f, 10.0f, -20.0f);
-    SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-    SetShaderColor(1.0f, 0.5f, 0.0f, 1.0f); // Orange color
-    m_basicMeshes->DrawSphereMesh(); // Assuming a sphere mesh is available
-
-    // Sun 2
-    scaleXYZ = glm::vec3(1.5f, 1.5f, 1.5f);
-    positionXYZ = glm::vec3(-8.0f, 8.0f, -22.0f);
-    SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-    SetShaderColor(1.0f, 0.5f, 0.0f, 1.0f); // Orange color
-    m_basicMeshes->DrawSphereMesh(); // Assuming a sphere mesh is available
-
-    // Sun 3
-    scaleXYZ = glm::vec3(1.0f, 1.0f, 1.0f);
-    positionXYZ = glm::vec3(10.0f, 9.0f, -18.0f);
-    SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-    SetShaderColor(1.0f, 0.5f, 0.0f, 1.0f); // Orange color
-    m_basicMeshes->DrawSphereMesh(); // Assuming a sphere mesh is available
-
-    // Mountain 1
-    scaleXYZ = glm::vec3(10.0f, 5.0f, 10.0f);
-    positionXYZ = glm::vec3(-10.0f, 0.0f, -20.0f);
-    SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-    SetShaderColor(0.5f, 0.35f, 0.05f, 1.0f); // Brownish color
-    m_basicMeshes->DrawConeMesh();
-
-    // Mountain 2
-    scaleXYZ = glm::vec3(8.0f, 4.0f, 8.0f);
-    positionXYZ = glm::vec3(10.0f, 0.0f, -15.0f);
-    SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-    SetShaderColor(0.55f, 0.4f, 0.1f, 1.0f); // Slightly different brownish color
-    m_basicMeshes->DrawConeMesh();
-
-    // Mountain 3
-    scaleXYZ = glm::vec3(12.0f, 6.0f, 12.0f);
-    positionXYZ = glm::vec3(0.0f, 0.0f, -25.0f);
-    SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-    SetShaderColor(0.6f, 0.45f, 0.15f, 1.0f); // Another shade of brown
-    m_basicMeshes->DrawConeMesh();
+/***********************************************************
+ *  SetRenderPath()
+ *
+ *  This method is used for switching between forward and
+ *  deferred rendering of the scene.
+ ***********************************************************/
+void SceneManager::SetRenderPath(RENDER_PATH renderPath)
+{
+    if (renderPath == RENDER_PATH_DEFERRED && m_deferredRenderer == NULL)
+    {
+        std::cout << "Deferred path is not available" << std::endl;
+        return;
+    }
 
-    // Trees
-    std::vector<glm::vec3> treePositions = {
-        glm::vec3(10.0f, -1.0f, 5.0f),
-        glm::vec3(15.0f, -1.0f, 8.0f),
-        glm::vec3(18.0f, -1.0f, 3.0f),
-        glm::vec3(-10.0f, -1.0f, 5.0f),
-        glm::vec3(-15.0f, -1.0f, 8.0f),
-        glm::vec3(-18.0f, -1.0f, 3.0f),
-        glm::vec3(10.0f, -1.0f, -5.0f),
-        glm::vec3(15.0f, -1.0f, -8.0f),
-        glm::vec3(18.0f, -1.0f, -3.0f),
-        glm::vec3(-10.0f, -1.0f, -5.0f),
-        glm::vec3(-15.0f, -1.0f, -8.0f),
-        glm::vec3(-18.0f, -1.0f, -3.0f)
-    };
+    m_renderPath = renderPath;
+    std::cout << "Render path: " << (renderPath == RENDER_PATH_DEFERRED ? "deferred" : "forward") << std::endl;
+}
 
-    for (const auto& treePos : treePositions)
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by
+ *  transforming and drawing the basic 3D shapes
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+    PROFILE_GPU_SCOPE("RenderScene");
+
+    // the frame was already cleared by the main loop, these only
+    // reach OpenGL when the state actually differs
+    GLStateCache* stateCache = GLStateCache::Get();
+    stateCache->Enable(GL_DEPTH_TEST);
+    stateCache->DepthFunc(GL_LEQUAL);
+    stateCache->UseProgram(m_pShaderManager->m_programID);
+
+    // claim this frame's section of the per-draw ring buffer
+    if (m_usePerDrawBuffer)
     {
-        // Tree Trunk
-        scaleXYZ = glm::vec3(0.5f, 3.0f, 0.5f);
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, treePos) *
-            glm::rotate(glm::mat4(1.0f), static_cast<float>(glfwGetTime()), glm::vec3(0.0f, 1.0f, 0.0f)) *
-            glm::scale(glm::mat4(1.0f), scaleXYZ);
-        m_pShaderManager->setMat4Value("model", model);
-        SetShaderTexture("bark");
-        SetTextureUVScale(1.0f, 1.0f);
-        m_basicMeshes->DrawCylinderMesh();
+        m_perDrawBuffer->BeginFrame();
+        m_perDrawBuffer->BindFrameSection(g_PerDrawBinding);
+    }
 
-        // Tree Cone
-        scaleXYZ = glm::vec3(2.0f, 3.0f, 2.0f);
-        glm::vec3 conePos = treePos + glm::vec3(0.0f, 1.5f, 0.0f);
-        model = glm::mat4(1.0f);
-        model = glm::translate(model, conePos) *
-            glm::rotate(glm::mat4(1.0f), static_cast<float>(glfwGetTime()), glm::vec3(0.0f, 1.0f, 0.0f)) *
-            glm::scale(glm::mat4(1.0f), scaleXYZ);
-        m_pShaderManager->setMat4Value("model", model);
-        SetShaderTexture("leaves");
-        SetTextureUVScale(1.0f, 1.0f);
-        m_basicMeshes->DrawConeMesh();
+    // upload the lights of the current view, the cluster lists are
+    // only built when a draw cannot take its lights from its own list
+    GLint viewport[4] = { 0, 0, 0, 0 };
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    m_clusteredLighting->Update(m_lightSources, m_viewMatrix, m_projectionMatrix);
+    m_clusterListsBuilt = false;
+    m_lightAssignment->Build(m_lightSources);
+
+    UpdateDrawOrder();
+    RenderShadowMaps(viewport);
+
+    if (m_renderPath == RENDER_PATH_DEFERRED)
+        RenderDeferred(viewport[2], viewport[3]);
+    else
+        RenderForward(viewport[2], viewport[3]);
+
+    // the GPU reads this frame section until the fence passes
+    if (m_usePerDrawBuffer)
+    {
+        m_perDrawBuffer->EndFrame();
     }
+}
 
-    // Additional trees for more variety
-    std::vector<glm::vec3> additionalTreePositions = {
-        glm::vec3(-3.0f, -1.0f, 2.0f),
-        glm::vec3(3.0f, -1.0f, -2.0f),
-        glm::vec3(-7.0f, -1.0f, 3.0f),
-        glm::vec3(7.0f, -1.0f, -3.0f),
-        glm::vec3(-2.0f, -1.0f, -4.0f),
-        glm::vec3(2.0f, -1.0f, 4.0f),
-        glm::vec3(-6.0f, -1.0f, -3.0f),
-        glm::vec3(6.0f, -1.0f, 3.0f),
-        glm::vec3(15.0f, -1.0f, 10.0f),
-        glm::vec3(-15.0f, -1.0f, -10.0f),
-        glm::vec3(20.0f, -1.0f, 12.0f),
-        glm::vec3(-20.0f, -1.0f, -12.0f)
-    };
+/***********************************************************
+ *  RenderShadowMaps()
+ *
+ *  This method is used for drawing the shadow casters of the
+ *  first light into the cascades when it is a sun, a light
+ *  without a radius.  The static casters are only drawn when
+ *  a cascade moved, every other frame they are copied from
+ *  the cached layer and only the animated casters are drawn.
+ *  The framebuffer and the passed in viewport are restored.
+ ***********************************************************/
+void SceneManager::RenderShadowMaps(const GLint viewport[4])
+{
+    PROFILE_GPU_SCOPE("RenderShadowMaps");
+
+    m_shadowLightIndex = -1;
+    if (m_shadowMaps == NULL || m_lightSources.empty() || m_lightSources[0].radius > 0.0f)
+        return;
 
-    for (const auto& treePos : additionalTreePositions)
+    // the global lights lead the light buffer in their scene order
+    m_shadowLightIndex = 0;
+
+    GLStateCache* stateCache = GLStateCache::Get();
+    GLint targetFramebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &targetFramebuffer);
+
+    m_shadowMaps->Update(m_viewMatrix, m_projectionMatrix, g_ShadowFocus - m_lightSources[0].position);
+
+    stateCache->UseProgram(m_depthShaderManager->m_programID);
+    SetUniform(m_depthShaderManager, g_ViewName, m_shadowMaps->GetLightView());
+    m_pActiveShader = m_depthShaderManager;
+    m_activeDrawIDLocation = m_depthDrawIDLocation;
+
+    stateCache->DepthMask(GL_TRUE);
+    stateCache->DepthFunc(GL_LESS);
+    // slope scaled bias against surfaces shadowing themselves
+    stateCache->Enable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.0f, 4.0f);
+
+    for (int cascade = 0; cascade < SHADOW_CASCADE_COUNT; cascade++)
     {
-        // Tree Trunk
-        scaleXYZ = glm::vec3(0.5f, 3.0f, 0.5f);
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, treePos) *
-            glm::rotate(glm::mat4(1.0f), static_cast<float>(glfwGetTime()), glm::vec3(0.0f, 1.0f, 0.0f)) *
-            glm::scale(glm::mat4(1.0f), scaleXYZ);
-        m_pShaderManager->setMat4Value("model", model);
-        SetShaderTexture("bark");
-        SetTextureUVScale(1.0f, 1.0f);
-        m_basicMeshes->DrawCylinderMesh();
+        SetUniform(m_depthShaderManager, g_ProjectionName, m_shadowMaps->GetCascadeProjection(cascade));
 
-        // Tree Cone
-        scaleXYZ = glm::vec3(2.0f, 3.0f, 2.0f);
-        glm::vec3 conePos = treePos + glm::vec3(0.0f, 1.5f, 0.0f);
-        model = glm::mat4(1.0f);
-        model = glm::translate(model, conePos) *
-            glm::rotate(glm::mat4(1.0f), static_cast<float>(glfwGetTime()), glm::vec3(0.0f, 1.0f, 0.0f)) *
-            glm::scale(glm::mat4(1.0f), scaleXYZ);
-        m_pShaderManager->setMat4Value("model", model);
-        SetShaderTexture("leaves");
-        SetTextureUVScale(1.0f, 1.0f);
-        m_basicMeshes->DrawConeMesh();
+        if (m_shadowMaps->NeedsStaticRender(cascade))
+        {
+            m_shadowMaps->BeginStaticPass(cascade);
+            DrawShadowCasters(cascade, false);
+            m_shadowMaps->EndStaticPass(cascade);
+        }
+
+        m_shadowMaps->BeginDynamicPass(cascade);
+        DrawShadowCasters(cascade, true);
+    }
+
+    stateCache->Disable(GL_POLYGON_OFFSET_FILL);
+    stateCache->DepthFunc(GL_LEQUAL);
+    stateCache->BindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(targetFramebuffer));
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    stateCache->UseProgram(m_pShaderManager->m_programID);
+    m_pActiveShader = m_pShaderManager;
+    m_activeDrawIDLocation = m_drawIDLocation;
+}
+
+/***********************************************************
+ *  DrawShadowCasters()
+ *
+ *  This method is used for drawing either the animated or the
+ *  static shadow casters that reach a cascade.
+ ***********************************************************/
+void SceneManager::DrawShadowCasters(int cascade, bool dynamicCasters)
+{
+    for (auto& object : m_sceneObjects)
+    {
+        if (!object.castsShadow || (object.animationIndex != -1) != dynamicCasters)
+            continue;
+
+        glm::vec3 center;
+        float radius = 0.0f;
+        GetBoundingSphere(object, center, radius);
+        if (m_shadowMaps->IsInsideCascade(cascade, center, radius))
+            DrawSceneObject(object);
     }
+}
+
+/***********************************************************
+ *  RenderForward()
+ *
+ *  This method is used for drawing and lighting the objects
+ *  in one pass, after an optional depth pre-pass.
+ ***********************************************************/
+void SceneManager::RenderForward(int viewportWidth, int viewportHeight)
+{
+    PROFILE_GPU_SCOPE("RenderForward");
+
+    GLStateCache* stateCache = GLStateCache::Get();
+
+    m_clusteredLighting->Bind(m_pShaderManager->m_programID, static_cast<float>(viewportWidth), static_cast<float>(viewportHeight));
+    if (m_shadowMaps)
+        m_shadowMaps->Bind(m_pShaderManager->m_programID, m_shadowLightIndex);
+    if (m_lightmapBaker)
+        m_lightmapBaker->Bind(m_pShaderManager->m_programID);
+    SetMaterialUniforms(m_pShaderManager);
+
+    bool depthPrepass = m_depthPrepass && (m_depthShaderManager != NULL);
+    if (depthPrepass)
+    {
+        // depth only, nearest objects first
+        stateCache->UseProgram(m_depthShaderManager->m_programID);
+        SetUniform(m_depthShaderManager, g_ViewName, m_viewMatrix);
+        SetUniform(m_depthShaderManager, g_ProjectionName, m_projectionMatrix);
+        m_pActiveShader = m_depthShaderManager;
+        m_activeDrawIDLocation = m_depthDrawIDLocation;
+
+        stateCache->ColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        stateCache->DepthMask(GL_TRUE);
+        stateCache->DepthFunc(GL_LESS);
+        for (size_t i = 0; i < m_drawCount; i++)
+        {
+            DrawSceneObject(m_sceneObjects[m_drawOrder[i]]);
+        }
+
+        // the depth buffer is final, shade only the fragments that
+        // match it
+        stateCache->ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        stateCache->DepthMask(GL_FALSE);
+        stateCache->DepthFunc(GL_EQUAL);
+        stateCache->UseProgram(m_pShaderManager->m_programID);
+        m_pActiveShader = m_pShaderManager;
+        m_activeDrawIDLocation = m_drawIDLocation;
+    }
+
+    m_overdrawMeter->Begin(depthPrepass ? g_OverdrawTagDepthPrepass : g_OverdrawTagForward);
+    for (size_t i = 0; i < m_drawCount; i++)
+    {
+        DrawSceneObject(m_sceneObjects[m_drawOrder[i]]);
+    }
+    m_overdrawMeter->End();
+
+    // depth writes have to be on again for the next frame's clear
+    stateCache->DepthMask(GL_TRUE);
+    stateCache->DepthFunc(GL_LEQUAL);
+    ReportOverdraw();
+}
+
+/***********************************************************
+ *  RenderDeferred()
+ *
+ *  This method is used for drawing the objects into the
+ *  G-buffer and lighting the result once per pixel, so the
+ *  lighting cost depends on the resolution and the lights
+ *  instead of the number of objects.  The lit image goes to
+ *  the framebuffer that was bound when rendering started.
+ ***********************************************************/
+void SceneManager::RenderDeferred(int viewportWidth, int viewportHeight)
+{
+    PROFILE_GPU_SCOPE("RenderDeferred");
+
+    GLStateCache* stateCache = GLStateCache::Get();
+
+    GLint targetFramebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &targetFramebuffer);
+
+    // surface values, nearest objects first
+    ShaderManager* pGeometryShader = m_deferredRenderer->GetGeometryShader();
+    m_deferredRenderer->BeginGeometryPass(viewportWidth, viewportHeight);
+    SetUniform(pGeometryShader, g_ViewName, m_viewMatrix);
+    SetUniform(pGeometryShader, g_ProjectionName, m_projectionMatrix);
+    SetUniform(pGeometryShader, g_UseLightingName, true);
+    m_pActiveShader = pGeometryShader;
+    m_activeDrawIDLocation = m_geometryDrawIDLocation;
+
+    for (size_t i = 0; i < m_drawCount; i++)
+    {
+        DrawSceneObject(m_sceneObjects[m_drawOrder[i]]);
+    }
+
+    // one lighting pass over the screen
+    ShaderManager* pLightingShader = m_deferredRenderer->GetLightingShader();
+    m_deferredRenderer->BeginLightingPass(static_cast<GLuint>(targetFramebuffer));
+    SetUniform(pLightingShader, g_ViewName, m_viewMatrix);
+    SetUniform(pLightingShader, g_InverseViewProjectionName, glm::inverse(m_projectionMatrix * m_viewMatrix));
+    SetUniform(pLightingShader, g_ViewPositionName, m_cameraPosition);
+    SetMaterialUniforms(pLightingShader);
+    // every lit pixel reads the cluster lists, the G-buffer keeps no object
+    EnsureClusterLists();
+    m_clusteredLighting->Bind(pLightingShader->m_programID, static_cast<float>(viewportWidth), static_cast<float>(viewportHeight));
+    if (m_shadowMaps)
+        m_shadowMaps->Bind(pLightingShader->m_programID, m_shadowLightIndex);
+    if (m_lightmapBaker)
+        m_lightmapBaker->Bind(pLightingShader->m_programID);
+    m_deferredRenderer->EndLightingPass();
 
-    // Plane aligned with Grass Plane
-    scaleXYZ = glm::vec3(25.0f, 5.0f, 10.0f);
-    positionXYZ = glm::vec3(0.0f, 9.0f, -36.0f); // Adjust the position to align with the grass plane
-    XrotationDegrees = 90.0f; // Rotate to face up as a background
-    SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-    SetShaderTexture("sky");
-    SetTextureUVScale(1.0f, 1.0f);
-    m_basicMeshes->DrawPlaneMesh();
+    stateCache->DepthFunc(GL_LEQUAL);
+    stateCache->UseProgram(m_pShaderManager->m_programID);
+    m_pActiveShader = m_pShaderManager;
+    m_activeDrawIDLocation = m_drawIDLocation;
 }
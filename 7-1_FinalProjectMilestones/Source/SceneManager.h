@@ -10,28 +10,26 @@
 
 #include "ShaderManager.h"
 #include "ShapeMeshes.h"
+#include "LODMeshes.h"
+#include "PerDrawBuffer.h"
+#include "TransformComponent.h"
+#include "AnimationSystem.h"
+#include "OverdrawMeter.h"
+#include "ClusteredLighting.h"
+#include "DeferredRenderer.h"
+#include "CascadedShadowMaps.h"
+#include "LightmapBaker.h"
+#include "LightAssignment.h"
+#include "ViewManager.h"
 
 // TEXTURE_INFO structure
 struct TEXTURE_INFO
 {
     GLuint ID;
     std::string tag;
+    glm::vec3 averageColor;
 
-    TEXTURE_INFO() : ID(0), tag("") {}
-};
-
-// LIGHT_SOURCE structure
-struct LIGHT_SOURCE
-{
-    glm::vec3 position;
-    glm::vec3 ambientColor;
-    glm::vec3 diffuseColor;
-    glm::vec3 specularColor;
-    float focalStrength;
-    float specularIntensity;
-
-    LIGHT_SOURCE()
-        : position(0.0f), ambientColor(0.0f), diffuseColor(0.0f), specularColor(0.0f), focalStrength(1.0f), specularIntensity(1.0f) {}
+    TEXTURE_INFO() : ID(0), tag(""), averageColor(0.0f) {}
 };
 
 // OBJECT_MATERIAL structure
@@ -48,33 +46,140 @@ struct OBJECT_MATERIAL
         : tag(""), ambientColor(0.0f), ambientStrength(0.0f), diffuseColor(0.0f), specularColor(0.0f), shininess(0.0f) {}
 };
 
+// shapes a scene object can be drawn with
+enum SCENE_SHAPE {
+    SHAPE_PLANE,
+    SHAPE_CYLINDER,
+    SHAPE_CONE,
+    SHAPE_SPHERE
+};
+
+// SCENE_OBJECT structure
+struct SCENE_OBJECT
+{
+    TransformComponent transform;
+    SCENE_SHAPE shape;
+    int textureSlot; // -1 when the object is drawn with a flat color
+    glm::vec4 color;
+    int animationIndex; // instance in the animation system, -1 when static
+    int lodLevel; // current detail level of the round shapes
+    float viewDistance; // distance from the camera to the bounds center this frame
+    bool castsShadow;
+    bool useLightmap; // lit from the baked lightmap, only for static planes and cones
+    int lightCount; // lights with a radius that reach the object this frame, -1 when they do not fit the list
+    GLint lightIndices[MAX_DRAW_LIGHTS]; // their light buffer entries
+    bool visible; // bounds inside the view frustum this frame
+
+    SCENE_OBJECT()
+        : shape(SHAPE_PLANE), textureSlot(-1), color(1.0f), animationIndex(-1), lodLevel(0), viewDistance(0.0f), castsShadow(true), useLightmap(false),
+        lightCount(0), lightIndices(), visible(true) {}
+};
+
+// ways the scene can be rendered
+enum RENDER_PATH {
+    // objects are lit as they are drawn
+    RENDER_PATH_FORWARD,
+    // objects fill a G-buffer that is lit in one screen pass
+    RENDER_PATH_DEFERRED
+};
+
 class SceneManager
 {
 public:
     SceneManager(ShaderManager* pShaderManager);
     ~SceneManager();
 
-    bool CreateGLTexture(const char* filename, std::string tag);
+    bool CreateGLTexture(const char* filename, const std::string& tag);
     void BindGLTextures();
     void DestroyGLTextures();
-    int FindTextureID(std::string tag);
-    int FindTextureSlot(std::string tag);
-    bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+    int FindTextureID(const std::string& tag);
+    int FindTextureSlot(const std::string& tag);
+    bool FindMaterial(const std::string& tag, OBJECT_MATERIAL& material);
     void SetTransformations(glm::vec3 scaleXYZ, float XrotationDegrees, float YrotationDegrees, float ZrotationDegrees, glm::vec3 positionXYZ);
+    void SetTransformations(TransformComponent& transform);
     void SetShaderColor(float redColorValue, float greenColorValue, float blueColorValue, float alphaValue);
-    void SetShaderTexture(std::string textureTag);
+    void SetShaderTexture(const std::string& textureTag);
     void SetTextureUVScale(float u, float v);
-    void SetShaderMaterial(std::string materialTag);
+    void SetShaderMaterial(const std::string& materialTag);
     void PrepareScene();
+    void UpdateScene(float animationTime);
     void RenderScene();
     void SetLightColor(float red, float green, float blue, float alpha);
     void SetLightSource(int index, const LIGHT_SOURCE& light);
+    int AddLight(const LIGHT_SOURCE& light);
+    int GetLightCount() const { return static_cast<int>(m_lightSources.size()); }
+    void SetViewParameters(glm::vec3 cameraPosition, float pixelsPerUnit, const glm::mat4& view, const glm::mat4& projection);
+    void SetFrustumPlanes(const glm::vec4 planes[FRUSTUM_PLANE_COUNT]);
+    int GetCulledObjectCount() const { return m_culledObjects; }
+    void SetDepthPrepass(bool enabled);
+    bool IsDepthPrepassEnabled() const { return m_depthPrepass; }
+    float GetShadedOverdraw() const { return m_shadedOverdraw; }
+    void SetRenderPath(RENDER_PATH renderPath);
+    RENDER_PATH GetRenderPath() const { return m_renderPath; }
+    void RunVertexFormatBenchmark(int drawCount);
+    // replace the scene with a generated forest of the passed in size,
+    // the first light is the shadowed sun and the rest are point lights,
+    // returns half the width of the square the trees stand on
+    float BuildBenchmarkScene(int treeCount, int lightCount);
+    int GetSceneObjectCount() const { return static_cast<int>(m_sceneObjects.size()); }
+    // draws that did not fit the per-draw ring buffer so far
+    GLuint GetPerDrawOverflowCount() const { return m_perDrawBuffer->GetOverflowCount(); }
 
 private:
+    void SubmitDrawData();
+    // build the cluster light lists once in a frame, when a draw or pass reads them
+    void EnsureClusterLists();
+    void UploadDrawUniforms();
+    SCENE_OBJECT& AddSceneObject(SCENE_SHAPE shape, glm::vec3 scaleXYZ, glm::vec3 rotationDegrees, glm::vec3 positionXYZ);
+    void GetBoundingSphere(const SCENE_OBJECT& object, glm::vec3& center, float& radius) const;
+    void UpdateDrawOrder();
+    void DrawSceneObject(SCENE_OBJECT& object);
+    void ReportOverdraw();
+    void SetMaterialUniforms(ShaderManager* pShader);
+    void BakeLightmap();
+    void RenderShadowMaps(const GLint viewport[4]);
+    void DrawShadowCasters(int cascade, bool dynamicCasters);
+    void RenderForward(int viewportWidth, int viewportHeight);
+    void RenderDeferred(int viewportWidth, int viewportHeight);
+
     ShaderManager* m_pShaderManager;
     ShapeMeshes* m_basicMeshes;
+    LODMeshes* m_lodMeshes;
+    PerDrawRingBuffer* m_perDrawBuffer;
+    AnimationSystem* m_animationSystem;
+    PER_DRAW_DATA m_drawData; // per-draw values staged for the next draw
+    GLint m_drawIDLocation;
+    bool m_usePerDrawBuffer;
+    bool m_clusterListsBuilt; // the cluster light lists match this frame
+    ShaderManager* m_depthShaderManager; // depth pre-pass program, NULL when it failed to load
+    GLint m_depthDrawIDLocation;
+    ShaderManager* m_pActiveShader; // program the staged per-draw values go to
+    GLint m_activeDrawIDLocation;
+    bool m_depthPrepass;
+    OverdrawMeter* m_overdrawMeter;
+    int m_overdrawReportTag; // pass setting whose next measurement is printed, -1 for none
+    float m_shadedOverdraw; // shaded fragments per pixel in the last measured frame
     int m_loadedTextures;
     TEXTURE_INFO m_textureIDs[128]; // Assume a max of 128 textures
     std::vector<OBJECT_MATERIAL> m_objectMaterials;
-    LIGHT_SOURCE m_lightSources[4]; // Array to hold light sources
+    std::vector<LIGHT_SOURCE> m_lightSources;
+    ClusteredLighting* m_clusteredLighting;
+    LightAssignment* m_lightAssignment;
+    DeferredRenderer* m_deferredRenderer; // NULL when its shaders failed to load
+    GLint m_geometryDrawIDLocation;
+    RENDER_PATH m_renderPath;
+    CascadedShadowMaps* m_shadowMaps; // NULL when the shadow maps could not be created
+    int m_shadowLightIndex; // light buffer entry of the shadowed light, -1 when there is none
+    LightmapBaker* m_lightmapBaker; // NULL when no lightmap was built
+    std::vector<SCENE_OBJECT> m_sceneObjects;
+    std::vector<size_t> m_sortOrder; // every scene object index, nearest first
+    size_t* m_drawOrder; // indices of the objects in view, nearest first, in the frame arena
+    size_t m_drawCount;
+    glm::vec3 m_cameraPosition;
+    glm::mat4 m_viewMatrix;
+    glm::mat4 m_projectionMatrix;
+    float m_pixelsPerUnit; // pixels covered by one world unit at a distance of one
+    glm::vec4 m_frustumPlanes[FRUSTUM_PLANE_COUNT];
+    bool m_frustumCulling; // false until frustum planes were passed in
+    int m_culledObjects; // objects outside the view frustum this frame
 };
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// simulationclock.cpp
+// ============
+// split real time into fixed simulation steps and report how far the
+// frame being rendered lies between the last two steps
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "SimulationClock.h"
+
+// declaration of global variables
+namespace
+{
+    // longest frame time accepted, a longer stall such as dragging
+    // the window is treated as this long
+    const double g_MaxFrameSeconds = 0.25;
+    // most steps run for one frame, so a slow frame cannot cause an
+    // ever growing backlog of steps
+    const int g_MaxStepsPerFrame = 8;
+}
+
+/***********************************************************
+ *  SimulationClock()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SimulationClock::SimulationClock(double stepSeconds)
+    : m_step(stepSeconds), m_accumulator(0.0), m_time(0.0), m_droppedSteps(0)
+{
+}
+
+/***********************************************************
+ *  Advance()
+ *
+ *  This method is used for adding the real time of a frame.
+ *  Every whole step of accumulated time is handed out as one
+ *  simulation step, the rest carries over to the next frame,
+ *  so the simulation runs at the same rate whatever the frame
+ *  rate is.
+ ***********************************************************/
+int SimulationClock::Advance(double frameSeconds)
+{
+    if (frameSeconds > g_MaxFrameSeconds)
+        frameSeconds = g_MaxFrameSeconds;
+    if (frameSeconds > 0.0)
+        m_accumulator += frameSeconds;
+
+    int steps = 0;
+    while (m_accumulator >= m_step)
+    {
+        m_accumulator -= m_step;
+        if (steps == g_MaxStepsPerFrame)
+        {
+            m_droppedSteps++;
+            continue;
+        }
+        m_time += m_step;
+        steps++;
+    }
+    return steps;
+}
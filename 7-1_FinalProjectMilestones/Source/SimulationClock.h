@@ -0,0 +1,40 @@
+///////////////////////////////////////////////////////////////////////////////
+// simulationclock.h
+// ============
+// split real time into fixed simulation steps and report how far the
+// frame being rendered lies between the last two steps
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+class SimulationClock
+{
+public:
+    // constructor, the step is in seconds
+    SimulationClock(double stepSeconds);
+
+    // add the real time that passed since the last frame and return
+    // how many simulation steps have to run before rendering it
+    int Advance(double frameSeconds);
+
+    // length of one simulation step in seconds
+    double GetStep() const { return m_step; }
+    // simulation time after the last step
+    double GetTime() const { return m_time; }
+    // position of the rendered frame between the previous and the
+    // last step, from 0 to 1
+    float GetInterpolation() const { return static_cast<float>(m_accumulator / m_step); }
+    // simulation time of the rendered frame
+    double GetInterpolatedTime() const { return m_time - m_step + m_accumulator; }
+    // steps dropped because the frames fell too far behind
+    int GetDroppedSteps() const { return m_droppedSteps; }
+
+private:
+    double m_step;
+    double m_accumulator; // real time not yet simulated
+    double m_time;
+    int m_droppedSteps;
+};
@@ -0,0 +1,285 @@
+///////////////////////////////////////////////////////////////////////////////
+// statsoverlay.cpp
+// ============
+// draw the frame time and the render counters of the last frame as text
+// over the scene, all of it in one draw
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "StatsOverlay.h"
+#include "GLStateCache.h"
+#include "RenderCounters.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+    // 5x7 font for the characters from space to Z, five columns per
+    // glyph with the top row in the lowest bit
+    const int g_FirstGlyph = ' ';
+    const int g_GlyphCount = 'Z' - ' ' + 1;
+    const unsigned char g_FontColumns[g_GlyphCount][5] = {
+        { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5F, 0x00, 0x00 }, { 0x00, 0x07, 0x00, 0x07, 0x00 },
+        { 0x14, 0x7F, 0x14, 0x7F, 0x14 }, { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 },
+        { 0x36, 0x49, 0x56, 0x20, 0x50 }, { 0x00, 0x08, 0x07, 0x03, 0x00 }, { 0x00, 0x1C, 0x22, 0x41, 0x00 },
+        { 0x00, 0x41, 0x22, 0x1C, 0x00 }, { 0x2A, 0x1C, 0x7F, 0x1C, 0x2A }, { 0x08, 0x08, 0x3E, 0x08, 0x08 },
+        { 0x00, 0x80, 0x70, 0x30, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, { 0x00, 0x00, 0x60, 0x60, 0x00 },
+        { 0x20, 0x10, 0x08, 0x04, 0x02 }, { 0x3E, 0x51, 0x49, 0x45, 0x3E }, { 0x00, 0x42, 0x7F, 0x40, 0x00 },
+        { 0x72, 0x49, 0x49, 0x49, 0x46 }, { 0x21, 0x41, 0x49, 0x4D, 0x33 }, { 0x18, 0x14, 0x12, 0x7F, 0x10 },
+        { 0x27, 0x45, 0x45, 0x45, 0x39 }, { 0x3C, 0x4A, 0x49, 0x49, 0x31 }, { 0x41, 0x21, 0x11, 0x09, 0x07 },
+        { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x46, 0x49, 0x49, 0x29, 0x1E }, { 0x00, 0x00, 0x14, 0x00, 0x00 },
+        { 0x00, 0x40, 0x34, 0x00, 0x00 }, { 0x00, 0x08, 0x14, 0x22, 0x41 }, { 0x14, 0x14, 0x14, 0x14, 0x14 },
+        { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x59, 0x09, 0x06 }, { 0x3E, 0x41, 0x5D, 0x59, 0x4E },
+        { 0x7C, 0x12, 0x11, 0x12, 0x7C }, { 0x7F, 0x49, 0x49, 0x49, 0x36 }, { 0x3E, 0x41, 0x41, 0x41, 0x22 },
+        { 0x7F, 0x41, 0x41, 0x41, 0x3E }, { 0x7F, 0x49, 0x49, 0x49, 0x41 }, { 0x7F, 0x09, 0x09, 0x09, 0x01 },
+        { 0x3E, 0x41, 0x41, 0x51, 0x73 }, { 0x7F, 0x08, 0x08, 0x08, 0x7F }, { 0x00, 0x41, 0x7F, 0x41, 0x00 },
+        { 0x20, 0x40, 0x41, 0x3F, 0x01 }, { 0x7F, 0x08, 0x14, 0x22, 0x41 }, { 0x7F, 0x40, 0x40, 0x40, 0x40 },
+        { 0x7F, 0x02, 0x1C, 0x02, 0x7F }, { 0x7F, 0x04, 0x08, 0x10, 0x7F }, { 0x3E, 0x41, 0x41, 0x41, 0x3E },
+        { 0x7F, 0x09, 0x09, 0x09, 0x06 }, { 0x3E, 0x41, 0x51, 0x21, 0x5E }, { 0x7F, 0x09, 0x19, 0x29, 0x46 },
+        { 0x26, 0x49, 0x49, 0x49, 0x32 }, { 0x03, 0x01, 0x7F, 0x01, 0x03 }, { 0x3F, 0x40, 0x40, 0x40, 0x3F },
+        { 0x1F, 0x20, 0x40, 0x20, 0x1F }, { 0x3F, 0x40, 0x38, 0x40, 0x3F }, { 0x63, 0x14, 0x08, 0x14, 0x63 },
+        { 0x03, 0x04, 0x78, 0x04, 0x03 }, { 0x61, 0x59, 0x49, 0x4D, 0x43 }
+    };
+    // the cell after the glyphs is solid, for the backing quad
+    const int g_SolidGlyph = g_GlyphCount;
+    const int g_CellWidth = 6;
+    const int g_CellHeight = 8;
+
+    // screen pixels per font texel
+    const float g_TextScale = 2.0f;
+    const float g_Margin = 8.0f;
+    // position, texture coordinate and color of a vertex
+    const int g_FloatsPerVertex = 8;
+    // longest counter line, with its terminating zero
+    const int g_MaxLineLength = 64;
+    const int g_VerticesPerGlyph = 6;
+
+    const glm::vec4 g_TextColor(1.0f, 1.0f, 0.6f, 1.0f);
+    const glm::vec4 g_BackingColor(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+/***********************************************************
+ *  StatsOverlay()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+StatsOverlay::StatsOverlay()
+    : m_shaderManager(NULL), m_screenSizeLocation(-1), m_fontTexture(0), m_vao(0), m_vertexBuffer(0), m_bufferCapacity(0)
+{
+}
+
+/***********************************************************
+ *  ~StatsOverlay()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+StatsOverlay::~StatsOverlay()
+{
+    if (m_fontTexture != 0)
+    {
+        GLStateCache::Get()->NotifyTextureDeleted(m_fontTexture);
+        glDeleteTextures(1, &m_fontTexture);
+    }
+    if (m_vertexBuffer != 0)
+        glDeleteBuffers(1, &m_vertexBuffer);
+    if (m_vao != 0)
+        glDeleteVertexArrays(1, &m_vao);
+    delete m_shaderManager;
+    m_shaderManager = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for loading the overlay shaders,
+ *  turning the font table into a one channel texture and
+ *  setting up the vertex layout of the quads.
+ ***********************************************************/
+bool StatsOverlay::Create()
+{
+    m_shaderManager = new ShaderManager();
+    m_shaderManager->LoadShaders(
+        "shaders/overlayVertexShader.glsl",
+        "shaders/overlayFragmentShader.glsl");
+    if (m_shaderManager->m_programID == 0)
+    {
+        std::cout << "Overlay shaders failed to load, the stats overlay is disabled" << std::endl;
+        delete m_shaderManager;
+        m_shaderManager = NULL;
+        return false;
+    }
+
+    int textureWidth = (g_GlyphCount + 1) * g_CellWidth;
+    std::vector<unsigned char> texels(textureWidth * g_CellHeight, 0);
+    for (int glyph = 0; glyph < g_GlyphCount; glyph++)
+    {
+        for (int column = 0; column < 5; column++)
+        {
+            for (int row = 0; row < g_CellHeight; row++)
+            {
+                if (g_FontColumns[glyph][column] & (1 << row))
+                    texels[row * textureWidth + glyph * g_CellWidth + column] = 255;
+            }
+        }
+    }
+    for (int row = 0; row < g_CellHeight; row++)
+    {
+        std::fill_n(texels.begin() + row * textureWidth + g_SolidGlyph * g_CellWidth, g_CellWidth, static_cast<unsigned char>(255));
+    }
+
+    GLStateCache* stateCache = GLStateCache::Get();
+    glGenTextures(1, &m_fontTexture);
+    stateCache->ActiveTexture(GL_TEXTURE0 + OVERLAY_TEXTURE_UNIT);
+    stateCache->BindTexture(GL_TEXTURE_2D, m_fontTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, textureWidth, g_CellHeight, 0, GL_RED, GL_UNSIGNED_BYTE, texels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vertexBuffer);
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    GLsizei stride = g_FloatsPerVertex * sizeof(float);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)(4 * sizeof(float)));
+    glBindVertexArray(0);
+
+    // the font unit never changes
+    stateCache->UseProgram(m_shaderManager->m_programID);
+    m_shaderManager->setSampler2DValue("glyphTexture", OVERLAY_TEXTURE_UNIT);
+    m_screenSizeLocation = glGetUniformLocation(m_shaderManager->m_programID, "screenSize");
+
+    // room for the backing and the longest lines the counters can
+    // print, so the vertices never grow while the overlay is shown
+    size_t maxGlyphs = 1 + static_cast<size_t>(RENDER_COUNTER_COUNT + 1) * (g_MaxLineLength - 1);
+    m_vertices.reserve(maxGlyphs * g_VerticesPerGlyph * g_FloatsPerVertex);
+    return true;
+}
+
+/***********************************************************
+ *  AddGlyph()
+ *
+ *  This method is used for adding the two triangles of one
+ *  font cell quad.
+ ***********************************************************/
+void StatsOverlay::AddGlyph(float x, float y, float width, float height, int glyph, glm::vec4 color)
+{
+    float textureWidth = static_cast<float>((g_GlyphCount + 1) * g_CellWidth);
+    float u0 = glyph * g_CellWidth / textureWidth;
+    float u1 = (glyph + 1) * g_CellWidth / textureWidth;
+
+    const float corners[g_VerticesPerGlyph][4] = {
+        { x, y, u0, 0.0f }, { x + width, y, u1, 0.0f }, { x + width, y + height, u1, 1.0f },
+        { x, y, u0, 0.0f }, { x + width, y + height, u1, 1.0f }, { x, y + height, u0, 1.0f }
+    };
+    for (const auto& corner : corners)
+    {
+        m_vertices.insert(m_vertices.end(), corner, corner + 4);
+        m_vertices.push_back(color.x);
+        m_vertices.push_back(color.y);
+        m_vertices.push_back(color.z);
+        m_vertices.push_back(color.w);
+    }
+}
+
+/***********************************************************
+ *  AddText()
+ *
+ *  This method is used for adding the glyph quads of a line
+ *  of text.  Lower case letters are shown in upper case and
+ *  characters the font lacks as a question mark.
+ ***********************************************************/
+void StatsOverlay::AddText(float x, float y, const char* text, glm::vec4 color)
+{
+    float cellWidth = g_CellWidth * g_TextScale;
+    float cellHeight = g_CellHeight * g_TextScale;
+    for (const char* character = text; *character != '\0'; character++)
+    {
+        int code = static_cast<unsigned char>(*character);
+        if (code >= 'a' && code <= 'z')
+            code -= 'a' - 'A';
+        if (code < g_FirstGlyph || code >= g_FirstGlyph + g_GlyphCount)
+            code = '?';
+
+        if (code != ' ')
+            AddGlyph(x, y, cellWidth, cellHeight, code - g_FirstGlyph, color);
+        x += cellWidth;
+    }
+}
+
+/***********************************************************
+ *  Draw()
+ *
+ *  This method is used for drawing the frame time and every
+ *  render counter of the last finished frame on a dark
+ *  backing in the top left corner.  All quads go into one
+ *  vertex buffer and are drawn together.  The overlay is not
+ *  counted itself, the counters describe the scene.
+ ***********************************************************/
+void StatsOverlay::Draw(int width, int height, float frameMilliseconds)
+{
+    if (m_shaderManager == NULL || width <= 0 || height <= 0)
+        return;
+
+    RenderCounters* counters = RenderCounters::Get();
+    char lines[RENDER_COUNTER_COUNT + 1][g_MaxLineLength];
+    snprintf(lines[0], sizeof(lines[0]), "FRAME %6.2f MS", frameMilliseconds);
+    size_t longestLine = strlen(lines[0]);
+    for (int i = 0; i < RENDER_COUNTER_COUNT; i++)
+    {
+        RENDER_COUNTER counter = static_cast<RENDER_COUNTER>(i);
+        snprintf(lines[i + 1], sizeof(lines[i + 1]), "%-13s %llu", RenderCounters::GetName(counter),
+            static_cast<unsigned long long>(counters->GetLastFrame(counter)));
+        longestLine = std::max(longestLine, strlen(lines[i + 1]));
+    }
+
+    float lineHeight = (g_CellHeight + 2) * g_TextScale;
+    m_vertices.clear();
+    AddGlyph(g_Margin * 0.5f, g_Margin * 0.5f, longestLine * g_CellWidth * g_TextScale + g_Margin,
+        (RENDER_COUNTER_COUNT + 1) * lineHeight + g_Margin, g_SolidGlyph, g_BackingColor);
+    for (int i = 0; i <= RENDER_COUNTER_COUNT; i++)
+    {
+        AddText(g_Margin, g_Margin + i * lineHeight, lines[i], g_TextColor);
+    }
+
+    // orphan the storage so the last frame's quads are not waited on
+    GLsizeiptr size = static_cast<GLsizeiptr>(m_vertices.size() * sizeof(float));
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    if (size > m_bufferCapacity)
+        m_bufferCapacity = size;
+    glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, m_vertices.data());
+
+    GLStateCache* stateCache = GLStateCache::Get();
+    bool depthTestWasEnabled = stateCache->IsEnabled(GL_DEPTH_TEST);
+    GLuint previousProgram = stateCache->GetProgram();
+    stateCache->Disable(GL_DEPTH_TEST);
+    stateCache->UseProgram(m_shaderManager->m_programID);
+    stateCache->ActiveTexture(GL_TEXTURE0 + OVERLAY_TEXTURE_UNIT);
+    stateCache->BindTexture(GL_TEXTURE_2D, m_fontTexture);
+    glUniform2f(m_screenSizeLocation, static_cast<float>(width), static_cast<float>(height));
+    glViewport(0, 0, width, height);
+
+    glBindVertexArray(m_vao);
+    stateCache->NotifyDraw();
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size() / g_FloatsPerVertex));
+    glBindVertexArray(0);
+
+    // the scene uniforms of the next frame go to the bound program
+    stateCache->UseProgram(previousProgram);
+    if (depthTestWasEnabled)
+        stateCache->Enable(GL_DEPTH_TEST);
+}
@@ -0,0 +1,51 @@
+///////////////////////////////////////////////////////////////////////////////
+// statsoverlay.h
+// ============
+// draw the frame time and the render counters of the last frame as text
+// over the scene, all of it in one draw
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "ShaderManager.h"
+
+// texture unit the overlay font is sampled from
+const GLint OVERLAY_TEXTURE_UNIT = 10;
+
+class StatsOverlay
+{
+public:
+    // constructor
+    StatsOverlay();
+    // destructor
+    ~StatsOverlay();
+
+    // load the overlay shaders and build the font texture
+    bool Create();
+
+    // draw the stats over the currently bound framebuffer, which
+    // has the passed in size
+    void Draw(int width, int height, float frameMilliseconds);
+
+private:
+    // add a line of text with its top left corner at x, y
+    void AddText(float x, float y, const char* text, glm::vec4 color);
+    // add a quad showing the font cell of the passed in glyph
+    void AddGlyph(float x, float y, float width, float height, int glyph, glm::vec4 color);
+
+    ShaderManager* m_shaderManager;
+    GLint m_screenSizeLocation;
+    GLuint m_fontTexture;
+    GLuint m_vao;
+    GLuint m_vertexBuffer;
+    GLsizeiptr m_bufferCapacity;
+    // vertices of this frame's quads, the memory is kept between frames
+    std::vector<float> m_vertices;
+};
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformcomponent.cpp
+// ============
+// hold the scale, rotation and position of a scene object together with
+// its cached world matrix
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+#include "TransformComponent.h"
+
+#include <glm/gtx/transform.hpp>
+
+/***********************************************************
+ *  TransformComponent()
+ *
+ *  The constructors for the class
+ ***********************************************************/
+TransformComponent::TransformComponent()
+    : m_scale(1.0f), m_rotationDegrees(0.0f), m_position(0.0f), m_worldMatrix(1.0f), m_dirty(false)
+{
+}
+
+TransformComponent::TransformComponent(glm::vec3 scaleXYZ, glm::vec3 rotationDegrees, glm::vec3 positionXYZ)
+    : m_scale(scaleXYZ), m_rotationDegrees(rotationDegrees), m_position(positionXYZ), m_worldMatrix(1.0f), m_dirty(true)
+{
+}
+
+/***********************************************************
+ *  SetScale()
+ *
+ *  This method is used for changing the scale of the object.
+ ***********************************************************/
+void TransformComponent::SetScale(glm::vec3 scaleXYZ)
+{
+    m_scale = scaleXYZ;
+    m_dirty = true;
+}
+
+/***********************************************************
+ *  SetRotation()
+ *
+ *  This method is used for changing the rotation, in degrees
+ *  around the X, Y and Z axes, of the object.
+ ***********************************************************/
+void TransformComponent::SetRotation(glm::vec3 rotationDegrees)
+{
+    m_rotationDegrees = rotationDegrees;
+    m_dirty = true;
+}
+
+/***********************************************************
+ *  SetPosition()
+ *
+ *  This method is used for changing the position of the object.
+ ***********************************************************/
+void TransformComponent::SetPosition(glm::vec3 positionXYZ)
+{
+    m_position = positionXYZ;
+    m_dirty = true;
+}
+
+/***********************************************************
+ *  GetWorldMatrix()
+ *
+ *  This method returns the world matrix of the object.  It is
+ *  only rebuilt when one of the transform values changed, so
+ *  objects that never move build it once.
+ ***********************************************************/
+const glm::mat4& TransformComponent::GetWorldMatrix()
+{
+    if (m_dirty)
+    {
+        m_worldMatrix = glm::translate(glm::mat4(1.0f), m_position) *
+            glm::rotate(glm::mat4(1.0f), glm::radians(m_rotationDegrees.x), glm::vec3(1.0f, 0.0f, 0.0f)) *
+            glm::rotate(glm::mat4(1.0f), glm::radians(m_rotationDegrees.y), glm::vec3(0.0f, 1.0f, 0.0f)) *
+            glm::rotate(glm::mat4(1.0f), glm::radians(m_rotationDegrees.z), glm::vec3(0.0f, 0.0f, 1.0f)) *
+            glm::scale(glm::mat4(1.0f), m_scale);
+        m_dirty = false;
+    }
+
+    return m_worldMatrix;
+}
@@ -0,0 +1,45 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformcomponent.h
+// ============
+// hold the scale, rotation and position of a scene object together with
+// its cached world matrix
+//
+//  AUTHOR: Janncy Mota - SNHU Student / Computer Science
+//  Created for CS-330-Computational Graphics and Visualization, June. 8th, 2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+class TransformComponent
+{
+public:
+    // constructors
+    TransformComponent();
+    TransformComponent(glm::vec3 scaleXYZ, glm::vec3 rotationDegrees, glm::vec3 positionXYZ);
+
+    // change one part of the transform and mark the matrix dirty
+    void SetScale(glm::vec3 scaleXYZ);
+    void SetRotation(glm::vec3 rotationDegrees);
+    void SetPosition(glm::vec3 positionXYZ);
+
+    glm::vec3 GetScale() const { return m_scale; }
+    glm::vec3 GetRotation() const { return m_rotationDegrees; }
+    glm::vec3 GetPosition() const { return m_position; }
+
+    // force the world matrix to be rebuilt on the next request
+    void MarkDirty() { m_dirty = true; }
+    bool IsDirty() const { return m_dirty; }
+
+    // world matrix, rebuilt only if the transform changed since
+    // the last request
+    const glm::mat4& GetWorldMatrix();
+
+private:
+    glm::vec3 m_scale;
+    glm::vec3 m_rotationDegrees;
+    glm::vec3 m_position;
+    glm::mat4 m_worldMatrix;
+    bool m_dirty;
+};
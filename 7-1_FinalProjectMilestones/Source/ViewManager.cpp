@@ -8,6 +8,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "ViewManager.h"
+#include "GLStateCache.h"
+#include "FrameProfiler.h"
+#include "RenderCounters.h"
 
 // GLM Math Header inclusions
 #include <glm/glm.hpp>
@@ -20,21 +23,13 @@ namespace
 	// Variables for window width and height
 	const int WINDOW_WIDTH = 1000;
 	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
+	// uniform names set every frame, built once
+	const std::string g_ViewName = "view";
+	const std::string g_ProjectionName = "projection";
+	const std::string g_ViewPositionName = "viewPosition";
 
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f;
-	float gLastFrame = 0.0f;
-
-	// the following variable is false when orthographic projection
-	// is off and true when it is on
-	bool bOrthographicProjection = false;
+	// most events taken out of the input queue at a time
+	const int g_InputBatchSize = 64;
 }
 
 /***********************************************************
@@ -43,10 +38,18 @@ namespace
  *  The constructor for the class
  ***********************************************************/
 ViewManager::ViewManager(ShaderManager* pShaderManager)
-	: m_pShaderManager(pShaderManager), m_Camera(Camera(glm::vec3(0.0f, 5.0f, 12.0f))), m_IsPerspective(true)
+	: m_pShaderManager(pShaderManager), m_Camera(Camera(glm::vec3(0.0f, 5.0f, 12.0f))),
+	m_PreviousCamera(m_Camera), m_RenderCamera(m_Camera), m_IsPerspective(true),
+	m_lastMouseX(WINDOW_WIDTH / 2.0f), m_lastMouseY(WINDOW_HEIGHT / 2.0f), m_firstMouse(true),
+	m_recordPath(NULL), m_replayPath(NULL), m_replayFrame(0),
+	m_uploadedVersion(0), m_hasUploaded(false)
 {
 	// initialize the member variables
 	m_pWindow = NULL;
+	for (bool& keyDown : m_keysDown)
+	{
+		keyDown = false;
+	}
 }
 
 /***********************************************************
@@ -92,8 +95,8 @@ GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
 	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Callback);
 
 	// enable blending for supporting transparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLStateCache::Get()->Enable(GL_BLEND);
+	GLStateCache::Get()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	m_pWindow = window;
 
@@ -105,25 +108,21 @@ GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
  *
  *  This method is automatically called from GLFW whenever
  *  the mouse is moved within the active GLFW display window.
+ *  The move is only queued, the camera turns in the next
+ *  simulation step.
  ***********************************************************/
 void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
 {
-	if (gFirstMouse)
-	{
-		gLastX = static_cast<float>(xMousePos);
-		gLastY = static_cast<float>(yMousePos);
-		gFirstMouse = false;
-	}
-
-	float xoffset = static_cast<float>(xMousePos) - gLastX;
-	float yoffset = gLastY - static_cast<float>(yMousePos); // reversed since y-coordinates go from bottom to top
-
-	gLastX = static_cast<float>(xMousePos);
-	gLastY = static_cast<float>(yMousePos);
-
 	ViewManager* viewManager = static_cast<ViewManager*>(glfwGetWindowUserPointer(window));
 	if (viewManager)
-		viewManager->m_Camera.ProcessMouseMovement(xoffset, yoffset);
+	{
+		INPUT_EVENT event;
+		event.type = INPUT_MOUSE_MOVE;
+		event.time = glfwGetTime();
+		event.x = xMousePos;
+		event.y = yMousePos;
+		viewManager->m_inputEvents.Push(event);
+	}
 }
 
 /***********************************************************
@@ -137,7 +136,95 @@ void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xOffset, doub
 {
 	ViewManager* viewManager = static_cast<ViewManager*>(glfwGetWindowUserPointer(window));
 	if (viewManager)
-		viewManager->m_Camera.ProcessMouseScroll(static_cast<float>(yOffset));
+	{
+		INPUT_EVENT event;
+		event.type = INPUT_MOUSE_SCROLL;
+		event.time = glfwGetTime();
+		event.x = xOffset;
+		event.y = yOffset;
+		viewManager->m_inputEvents.Push(event);
+	}
+}
+
+/***********************************************************
+ *  Key_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  a key is pressed or released within the active GLFW
+ *  display window.
+ ***********************************************************/
+void ViewManager::Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	ViewManager* viewManager = static_cast<ViewManager*>(glfwGetWindowUserPointer(window));
+	if (viewManager && action != GLFW_REPEAT)
+	{
+		INPUT_EVENT event;
+		event.type = INPUT_KEY;
+		event.time = glfwGetTime();
+		event.key = key;
+		event.action = action;
+		viewManager->m_inputEvents.Push(event);
+	}
+}
+
+/***********************************************************
+ *  HandleInputEvent()
+ *
+ *  This method is used for applying one queued input event
+ *  to the camera and the held keys.
+ ***********************************************************/
+void ViewManager::HandleInputEvent(const INPUT_EVENT& event)
+{
+	if (event.type == INPUT_MOUSE_MOVE)
+	{
+		if (m_firstMouse)
+		{
+			m_lastMouseX = static_cast<float>(event.x);
+			m_lastMouseY = static_cast<float>(event.y);
+			m_firstMouse = false;
+		}
+
+		float xoffset = static_cast<float>(event.x) - m_lastMouseX;
+		float yoffset = m_lastMouseY - static_cast<float>(event.y); // reversed since y-coordinates go from bottom to top
+
+		m_lastMouseX = static_cast<float>(event.x);
+		m_lastMouseY = static_cast<float>(event.y);
+
+		m_Camera.ProcessMouseMovement(xoffset, yoffset);
+	}
+	else if (event.type == INPUT_MOUSE_SCROLL)
+	{
+		m_Camera.ProcessMouseScroll(static_cast<float>(event.y));
+	}
+	else if (event.key >= 0 && event.key <= GLFW_KEY_LAST)
+	{
+		m_keysDown[event.key] = (event.action == GLFW_PRESS);
+	}
+}
+
+/***********************************************************
+ *  ProcessInputEvents()
+ *
+ *  This method is used for applying every input event the
+ *  callbacks queued since the last simulation step, taking
+ *  them out of the queue in batches.
+ ***********************************************************/
+void ViewManager::ProcessInputEvents()
+{
+	INPUT_EVENT events[g_InputBatchSize];
+	int count = 0;
+	do
+	{
+		count = m_inputEvents.Drain(events, g_InputBatchSize);
+		for (int i = 0; i < count; i++)
+		{
+			if (NULL != m_recordPath)
+			{
+				m_recordPath->AddEvent(events[i]);
+			}
+			HandleInputEvent(events[i]);
+		}
+	} while (count == g_InputBatchSize);
 }
 
 /***********************************************************
@@ -146,78 +233,188 @@ void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xOffset, doub
  *  This method is called to process any keyboard events
  *  that may be waiting in the event queue.
  ***********************************************************/
-void ViewManager::ProcessKeyboardEvents(GLFWwindow* window)
+void ViewManager::ProcessKeyboardEvents(GLFWwindow* window, float timeStep)
 {
 	// close the window if the escape key has been pressed
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	if (m_keysDown[GLFW_KEY_ESCAPE])
 	{
 		glfwSetWindowShouldClose(window, true);
 	}
 
 	// process camera movement
-	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-		m_Camera.ProcessKeyboard(FORWARD, gDeltaTime);
-	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-		m_Camera.ProcessKeyboard(BACKWARD, gDeltaTime);
-	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-		m_Camera.ProcessKeyboard(LEFT, gDeltaTime);
-	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-		m_Camera.ProcessKeyboard(RIGHT, gDeltaTime);
-	if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS)
-		m_Camera.ProcessKeyboard(UP, gDeltaTime);
-	if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS)
-		m_Camera.ProcessKeyboard(DOWN, gDeltaTime);
+	if (m_keysDown[GLFW_KEY_W])
+		m_Camera.ProcessKeyboard(FORWARD, timeStep);
+	if (m_keysDown[GLFW_KEY_S])
+		m_Camera.ProcessKeyboard(BACKWARD, timeStep);
+	if (m_keysDown[GLFW_KEY_A])
+		m_Camera.ProcessKeyboard(LEFT, timeStep);
+	if (m_keysDown[GLFW_KEY_D])
+		m_Camera.ProcessKeyboard(RIGHT, timeStep);
+	if (m_keysDown[GLFW_KEY_Q])
+		m_Camera.ProcessKeyboard(UP, timeStep);
+	if (m_keysDown[GLFW_KEY_E])
+		m_Camera.ProcessKeyboard(DOWN, timeStep);
 
 	// switch between perspective and orthographic projections
-	if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS)
-		bOrthographicProjection = false;
-	if (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS)
-		bOrthographicProjection = true;
+	if (m_keysDown[GLFW_KEY_P])
+		m_IsPerspective = true;
+	if (m_keysDown[GLFW_KEY_O])
+		m_IsPerspective = false;
 }
 
 /***********************************************************
- *  PrepareSceneView()
+ *  UpdateSimulation()
  *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
+ *  This method is used for advancing the camera by one fixed
+ *  simulation step, so the distance it moves does not depend
+ *  on the frame rate.  The camera before the step is kept for
+ *  placing the rendered camera between the two.  During a
+ *  replay the camera comes from the recorded path, and while
+ *  recording the step is added to the path.
  ***********************************************************/
-void ViewManager::PrepareSceneView()
+void ViewManager::UpdateSimulation(float timeStep)
 {
-	glm::mat4 view;
-	glm::mat4 projection;
+	PROFILE_SCOPE("UpdateSimulation");
 
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
+	m_PreviousCamera = m_Camera;
 
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents(m_pWindow);
+	// apply the input that arrived since the last step
+	ProcessInputEvents();
 
-	// get the current view matrix from the camera
-	view = m_Camera.GetViewMatrix();
+	// move the camera for the keys held down during the step
+	if (NULL != m_pWindow)
+	{
+		ProcessKeyboardEvents(m_pWindow, timeStep);
+	}
+
+	// a replayed step puts the recorded camera over the live one
+	if (IsReplaying())
+	{
+		const CAMERA_PATH_FRAME& frame = m_replayPath->GetFrame(m_replayFrame++);
+		m_Camera = Camera(frame.position, m_Camera.GetWorldUp(), frame.yaw, frame.pitch);
+	}
 
-	// define the current projection matrix
-	if (bOrthographicProjection)
+	if (NULL != m_recordPath)
 	{
-		float orthoSize = 10.0f;
-		projection = glm::ortho(-orthoSize, orthoSize, -orthoSize, orthoSize, 0.1f, 100.0f);
+		m_recordPath->AddFrame(m_Camera.GetPosition(), m_Camera.GetYaw(), m_Camera.GetPitch());
+	}
+}
+
+/***********************************************************
+ *  StartReplay()
+ *
+ *  This method is used for replaying a recorded camera path
+ *  from its first frame.  The camera starts on that frame, so
+ *  the first step does not blend in from the live camera.
+ ***********************************************************/
+void ViewManager::StartReplay(const CameraPath* path)
+{
+	m_replayPath = path;
+	m_replayFrame = 0;
+	if (IsReplaying())
+	{
+		const CAMERA_PATH_FRAME& frame = path->GetFrame(0);
+		m_Camera = Camera(frame.position, m_Camera.GetWorldUp(), frame.yaw, frame.pitch);
+		m_PreviousCamera = m_Camera;
+	}
+}
+
+/***********************************************************
+ *  SetCameraPose()
+ *
+ *  This method is used for placing the camera at a fixed pose,
+ *  used by the benchmarks so every run sees the same view.
+ ***********************************************************/
+void ViewManager::SetCameraPose(glm::vec3 position, float yaw, float pitch)
+{
+	m_Camera = Camera(position, m_Camera.GetWorldUp(), yaw, pitch);
+	m_PreviousCamera = m_Camera;
+}
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering.  The camera is placed between its last two
+ *  simulation steps by the passed in interpolation, so its
+ *  movement stays smooth when frames and steps do not line up.
+ *  The camera caches its matrices, so they are only rebuilt
+ *  and set into the shader when the camera or the projection
+ *  changed.
+ ***********************************************************/
+void ViewManager::PrepareSceneView(float interpolation)
+{
+	PROFILE_SCOPE("PrepareSceneView");
+
+	// blend the camera between the last two simulation steps, a
+	// camera that did not move keeps its exact pose, and with it
+	// the cached matrices
+	if (m_PreviousCamera.GetPosition() == m_Camera.GetPosition() && m_PreviousCamera.GetYaw() == m_Camera.GetYaw() &&
+		m_PreviousCamera.GetPitch() == m_Camera.GetPitch())
+	{
+		m_RenderCamera.SetPose(m_Camera.GetPosition(), m_Camera.GetYaw(), m_Camera.GetPitch());
 	}
 	else
 	{
-		projection = glm::perspective(glm::radians(m_Camera.Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
+		m_RenderCamera.SetPose(
+			glm::mix(m_PreviousCamera.GetPosition(), m_Camera.GetPosition(), interpolation),
+			glm::mix(m_PreviousCamera.GetYaw(), m_Camera.GetYaw(), interpolation),
+			glm::mix(m_PreviousCamera.GetPitch(), m_Camera.GetPitch(), interpolation));
 	}
 
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
+	// define the current projection
+	m_RenderCamera.SetZoom(m_Camera.GetZoom());
+	m_RenderCamera.SetProjection(!m_IsPerspective, (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f, 10.0f);
+
+	// if the shader manager object is valid and the matrices changed
+	// since they were last set
+	unsigned int version = m_RenderCamera.GetVersion();
+	if (NULL != m_pShaderManager && (!m_hasUploaded || version != m_uploadedVersion))
 	{
+		// the uniforms go to the bound program, which an overlay or
+		// another pass may have changed since the last frame
+		GLStateCache::Get()->UseProgram(m_pShaderManager->m_programID);
 		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
+		m_pShaderManager->setMat4Value(g_ViewName, m_RenderCamera.GetViewMatrix());
 		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
+		m_pShaderManager->setMat4Value(g_ProjectionName, m_RenderCamera.GetProjectionMatrix());
 		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", m_Camera.Position);
+		m_pShaderManager->setVec3Value(g_ViewPositionName, m_RenderCamera.GetPosition());
+		RenderCounters::Get()->Add(COUNTER_UNIFORM_UPLOADS, 3);
+		m_uploadedVersion = version;
+		m_hasUploaded = true;
 	}
 }
+
+/***********************************************************
+ *  GetPixelsPerUnit()
+ *
+ *  This method returns how many pixels one world unit covers
+ *  at a distance of one from the camera with the current
+ *  perspective projection.
+ ***********************************************************/
+float ViewManager::GetPixelsPerUnit() const
+{
+	return WINDOW_HEIGHT / (2.0f * tan(glm::radians(m_Camera.GetZoom()) * 0.5f));
+}
+
+/***********************************************************
+ *  GetWindowWidth()
+ *
+ *  This method returns the width of the display window.
+ ***********************************************************/
+int ViewManager::GetWindowWidth() const
+{
+	return WINDOW_WIDTH;
+}
+
+/***********************************************************
+ *  GetWindowHeight()
+ *
+ *  This method returns the height of the display window.
+ ***********************************************************/
+int ViewManager::GetWindowHeight() const
+{
+	return WINDOW_HEIGHT;
+}
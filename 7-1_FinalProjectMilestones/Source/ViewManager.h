@@ -13,6 +13,8 @@
 #define VIEWMANAGER_H
 
 #include "ShaderManager.h"
+#include "InputEventQueue.h"
+#include "CameraPath.h"
 #include "GLFW/glfw3.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -34,24 +36,20 @@ const float SPEED = 2.5f;
 const float SENSITIVITY = 0.1f;
 const float ZOOM = 45.0f;
 
+// number of planes bounding the view frustum
+const int FRUSTUM_PLANE_COUNT = 6;
+
 class Camera
 {
 public:
-    glm::vec3 Position;
-    glm::vec3 Front;
-    glm::vec3 Up;
-    glm::vec3 Right;
-    glm::vec3 WorldUp;
-
-    float Yaw;
-    float Pitch;
-
+    // these do not reach the cached matrices, so they can be set freely
     float MovementSpeed;
     float MouseSensitivity;
-    float Zoom;
 
     Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), float yaw = YAW, float pitch = PITCH)
-        : Front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(SENSITIVITY), Zoom(ZOOM)
+        : MovementSpeed(SPEED), MouseSensitivity(SENSITIVITY), Front(glm::vec3(0.0f, 0.0f, -1.0f)), Zoom(ZOOM),
+        m_orthographic(false), m_aspectRatio(1.0f), m_nearPlane(0.1f), m_farPlane(100.0f), m_orthoSize(10.0f),
+        m_viewDirty(true), m_projectionDirty(true), m_version(0)
     {
         Position = position;
         WorldUp = up;
@@ -60,9 +58,83 @@ public:
         updateCameraVectors();
     }
 
-    glm::mat4 GetViewMatrix()
+    // place the camera, the cached matrices are kept when nothing changed
+    void SetPose(glm::vec3 position, float yaw, float pitch)
     {
-        return glm::lookAt(Position, Position + Front, Up);
+        if (position == Position && yaw == Yaw && pitch == Pitch)
+            return;
+
+        Position = position;
+        Yaw = yaw;
+        Pitch = pitch;
+        updateCameraVectors();
+    }
+
+    // set how the view is projected, the cached matrices are kept when
+    // nothing changed
+    void SetProjection(bool orthographic, float aspectRatio, float nearPlane, float farPlane, float orthoSize)
+    {
+        if (orthographic == m_orthographic && aspectRatio == m_aspectRatio && nearPlane == m_nearPlane &&
+            farPlane == m_farPlane && orthoSize == m_orthoSize)
+            return;
+
+        m_orthographic = orthographic;
+        m_aspectRatio = aspectRatio;
+        m_nearPlane = nearPlane;
+        m_farPlane = farPlane;
+        m_orthoSize = orthoSize;
+        m_projectionDirty = true;
+    }
+
+    void SetZoom(float zoom)
+    {
+        if (zoom != Zoom)
+        {
+            Zoom = zoom;
+            m_projectionDirty = true;
+        }
+    }
+
+    const glm::vec3& GetPosition() const { return Position; }
+    const glm::vec3& GetFront() const { return Front; }
+    const glm::vec3& GetWorldUp() const { return WorldUp; }
+    float GetYaw() const { return Yaw; }
+    float GetPitch() const { return Pitch; }
+    float GetZoom() const { return Zoom; }
+
+    const glm::mat4& GetViewMatrix() const
+    {
+        updateMatrices();
+        return m_view;
+    }
+
+    const glm::mat4& GetProjectionMatrix() const
+    {
+        updateMatrices();
+        return m_projection;
+    }
+
+    const glm::mat4& GetViewProjectionMatrix() const
+    {
+        updateMatrices();
+        return m_viewProjection;
+    }
+
+    // planes bounding the view in world space, inside where
+    // dot(plane.xyz, point) + plane.w >= 0, in the order left, right,
+    // bottom, top, near, far
+    const glm::vec4* GetFrustumPlanes() const
+    {
+        updateMatrices();
+        return m_frustumPlanes;
+    }
+
+    // changes every time the cached matrices are rebuilt, so users of
+    // the matrices can tell whether theirs are still current
+    unsigned int GetVersion() const
+    {
+        updateMatrices();
+        return m_version;
     }
 
     void ProcessKeyboard(Camera_Movement direction, float deltaTime)
@@ -81,7 +153,7 @@ public:
         if (direction == DOWN)
             Position -= Up * velocity;
 
-
+        m_viewDirty = true;
     }
 
     void ProcessMouseMovement(float xoffset, float yoffset, GLboolean constrainPitch = true)
@@ -110,6 +182,18 @@ public:
     }
 
 private:
+    // only changed through the methods above, which mark the cached
+    // matrices out of date
+    glm::vec3 Position;
+    glm::vec3 Front;
+    glm::vec3 Up;
+    glm::vec3 Right;
+    glm::vec3 WorldUp;
+
+    float Yaw;
+    float Pitch;
+    float Zoom;
+
     void updateCameraVectors()
     {
         glm::vec3 front;
@@ -119,7 +203,57 @@ private:
         Front = glm::normalize(front);
         Right = glm::normalize(glm::cross(Front, WorldUp));
         Up = glm::normalize(glm::cross(Right, Front));
+        m_viewDirty = true;
+    }
+
+    // rebuild the matrices and planes that are out of date
+    void updateMatrices() const
+    {
+        if (!m_viewDirty && !m_projectionDirty)
+            return;
+
+        if (m_viewDirty)
+            m_view = glm::lookAt(Position, Position + Front, Up);
+        if (m_projectionDirty)
+        {
+            if (m_orthographic)
+                m_projection = glm::ortho(-m_orthoSize, m_orthoSize, -m_orthoSize, m_orthoSize, m_nearPlane, m_farPlane);
+            else
+                m_projection = glm::perspective(glm::radians(Zoom), m_aspectRatio, m_nearPlane, m_farPlane);
+        }
+        m_viewProjection = m_projection * m_view;
+
+        // each plane is the last row of the matrix plus or minus one
+        // of the others
+        for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++)
+        {
+            int row = i / 2;
+            float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+            glm::vec4 plane;
+            for (int column = 0; column < 4; column++)
+                plane[column] = m_viewProjection[column][3] + sign * m_viewProjection[column][row];
+            m_frustumPlanes[i] = plane / glm::length(glm::vec3(plane));
+        }
+
+        m_viewDirty = false;
+        m_projectionDirty = false;
+        m_version++;
     }
+
+    bool m_orthographic;
+    float m_aspectRatio;
+    float m_nearPlane;
+    float m_farPlane;
+    float m_orthoSize; // half the height of the orthographic view
+
+    // matrices and planes cached until the camera or projection changes
+    mutable glm::mat4 m_view;
+    mutable glm::mat4 m_projection;
+    mutable glm::mat4 m_viewProjection;
+    mutable glm::vec4 m_frustumPlanes[FRUSTUM_PLANE_COUNT];
+    mutable bool m_viewDirty;
+    mutable bool m_projectionDirty;
+    mutable unsigned int m_version;
 };
 
 class ViewManager
@@ -134,25 +268,90 @@ public:
     static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
     // mouse scroll callback for adjusting the movement speed
     static void Mouse_Scroll_Callback(GLFWwindow* window, double xOffset, double yOffset);
+    // key callback for moving the camera and switching projections
+    static void Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
-    // process keyboard events for interaction with the 3D scene
-    void ProcessKeyboardEvents(GLFWwindow* window);
+    // process keyboard events for interaction with the 3D scene,
+    // moving the camera for the passed in length of time
+    void ProcessKeyboardEvents(GLFWwindow* window, float timeStep);
+
+    // apply the waiting input events and advance the camera by one
+    // fixed simulation step
+    void UpdateSimulation(float timeStep);
 
     // create the initial OpenGL display window
     GLFWwindow* CreateDisplayWindow(const char* windowTitle);
 
-    // prepare the conversion from 3D object display to 2D scene display
-    void PrepareSceneView();
+    // add the camera of every following simulation step, and the input
+    // applied in it, to the passed in path, NULL stops recording
+    void SetRecordingPath(CameraPath* path) { m_recordPath = path; }
+    // take the camera of every following simulation step from the
+    // passed in path instead of the input, NULL stops the replay
+    void StartReplay(const CameraPath* path);
+    // true while the replay has frames left
+    bool IsReplaying() const { return m_replayPath != NULL && m_replayFrame < m_replayPath->GetFrameCount(); }
+    // path frame the next simulation step replays
+    int GetReplayFrame() const { return m_replayFrame; }
+
+    // place the camera at a fixed pose, with no movement to blend
+    void SetCameraPose(glm::vec3 position, float yaw, float pitch);
+
+    // prepare the conversion from 3D object display to 2D scene display,
+    // placing the camera between its last two simulation steps
+    void PrepareSceneView(float interpolation = 1.0f);
+
+    // matrices set into the shader by the last PrepareSceneView()
+    const glm::mat4& GetViewMatrix() const { return m_RenderCamera.GetViewMatrix(); }
+    const glm::mat4& GetProjectionMatrix() const { return m_RenderCamera.GetProjectionMatrix(); }
+    const glm::mat4& GetViewProjectionMatrix() const { return m_RenderCamera.GetViewProjectionMatrix(); }
+    // world space planes of the view frustum, FRUSTUM_PLANE_COUNT of them
+    const glm::vec4* GetFrustumPlanes() const { return m_RenderCamera.GetFrustumPlanes(); }
+
+    // world position of the camera for the frame being rendered
+    glm::vec3 GetCameraPosition() const { return m_RenderCamera.GetPosition(); }
+    // pixels covered by one world unit at a distance of one, used
+    // for estimating the projected size of objects
+    float GetPixelsPerUnit() const;
+    // size of the display window, and of the frames drawn without one
+    int GetWindowWidth() const;
+    int GetWindowHeight() const;
 
 private:
+    // apply the input events pushed by the callbacks since the last step
+    void ProcessInputEvents();
+    void HandleInputEvent(const INPUT_EVENT& event);
+
     // pointer to shader manager object
     ShaderManager* m_pShaderManager;
     // active OpenGL display window
     GLFWwindow* m_pWindow;
 
+    // camera after the last simulation step, and after the one
+    // before it, the rendered camera is placed between the two
     Camera m_Camera;
+    Camera m_PreviousCamera;
+    Camera m_RenderCamera;
 
     bool m_IsPerspective;
+
+    // events pushed by the window callbacks, applied by the update stage
+    InputEventQueue m_inputEvents;
+    // last cursor position, for turning cursor moves into offsets
+    float m_lastMouseX;
+    float m_lastMouseY;
+    bool m_firstMouse;
+    // keys held down, as told by the key events
+    bool m_keysDown[GLFW_KEY_LAST + 1];
+
+    // camera path being recorded or replayed, NULL when there is none
+    CameraPath* m_recordPath;
+    const CameraPath* m_replayPath;
+    int m_replayFrame;
+
+    // camera version whose matrices are in the shader, so unchanged
+    // matrices are not set again
+    unsigned int m_uploadedVersion;
+    bool m_hasUploaded;
 };
 
 #endif // VIEWMANAGER_H
@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////////////////////
+// deferredLightingFragmentShader.glsl
+// ============
+// light every screen pixel once from the G-buffer with the Phong
+// lighting model, evaluating only the lights listed for the pixel's
+// cluster - the lighting must match fragmentShader.glsl
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+// must match SHADOW_CASCADE_COUNT in CascadedShadowMaps.h
+#define SHADOW_CASCADE_COUNT 3
+
+out vec4 outFragmentColor;
+
+struct Material
+{
+	vec3 ambientColor;
+	vec3 diffuseColor;
+	vec3 specularColor;
+	float shininess;
+};
+
+// must match GPU_LIGHT in ClusteredLighting.h
+struct LightSource
+{
+	vec4 positionRadius;
+	vec4 ambientFocalStrength;
+	vec4 diffuseSpecularIntensity;
+	vec4 specularColor;
+};
+
+// the global lights come first, followed by the lights with a radius
+layout (std430, binding = 1) readonly buffer LightBuffer
+{
+	LightSource lightSources[];
+};
+
+// offset and count into lightIndices for every cluster
+layout (std430, binding = 2) readonly buffer ClusterBuffer
+{
+	uvec2 clusterRanges[];
+};
+
+layout (std430, binding = 3) readonly buffer LightIndexBuffer
+{
+	uint lightIndices[];
+};
+
+uniform sampler2D gBufferAlbedo;
+uniform sampler2D gBufferNormal;
+uniform sampler2D gBufferDepth;
+
+// rebuilds world positions from the stored depth
+uniform mat4 inverseViewProjection;
+
+uniform vec3 viewPosition;
+uniform Material material;
+
+// values from ClusteredLighting for finding the cluster of a pixel
+uniform mat4 view;
+uniform ivec3 clusterCounts;
+uniform vec2 clusterDepthParams; // slice = log(depth) * x + y
+uniform vec2 viewportSize;
+uniform int globalLightCount;
+
+// values from CascadedShadowMaps, shadowLightIndex is -1 without shadows
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowMatrices[SHADOW_CASCADE_COUNT];
+uniform float cascadeSplits[SHADOW_CASCADE_COUNT]; // far view depth of every cascade
+uniform float cascadeTexelSizes[SHADOW_CASCADE_COUNT];
+uniform int shadowLightIndex = -1;
+
+// values from LightmapBaker, the direct diffuse of lightmapLightIndex is
+// kept out of the baked colors so it can be shadowed here
+uniform sampler2D lightmap;
+uniform vec4 lightmapBounds; // world XZ minimum, one over the XZ size
+uniform int lightmapLightIndex = -1;
+
+// turn the two stored values back into a unit normal
+vec3 DecodeNormal(vec2 encoded)
+{
+	encoded = encoded * 2.0f - 1.0f;
+	vec3 normal = vec3(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float fold = clamp(-normal.z, 0.0f, 1.0f);
+	normal.x += (normal.x >= 0.0f) ? -fold : fold;
+	normal.y += (normal.y >= 0.0f) ? -fold : fold;
+	return normalize(normal);
+}
+
+vec3 CalculateLightSource(LightSource lightSource, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection, float specularMask, float shadow)
+{
+	vec3 lightOffset = lightSource.positionRadius.xyz - vertexPosition;
+
+	// lights with a radius fade out smoothly to nothing at the radius
+	float attenuation = 1.0f;
+	float radius = lightSource.positionRadius.w;
+	if (radius > 0.0f)
+	{
+		float distanceSquared = dot(lightOffset, lightOffset);
+		float falloff = clamp(1.0f - pow(distanceSquared / (radius * radius), 2.0f), 0.0f, 1.0f);
+		attenuation = falloff * falloff / (1.0f + distanceSquared);
+	}
+
+	// ambient lighting
+	vec3 ambient = lightSource.ambientFocalStrength.rgb;
+
+	// diffuse lighting
+	vec3 lightDirection = normalize(lightOffset);
+	float impact = max(dot(lightNormal, lightDirection), 0.0f);
+	vec3 diffuse = impact * lightSource.diffuseSpecularIntensity.rgb * material.diffuseColor;
+
+	// specular lighting
+	vec3 reflectDirection = reflect(-lightDirection, lightNormal);
+	float specularComponent = pow(max(dot(viewDirection, reflectDirection), 0.0f), lightSource.ambientFocalStrength.w);
+	vec3 specular = specularMask * lightSource.diffuseSpecularIntensity.w * specularComponent * lightSource.specularColor.rgb * material.specularColor;
+
+	// shadows only block the direct light
+	return attenuation * (ambient + shadow * (diffuse + specular));
+}
+
+// fraction of the shadowed light that reaches a position, filtered
+// over 3x3 texels of the nearest cascade that covers it
+float CalculateShadow(vec3 worldPosition, vec3 normal, float viewDepth)
+{
+	int cascade = 0;
+	while (cascade < SHADOW_CASCADE_COUNT && viewDepth > cascadeSplits[cascade])
+		cascade++;
+	if (cascade == SHADOW_CASCADE_COUNT)
+		return 1.0f;
+
+	// pushing the lookup out along the normal keeps surfaces from
+	// shadowing themselves
+	vec3 offsetPosition = worldPosition + normal * cascadeTexelSizes[cascade] * 1.5f;
+	vec4 shadowPosition = shadowMatrices[cascade] * vec4(offsetPosition, 1.0f);
+	vec2 texelSize = 1.0f / vec2(textureSize(shadowMap, 0).xy);
+
+	float visibility = 0.0f;
+	for (int y = -1; y <= 1; y++)
+	{
+		for (int x = -1; x <= 1; x++)
+		{
+			vec2 uv = shadowPosition.xy + vec2(x, y) * texelSize;
+			visibility += texture(shadowMap, vec4(uv, float(cascade), shadowPosition.z));
+		}
+	}
+	return visibility / 9.0f;
+}
+
+// lighting of a static surface read from the lightmap
+vec3 CalculateBakedLighting(vec3 worldPosition, vec3 normal, float viewDepth)
+{
+	vec4 baked = texture(lightmap, (worldPosition.xz - lightmapBounds.xy) * lightmapBounds.zw);
+	vec3 result = baked.rgb;
+	if (lightmapLightIndex >= 0)
+	{
+		float shadow = (lightmapLightIndex == shadowLightIndex) ? CalculateShadow(worldPosition, normal, viewDepth) : 1.0f;
+		result += baked.a * shadow * lightSources[lightmapLightIndex].diffuseSpecularIntensity.rgb * material.diffuseColor;
+	}
+	return result;
+}
+
+// index of the cluster at a view depth on this pixel
+uint FindCluster(float viewDepth)
+{
+	int slice = clamp(int(log(viewDepth) * clusterDepthParams.x + clusterDepthParams.y), 0, clusterCounts.z - 1);
+	ivec2 tile = clamp(ivec2(gl_FragCoord.xy / viewportSize * vec2(clusterCounts.xy)), ivec2(0), clusterCounts.xy - 1);
+	return uint((slice * clusterCounts.y + tile.y) * clusterCounts.x + tile.x);
+}
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(gBufferDepth, pixel, 0).r;
+
+	// nothing was drawn here, keep the cleared background
+	if (depth >= 1.0f)
+		discard;
+
+	vec4 albedo = texelFetch(gBufferAlbedo, pixel, 0);
+	vec4 normalData = texelFetch(gBufferNormal, pixel, 0);
+
+	if (normalData.a < 0.5f)
+	{
+		outFragmentColor = vec4(albedo.rgb, 1.0f);
+		return;
+	}
+
+	vec4 clipPosition = vec4(gl_FragCoord.xy / viewportSize * 2.0f - 1.0f, depth * 2.0f - 1.0f, 1.0f);
+	vec4 worldPosition = inverseViewProjection * clipPosition;
+	vec3 fragmentPosition = worldPosition.xyz / worldPosition.w;
+
+	vec3 lightNormal = DecodeNormal(normalData.rg);
+	vec3 viewDirection = normalize(viewPosition - fragmentPosition);
+	float viewDepth = max(-(view * vec4(fragmentPosition, 1.0f)).z, 0.0001f);
+
+	// static surfaces were lit ahead of time
+	if (normalData.a < 0.9f)
+	{
+		outFragmentColor = vec4(CalculateBakedLighting(fragmentPosition, lightNormal, viewDepth) * albedo.rgb, 1.0f);
+		return;
+	}
+
+	vec3 phongResult = vec3(0.0f);
+
+	for (int i = 0; i < globalLightCount; i++)
+	{
+		float shadow = (i == shadowLightIndex) ? CalculateShadow(fragmentPosition, lightNormal, viewDepth) : 1.0f;
+		phongResult += CalculateLightSource(lightSources[i], lightNormal, fragmentPosition, viewDirection, albedo.a, shadow);
+	}
+
+	uvec2 clusterRange = clusterRanges[FindCluster(viewDepth)];
+	for (uint i = 0u; i < clusterRange.y; i++)
+	{
+		uint lightIndex = lightIndices[clusterRange.x + i];
+		phongResult += CalculateLightSource(lightSources[lightIndex], lightNormal, fragmentPosition, viewDirection, albedo.a, 1.0f);
+	}
+
+	outFragmentColor = vec4(phongResult * albedo.rgb, 1.0f);
+}
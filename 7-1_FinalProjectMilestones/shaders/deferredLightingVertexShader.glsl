@@ -0,0 +1,13 @@
+///////////////////////////////////////////////////////////////////////////////
+// deferredLightingVertexShader.glsl
+// ============
+// cover the screen with one triangle for the deferred lighting pass
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+void main()
+{
+	// the triangle reaches past the screen corners, so no vertex data is needed
+	const vec2 positions[3] = vec2[](vec2(-1.0f, -1.0f), vec2(3.0f, -1.0f), vec2(-1.0f, 3.0f));
+	gl_Position = vec4(positions[gl_VertexID], 0.0f, 1.0f);
+}
@@ -0,0 +1,10 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthFragmentShader.glsl
+// ============
+// the depth pre-pass only writes depth, so there is nothing to shade
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+void main()
+{
+}
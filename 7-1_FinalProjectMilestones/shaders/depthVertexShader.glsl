@@ -0,0 +1,45 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthVertexShader.glsl
+// ============
+// transform the scene vertices for the depth pre-pass, the position
+// must be computed exactly like vertexShader.glsl
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+layout (location = 0) in vec3 inVertexPosition;
+
+invariant gl_Position;
+
+// must match PER_DRAW_DATA in PerDrawBuffer.h
+struct PerDrawData
+{
+	mat4 model;
+	vec4 color;
+	vec2 uvScale;
+	int useTexture;
+	int textureSlot;
+	int useLightmap;
+	int lightCount;
+	int lightIndices[8]; // MAX_DRAW_LIGHTS
+};
+
+layout (std430, binding = 0) readonly buffer PerDrawBuffer
+{
+	PerDrawData perDraw[];
+};
+
+// index into the per-draw data, -1 uses the model uniform instead
+uniform int drawID = -1;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+	mat4 modelMatrix = (drawID >= 0) ? perDraw[drawID].model : model;
+
+	vec4 worldPosition = modelMatrix * vec4(inVertexPosition, 1.0f);
+
+	gl_Position = projection * view * worldPosition;
+}
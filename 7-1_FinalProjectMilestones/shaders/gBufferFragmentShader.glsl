@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+// gBufferFragmentShader.glsl
+// ============
+// write the surface values of the scene fragments into the G-buffer for
+// the deferred lighting pass, the base color is found the same way as in
+// fragmentShader.glsl
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+in vec2 fragmentTextureCoordinate;
+
+// albedo in rgb, specular mask in a
+layout (location = 0) out vec4 outAlbedo;
+// octahedral normal in rg, unused b, lighting mode in a - 0 unlit,
+// 2/3 lit from the lightmap, 1 lit
+layout (location = 1) out vec4 outNormal;
+
+#define TOTAL_TEXTURES 16
+
+// must match PER_DRAW_DATA in PerDrawBuffer.h
+struct PerDrawData
+{
+	mat4 model;
+	vec4 color;
+	vec2 uvScale;
+	int useTexture;
+	int textureSlot;
+	int useLightmap;
+	int lightCount;
+	int lightIndices[8]; // MAX_DRAW_LIGHTS
+};
+
+layout (std430, binding = 0) readonly buffer PerDrawBuffer
+{
+	PerDrawData perDraw[];
+};
+
+// index into the per-draw data, -1 uses the uniforms below instead
+uniform int drawID = -1;
+
+uniform bool bUseTexture = false;
+uniform bool bUseLighting = false;
+uniform bool bUseLightmap = false;
+uniform vec4 objectColor = vec4(1.0f);
+uniform vec2 UVscale = vec2(1.0f, 1.0f);
+uniform sampler2D objectTexture;
+
+// every loaded texture stays bound to its own slot
+uniform sampler2D objectTextures[TOTAL_TEXTURES];
+
+// fold the lower half of the octahedron over the upper half
+vec2 OctahedronWrap(vec2 v)
+{
+	return (1.0f - abs(v.yx)) * vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+}
+
+// map a unit normal to two values in [0, 1]
+vec2 EncodeNormal(vec3 normal)
+{
+	normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+	vec2 encoded = (normal.z >= 0.0f) ? normal.xy : OctahedronWrap(normal.xy);
+	return encoded * 0.5f + 0.5f;
+}
+
+void main()
+{
+	vec4 baseColor;
+
+	if (drawID >= 0)
+	{
+		// drawID is a uniform so the texture index is dynamically uniform
+		if (perDraw[drawID].useTexture != 0)
+		{
+			vec2 uv = fragmentTextureCoordinate * perDraw[drawID].uvScale;
+			baseColor = vec4(texture(objectTextures[perDraw[drawID].textureSlot], uv).rgb, 1.0f);
+		}
+		else
+		{
+			baseColor = perDraw[drawID].color;
+		}
+	}
+	else
+	{
+		if (bUseTexture)
+			baseColor = vec4(texture(objectTexture, fragmentTextureCoordinate * UVscale).rgb, 1.0f);
+		else
+			baseColor = objectColor;
+	}
+
+	// every object uses the scene material, so the full specular
+	// response is kept for all of them
+	outAlbedo = vec4(baseColor.rgb, 1.0f);
+	bool useLightmap = (drawID >= 0) ? (perDraw[drawID].useLightmap != 0) : bUseLightmap;
+	float lightingMode = bUseLighting ? (useLightmap ? 2.0f / 3.0f : 1.0f) : 0.0f;
+	outNormal = vec4(EncodeNormal(normalize(fragmentVertexNormal)), 0.0f, lightingMode);
+}
@@ -0,0 +1,21 @@
+///////////////////////////////////////////////////////////////////////////////
+// overlayFragmentShader.glsl
+// ============
+// draw the glyphs and the backing of the stats overlay
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+in vec2 fragmentTexCoord;
+in vec4 fragmentColor;
+
+uniform sampler2D glyphTexture;
+
+out vec4 outputColor;
+
+void main()
+{
+	// the font is one bit per texel, anything off is left to the scene
+	if (texture(glyphTexture, fragmentTexCoord).r < 0.5f)
+		discard;
+	outputColor = fragmentColor;
+}
@@ -0,0 +1,23 @@
+///////////////////////////////////////////////////////////////////////////////
+// overlayVertexShader.glsl
+// ============
+// place the quads of the stats overlay, given in pixels from the top left
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec4 color;
+
+uniform vec2 screenSize;
+
+out vec2 fragmentTexCoord;
+out vec4 fragmentColor;
+
+void main()
+{
+	vec2 clipPosition = position / screenSize * vec2(2.0f, -2.0f) + vec2(-1.0f, 1.0f);
+	gl_Position = vec4(clipPosition, 0.0f, 1.0f);
+	fragmentTexCoord = texCoord;
+	fragmentColor = color;
+}
@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////
+// vertexShader.glsl
+// ============
+// transform the scene vertices, reading the per-draw data from the
+// ring buffer when a draw ID is set
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+
+// the depth pre-pass computes gl_Position with the same expression, so
+// the shading pass can test against its depth values with GL_EQUAL
+invariant gl_Position;
+
+// must match PER_DRAW_DATA in PerDrawBuffer.h
+struct PerDrawData
+{
+	mat4 model;
+	vec4 color;
+	vec2 uvScale;
+	int useTexture;
+	int textureSlot;
+	int useLightmap;
+	int lightCount;
+	int lightIndices[8]; // MAX_DRAW_LIGHTS
+};
+
+layout (std430, binding = 0) readonly buffer PerDrawBuffer
+{
+	PerDrawData perDraw[];
+};
+
+// index into the per-draw data, -1 uses the model uniform instead
+uniform int drawID = -1;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+	mat4 modelMatrix = (drawID >= 0) ? perDraw[drawID].model : model;
+
+	vec4 worldPosition = modelMatrix * vec4(inVertexPosition, 1.0f);
+
+	gl_Position = projection * view * worldPosition;
+
+	fragmentPosition = vec3(worldPosition);
+	fragmentVertexNormal = mat3(transpose(inverse(modelMatrix))) * inVertexNormal;
+	fragmentTextureCoordinate = inTextureCoordinate;
+}